@@ -36,6 +36,7 @@
  */
 
 #include "driver_ssd1306_advance.h"
+#include "driver_ssd1306_basic.h"
 
 static ssd1306_handle_t gs_handle;        /**< ssd1306 handle */
 
@@ -51,12 +52,17 @@ static ssd1306_handle_t gs_handle;        /**< ssd1306 handle */
 uint8_t ssd1306_advance_init(ssd1306_interface_t interface, ssd1306_address_t addr)
 {
     uint8_t res;
+    uint16_t len;
+    const uint8_t *table;
     
     /* link functions */
     DRIVER_SSD1306_LINK_INIT(&gs_handle, ssd1306_handle_t);
     DRIVER_SSD1306_LINK_IIC_INIT(&gs_handle, ssd1306_interface_iic_init);
     DRIVER_SSD1306_LINK_IIC_DEINIT(&gs_handle, ssd1306_interface_iic_deinit);
     DRIVER_SSD1306_LINK_IIC_WRITE(&gs_handle, ssd1306_interface_iic_write);
+    DRIVER_SSD1306_LINK_IIC_WRITE_COMMAND(&gs_handle, ssd1306_interface_iic_write_cmd);
+    DRIVER_SSD1306_LINK_TRANSFER_BEGIN(&gs_handle, ssd1306_interface_transfer_begin);
+    DRIVER_SSD1306_LINK_TRANSFER_END(&gs_handle, ssd1306_interface_transfer_end);
     DRIVER_SSD1306_LINK_SPI_INIT(&gs_handle, ssd1306_interface_spi_init);
     DRIVER_SSD1306_LINK_SPI_DEINIT(&gs_handle, ssd1306_interface_spi_deinit);
     DRIVER_SSD1306_LINK_SPI_WRITE_COMMAND(&gs_handle, ssd1306_interface_spi_write_cmd);
@@ -96,241 +102,12 @@ uint8_t ssd1306_advance_init(ssd1306_interface_t interface, ssd1306_address_t ad
         return 1;
     }
     
-    /* close display */
-    res = ssd1306_set_display(&gs_handle, SSD1306_DISPLAY_OFF);
-    if (res != 0)
-    {
-        ssd1306_interface_debug_print("ssd1306: set display failed.\n");
-        (void)ssd1306_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set column address range */
-    res = ssd1306_set_column_address_range(&gs_handle, SSD1306_ADVANCE_DEFAULT_COLUMN_ADDRESS_RANGE_START, SSD1306_ADVANCE_DEFAULT_COLUMN_ADDRESS_RANGE_END);
-    if (res != 0)
-    {
-        ssd1306_interface_debug_print("ssd1306: set column address range failed.\n");
-        (void)ssd1306_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set page address range */
-    res = ssd1306_set_page_address_range(&gs_handle, SSD1306_ADVANCE_DEFAULT_PAGE_ADDRESS_RANGE_START, SSD1306_ADVANCE_DEFAULT_PAGE_ADDRESS_RANGE_END);
-    if (res != 0)
-    {
-        ssd1306_interface_debug_print("ssd1306: set page address range failed.\n");
-        (void)ssd1306_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set low column start address */
-    res = ssd1306_set_low_column_start_address(&gs_handle, SSD1306_ADVANCE_DEFAULT_LOW_COLUMN_START_ADDRESS);
-    if (res != 0)
-    {
-        ssd1306_interface_debug_print("ssd1306: set low column start address failed.\n");
-        (void)ssd1306_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set high column start address */
-    res = ssd1306_set_high_column_start_address(&gs_handle, SSD1306_ADVANCE_DEFAULT_HIGH_COLUMN_START_ADDRESS);
-    if (res != 0)
-    {
-        ssd1306_interface_debug_print("ssd1306: set high column start address failed.\n");
-        (void)ssd1306_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set display start line */
-    res = ssd1306_set_display_start_line(&gs_handle, SSD1306_ADVANCE_DEFAULT_DISPLAY_START_LINE);
-    if (res != 0)
-    {
-        ssd1306_interface_debug_print("ssd1306: set display start line failed.\n");
-        (void)ssd1306_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set fade blinking mode */
-    res = ssd1306_set_fade_blinking_mode(&gs_handle, SSD1306_ADVANCE_DEFAULT_FADE_BLINKING_MODE, SSD1306_ADVANCE_DEFAULT_FADE_FRAMES);
-    if (res != 0)
-    {
-        ssd1306_interface_debug_print("ssd1306: set fade blinking failed.\n");
-        (void)ssd1306_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* deactivate scroll */
-    res = ssd1306_deactivate_scroll(&gs_handle);
-    if (res != 0)
-    {
-        ssd1306_interface_debug_print("ssd1306: set deactivate scroll failed.\n");
-        (void)ssd1306_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set zoom in */
-    res = ssd1306_set_zoom_in(&gs_handle, SSD1306_ADVANCE_DEFAULT_ZOOM_IN);
-    if (res != 0)
-    {
-        ssd1306_interface_debug_print("ssd1306: set set zoom in failed.\n");
-        (void)ssd1306_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set contrast */
-    res = ssd1306_set_contrast(&gs_handle, SSD1306_ADVANCE_DEFAULT_CONTRAST);
-    if (res != 0)
-    {
-        ssd1306_interface_debug_print("ssd1306: set contrast failed.\n");
-        (void)ssd1306_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set segment remap */
-    res = ssd1306_set_segment_remap(&gs_handle, SSD1306_ADVANCE_DEFAULT_SEGMENT);
-    if (res != 0)
-    {
-        ssd1306_interface_debug_print("ssd1306: set segment remap failed.\n");
-        (void)ssd1306_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set scan direction */
-    res = ssd1306_set_scan_direction(&gs_handle, SSD1306_ADVANCE_DEFAULT_SCAN_DIRECTION);
-    if (res != 0)
-    {
-        ssd1306_interface_debug_print("ssd1306: set scan direction failed.\n");
-        (void)ssd1306_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set display mode */
-    res = ssd1306_set_display_mode(&gs_handle, SSD1306_ADVANCE_DEFAULT_DISPLAY_MODE);
-    if (res != 0)
-    {
-        ssd1306_interface_debug_print("ssd1306: set display mode failed.\n");
-        (void)ssd1306_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set multiplex ratio */
-    res = ssd1306_set_multiplex_ratio(&gs_handle, SSD1306_ADVANCE_DEFAULT_MULTIPLEX_RATIO);
-    if (res != 0)
-    {
-        ssd1306_interface_debug_print("ssd1306: set multiplex ratio failed.\n");
-        (void)ssd1306_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set display offset */
-    res = ssd1306_set_display_offset(&gs_handle, SSD1306_ADVANCE_DEFAULT_DISPLAY_OFFSET);
-    if (res != 0)
-    {
-        ssd1306_interface_debug_print("ssd1306: set display offset failed.\n");
-        (void)ssd1306_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set display clock */
-    res = ssd1306_set_display_clock(&gs_handle, SSD1306_ADVANCE_DEFAULT_OSCILLATOR_FREQUENCY, SSD1306_ADVANCE_DEFAULT_CLOCK_DIVIDE);
-    if (res != 0)
-    {
-        ssd1306_interface_debug_print("ssd1306: set display clock failed.\n");
-        (void)ssd1306_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set pre charge period */
-    res = ssd1306_set_precharge_period(&gs_handle, SSD1306_ADVANCE_DEFAULT_PHASE1_PERIOD, SSD1306_ADVANCE_DEFAULT_PHASE2_PERIOD);
-    if (res != 0)
-    {
-        ssd1306_interface_debug_print("ssd1306: set pre charge period failed.\n");
-        (void)ssd1306_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set hardware pins conf */
-    res = ssd1306_set_com_pins_hardware_conf(&gs_handle, SSD1306_ADVANCE_DEFAULT_PIN_CONF, SSD1306_ADVANCE_DEFAULT_LEFT_RIGHT_REMAP);
-    if (res != 0)
-    {
-        ssd1306_interface_debug_print("ssd1306: set com pins hardware conf failed.\n");
-        (void)ssd1306_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set deselect level 0.77 */
-    res = ssd1306_set_deselect_level(&gs_handle, SSD1306_ADVANCE_DEFAULT_DESELECT_LEVEL);
-    if (res != 0)
-    {
-        ssd1306_interface_debug_print("ssd1306: set deselect level failed.\n");
-        (void)ssd1306_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* set page memory addressing mode */
-    res = ssd1306_set_memory_addressing_mode(&gs_handle, SSD1306_MEMORY_ADDRESSING_MODE_PAGE);
-    if (res != 0)
-    {
-        ssd1306_interface_debug_print("ssd1306: set memory addressing level failed.\n");
-        (void)ssd1306_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* enable charge pump */
-    res = ssd1306_set_charge_pump(&gs_handle, SSD1306_CHARGE_PUMP_ENABLE);
-    if (res != 0)
-    {
-        ssd1306_interface_debug_print("ssd1306: set charge pump failed.\n");
-        (void)ssd1306_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* entire display off */
-    res = ssd1306_set_entire_display(&gs_handle, SSD1306_ENTIRE_DISPLAY_OFF);
-    if (res != 0)
-    {
-        ssd1306_interface_debug_print("ssd1306: set entire display failed.\n");
-        (void)ssd1306_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* enable display */
-    res = ssd1306_set_display(&gs_handle, SSD1306_DISPLAY_ON);
-    if (res != 0)
-    {
-        ssd1306_interface_debug_print("ssd1306: set display failed.\n");
-        (void)ssd1306_deinit(&gs_handle);
-        
-        return 1;
-    }
-    
-    /* clear screen */
-    res = ssd1306_clear(&gs_handle);
+    /* load the default init table */
+    (void)ssd1306_basic_get_init_table(&table, &len);
+    res = ssd1306_load_init_table(&gs_handle, table, len);
     if (res != 0)
     {
-        ssd1306_interface_debug_print("ssd1306: clear failed.\n");
+        ssd1306_interface_debug_print("ssd1306: load init table failed.\n");
         (void)ssd1306_deinit(&gs_handle);
         
         return 1;
@@ -498,7 +275,7 @@ uint8_t ssd1306_advance_string(uint8_t x, uint8_t y, char *str, uint16_t len, ui
     }
     
     /* update gram */
-    if (ssd1306_gram_update(&gs_handle) != 0)
+    if (ssd1306_gram_update_dirty(&gs_handle) != 0)
     {
         return 1;
     }
@@ -532,7 +309,7 @@ uint8_t ssd1306_advance_rect(uint8_t left, uint8_t top, uint8_t right, uint8_t b
     }
     
     /* update gram */
-    if (ssd1306_gram_update(&gs_handle) != 0)
+    if (ssd1306_gram_update_dirty(&gs_handle) != 0)
     {
         return 1;
     }
@@ -566,7 +343,7 @@ uint8_t ssd1306_advance_picture(uint8_t left, uint8_t top, uint8_t right, uint8_
     }
     
     /* update gram */
-    if (ssd1306_gram_update(&gs_handle) != 0)
+    if (ssd1306_gram_update_dirty(&gs_handle) != 0)
     {
         return 1;
     }
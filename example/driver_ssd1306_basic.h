@@ -78,6 +78,16 @@ extern "C"{
 #define SSD1306_BASIC_DEFAULT_COLUMN_ADDRESS_RANGE_START       0x00                                       /**< set range start */
 #define SSD1306_BASIC_DEFAULT_COLUMN_ADDRESS_RANGE_END         0x7F                                       /**< set range end */
 
+/**
+ * @brief      basic example get the default init table
+ * @param[out] **table pointer to a table pointer buffer
+ * @param[out] *len pointer to a table length buffer
+ * @return     status code
+ *             - 0 success
+ * @note       the advance example and the engine load the same table
+ */
+uint8_t ssd1306_basic_get_init_table(const uint8_t **table, uint16_t *len);
+
 /**
  * @brief     basic example init
  * @param[in] interface interface type
@@ -192,6 +202,30 @@ uint8_t ssd1306_basic_rect(uint8_t left, uint8_t top, uint8_t right, uint8_t bot
  */
 uint8_t ssd1306_basic_picture(uint8_t left, uint8_t top, uint8_t right, uint8_t bottom, uint8_t *img);
 
+/**
+ * @brief     basic example write a full frame
+ * @param[in] *frame pointer to a 1024 bytes page format frame
+ * @return    status code
+ *            - 0 success
+ *            - 1 write frame failed
+ * @note      only the changed bytes are sent
+ */
+uint8_t ssd1306_basic_frame(uint8_t *frame);
+
+/**
+ * @brief     basic example draw a packed bitmap
+ * @param[in] left left coordinate x
+ * @param[in] top top coordinate y
+ * @param[in] right right coordinate x
+ * @param[in] bottom bottom coordinate y
+ * @param[in] *bits pointer to a packed bitmap buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 draw bitmap failed
+ * @note      1 bit per pixel, rows msb first and padded to a whole byte
+ */
+uint8_t ssd1306_basic_bitmap(uint8_t left, uint8_t top, uint8_t right, uint8_t bottom, uint8_t *bits);
+
 /**
  * @}
  */
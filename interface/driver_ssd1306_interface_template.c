@@ -77,6 +77,42 @@ uint8_t ssd1306_interface_iic_write(uint8_t addr, uint8_t reg, uint8_t *buf, uin
     return 0;
 }
 
+/**
+ * @brief     interface iic bus write command
+ * @param[in] addr iic device write address
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      buf[0] is the control byte
+ */
+uint8_t ssd1306_interface_iic_write_cmd(uint8_t addr, uint8_t *buf, uint16_t len)
+{
+    return 0;
+}
+
+/**
+ * @brief interface bus transfer begin
+ * @note  the bus writes until ssd1306_interface_transfer_end may be queued
+ */
+void ssd1306_interface_transfer_begin(void)
+{
+
+}
+
+/**
+ * @brief  interface bus transfer end
+ * @return status code
+ *         - 0 success
+ *         - 1 write failed
+ * @note   the queued bus writes are submitted
+ */
+uint8_t ssd1306_interface_transfer_end(void)
+{
+    return 0;
+}
+
 /**
  * @brief  interface spi bus init
  * @return status code
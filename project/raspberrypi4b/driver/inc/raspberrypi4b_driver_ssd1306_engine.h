@@ -0,0 +1,122 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      raspberrypi4b_driver_ssd1306_engine.h
+ * @brief     raspberrypi4b driver ssd1306 flush engine header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2021-03-30
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2021/03/30  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef RASPBERRYPI4B_DRIVER_SSD1306_ENGINE_H
+#define RASPBERRYPI4B_DRIVER_SSD1306_ENGINE_H
+
+#include "driver_ssd1306_interface.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup ssd1306_engine ssd1306 flush engine function
+ * @brief    ssd1306 flush engine modules
+ * @ingroup  ssd1306_driver
+ * @{
+ */
+
+/**
+ * @brief engine size definition
+ */
+#define SSD1306_ENGINE_MAX_BUS      4                                                /**< max bus workers */
+#define SSD1306_ENGINE_MAX_PANEL    (SSD1306_ENGINE_MAX_BUS * SSD1306_BUS_MAX_PANEL)  /**< max panels */
+
+/**
+ * @brief      add a panel to the engine
+ * @param[in]  *device pointer to a bus device name, such as /dev/i2c-1 or /dev/spidev0.0
+ * @param[in]  interface interface type
+ * @param[in]  addr iic device address
+ * @param[out] *id pointer to a panel id buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 add failed
+ * @note       every iic device gets its own worker thread, all spi panels share one worker
+ *             because they share the data command gpio, call it before ssd1306_engine_start
+ */
+uint8_t ssd1306_engine_add_panel(char *device, ssd1306_interface_t interface, ssd1306_address_t addr, uint8_t *id);
+
+/**
+ * @brief  init all panels and start the workers
+ * @return status code
+ *         - 0 success
+ *         - 1 start failed
+ * @note   all panels are reset before any of them is configured
+ */
+uint8_t ssd1306_engine_start(void);
+
+/**
+ * @brief  stop the workers and deinit all panels
+ * @return status code
+ *         - 0 success
+ *         - 1 stop failed
+ * @note   none
+ */
+uint8_t ssd1306_engine_stop(void);
+
+/**
+ * @brief     hand a frame to a panel
+ * @param[in] id panel id
+ * @param[in] *frame pointer to a 1024 bytes page format frame
+ * @return    status code
+ *            - 0 success
+ *            - 1 submit failed
+ * @note      lock free, one render thread per panel, a frame not yet taken by the worker
+ *            is replaced by the newer one
+ */
+uint8_t ssd1306_engine_submit(uint8_t id, uint8_t *frame);
+
+/**
+ * @brief      get the statistics of the bus a panel is on
+ * @param[in]  id panel id
+ * @param[out] *stats pointer to a bus statistics structure
+ * @return     status code
+ *             - 0 success
+ *             - 1 get failed
+ * @note       read without a lock, for monitoring only
+ */
+uint8_t ssd1306_engine_get_stats(uint8_t id, ssd1306_bus_stats_t *stats);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
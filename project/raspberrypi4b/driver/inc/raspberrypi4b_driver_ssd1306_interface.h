@@ -0,0 +1,93 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      raspberrypi4b_driver_ssd1306_interface.h
+ * @brief     raspberrypi4b driver ssd1306 interface header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2021-03-30
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2021/03/30  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef RASPBERRYPI4B_DRIVER_SSD1306_INTERFACE_H
+#define RASPBERRYPI4B_DRIVER_SSD1306_INTERFACE_H
+
+#include "driver_ssd1306_interface.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @addtogroup ssd1306_interface_driver
+ * @{
+ */
+
+/**
+ * @brief spi frequency definition
+ * @note  set SPI_FREQUENCY when building to change the default, the chip serial clock is 10MHz at most,
+ *        the interface and the flush engine open their spi devices with it
+ */
+#ifndef SPI_FREQUENCY
+    #define SPI_FREQUENCY (1000 * 1000)       /**< spi frequency */
+#endif
+#if (SPI_FREQUENCY > (10 * 1000 * 1000))
+    #error "SPI_FREQUENCY is over 10MHz."
+#endif
+
+/**
+ * @brief max spi frequency definition
+ */
+#define SPI_FREQUENCY_MAX (10 * 1000 * 1000)  /**< max chip serial clock */
+
+/**
+ * @brief     interface set the spi frequency
+ * @param[in] hz spi frequency
+ * @return    status code
+ *            - 0 success
+ *            - 1 frequency is invalid
+ * @note      0 < hz <= 10MHz, it applies to the spi devices opened after the call
+ */
+uint8_t ssd1306_interface_spi_set_frequency(uint32_t hz);
+
+/**
+ * @brief  interface get the spi frequency
+ * @return spi frequency
+ * @note   SPI_FREQUENCY until ssd1306_interface_spi_set_frequency is called
+ */
+uint32_t ssd1306_interface_spi_get_frequency(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,724 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      raspberrypi4b_driver_ssd1306_engine.c
+ * @brief     raspberrypi4b driver ssd1306 flush engine source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2021-03-30
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2021/03/30  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+
+#include "raspberrypi4b_driver_ssd1306_engine.h"
+#include "raspberrypi4b_driver_ssd1306_interface.h"
+#include "driver_ssd1306_basic.h"
+#include "iic.h"
+#include "spi.h"
+#include "wire.h"
+#include <sys/eventfd.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <errno.h>
+
+/**
+ * @brief engine bus structure definition
+ */
+typedef struct engine_bus_s
+{
+    char name[32];                     /**< bus device name, "spi" for all spi devices */
+    int event_fd;                      /**< worker wake up event */
+    uint8_t running;                   /**< worker running flag */
+    pthread_t thread;                  /**< worker thread */
+    ssd1306_bus_t bus;                 /**< round robin flush scheduler */
+} engine_bus_t;
+
+/**
+ * @brief engine panel structure definition
+ */
+typedef struct engine_panel_s
+{
+    ssd1306_handle_t handle;           /**< ssd1306 handle */
+    engine_bus_t *bus;                 /**< worker of the panel */
+    char device[32];                   /**< bus device name */
+    int fd;                            /**< bus device handle */
+    uint8_t spi;                       /**< spi flag */
+    ssd1306_handoff_t handoff;         /**< lock free frame hand-off to the worker */
+} engine_panel_t;
+
+/**
+ * @brief engine variable definition
+ */
+static engine_bus_t gs_bus[SSD1306_ENGINE_MAX_BUS];        /**< bus workers */
+static uint8_t gs_bus_num = 0;                             /**< bus worker number */
+static engine_panel_t gs_panel[SSD1306_ENGINE_MAX_PANEL];  /**< panels */
+static uint8_t gs_panel_num = 0;                           /**< panel number */
+static ssd1306_group_t gs_group;                           /**< spi panels sharing the data command gpio */
+static uint8_t gs_stop = 0;                                /**< stop flag */
+static uint8_t gs_gpio_ref = 0;                            /**< data command gpio users */
+static uint8_t gs_reset_ref = 0;                           /**< reset gpio users */
+
+/**
+ * @brief  engine bus init
+ * @return status code
+ *         - 0 success
+ * @note   intentionally empty, ssd1306_init needs an iic_init or spi_init link but the hook
+ *         gets no user context, so it can't tell which panel is starting, the device is
+ *         opened with the panel in ssd1306_engine_add_panel and shared by the panels on it
+ */
+static uint8_t a_engine_bus_init(void)
+{
+    return 0;
+}
+
+/**
+ * @brief  engine bus deinit
+ * @return status code
+ *         - 0 success
+ * @note   intentionally empty for the same reason as a_engine_bus_init, a shared device must
+ *         outlive every panel on it, so ssd1306_engine_stop closes each device once after
+ *         all panels are deinited
+ */
+static uint8_t a_engine_bus_deinit(void)
+{
+    return 0;
+}
+
+/**
+ * @brief  engine data command gpio init
+ * @return status code
+ *         - 0 success
+ *         - 1 gpio init failed
+ * @note   the gpio is shared by all panels
+ */
+static uint8_t a_engine_gpio_init(void)
+{
+    if (gs_gpio_ref == 0)
+    {
+        if (wire_init() != 0)
+        {
+            return 1;
+        }
+    }
+    gs_gpio_ref++;
+    
+    return 0;
+}
+
+/**
+ * @brief  engine data command gpio deinit
+ * @return status code
+ *         - 0 success
+ *         - 1 gpio deinit failed
+ * @note   the gpio is shared by all panels
+ */
+static uint8_t a_engine_gpio_deinit(void)
+{
+    if (gs_gpio_ref == 0)
+    {
+        return 0;
+    }
+    gs_gpio_ref--;
+    if (gs_gpio_ref == 0)
+    {
+        return wire_deinit();
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief  engine reset gpio init
+ * @return status code
+ *         - 0 success
+ *         - 1 gpio init failed
+ * @note   the gpio is shared by all panels
+ */
+static uint8_t a_engine_reset_init(void)
+{
+    if (gs_reset_ref == 0)
+    {
+        if (wire_clock_init() != 0)
+        {
+            return 1;
+        }
+    }
+    gs_reset_ref++;
+    
+    return 0;
+}
+
+/**
+ * @brief  engine reset gpio deinit
+ * @return status code
+ *         - 0 success
+ *         - 1 gpio deinit failed
+ * @note   the gpio is shared by all panels
+ */
+static uint8_t a_engine_reset_deinit(void)
+{
+    if (gs_reset_ref == 0)
+    {
+        return 0;
+    }
+    gs_reset_ref--;
+    if (gs_reset_ref == 0)
+    {
+        return wire_clock_deinit();
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     engine iic write
+ * @param[in] *ctx pointer to a panel
+ * @param[in] addr iic device write address
+ * @param[in] reg iic register address
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+static uint8_t a_engine_iic_write(void *ctx, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    return iic_transfer_write(((engine_panel_t *)ctx)->fd, addr, reg, buf, len);
+}
+
+/**
+ * @brief     engine iic write command
+ * @param[in] *ctx pointer to a panel
+ * @param[in] addr iic device write address
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+static uint8_t a_engine_iic_write_cmd(void *ctx, uint8_t addr, uint8_t *buf, uint16_t len)
+{
+    return iic_transfer_write_cmd(((engine_panel_t *)ctx)->fd, addr, buf, len);
+}
+
+/**
+ * @brief     engine spi write command
+ * @param[in] *ctx pointer to a panel
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+static uint8_t a_engine_spi_write_cmd(void *ctx, uint8_t *buf, uint16_t len)
+{
+    return spi_transfer_write_cmd(((engine_panel_t *)ctx)->fd, buf, len);
+}
+
+/**
+ * @brief     engine data command gpio write
+ * @param[in] *ctx pointer to a panel
+ * @param[in] value written value
+ * @return    status code
+ *            - 0 success
+ *            - 1 gpio write failed
+ * @note      the queued spi writes go out before the level changes
+ */
+static uint8_t a_engine_gpio_write(void *ctx, uint8_t value)
+{
+    engine_panel_t *panel = (engine_panel_t *)ctx;
+    
+    if ((panel->spi != 0) && (spi_transfer_flush(panel->fd) != 0))
+    {
+        return 1;
+    }
+    
+    return wire_write(value);
+}
+
+/**
+ * @brief     engine reset gpio write
+ * @param[in] *ctx pointer to a panel
+ * @param[in] value written value
+ * @return    status code
+ *            - 0 success
+ *            - 1 gpio write failed
+ * @note      none
+ */
+static uint8_t a_engine_reset_write(void *ctx, uint8_t value)
+{
+    (void)ctx;
+    
+    return wire_clock_write(value);
+}
+
+/**
+ * @brief     engine transfer begin
+ * @param[in] *ctx pointer to a panel
+ * @note      none
+ */
+static void a_engine_transfer_begin(void *ctx)
+{
+    engine_panel_t *panel = (engine_panel_t *)ctx;
+    
+    if (panel->spi != 0)
+    {
+        (void)spi_transfer_begin(panel->fd);
+    }
+    else
+    {
+        (void)iic_transfer_begin(panel->fd);
+    }
+}
+
+/**
+ * @brief     engine transfer end
+ * @param[in] *ctx pointer to a panel
+ * @return    status code
+ *            - 0 success
+ *            - 1 transfer failed
+ * @note      none
+ */
+static uint8_t a_engine_transfer_end(void *ctx)
+{
+    engine_panel_t *panel = (engine_panel_t *)ctx;
+    
+    if (panel->spi != 0)
+    {
+        return spi_transfer_end(panel->fd);
+    }
+    else
+    {
+        return iic_transfer_end(panel->fd);
+    }
+}
+
+/**
+ * @brief     take the fresh frames of the panels on a bus
+ * @param[in] *bus pointer to a bus worker
+ * @note      the taken frames are written to the gram and marked dirty
+ */
+static void a_engine_take(engine_bus_t *bus)
+{
+    uint8_t i;
+    uint8_t fresh;
+    
+    for (i = 0; i < gs_panel_num; i++)
+    {
+        if (gs_panel[i].bus == bus)
+        {
+            (void)ssd1306_handoff_consume(&gs_panel[i].handoff, &fresh);
+        }
+    }
+}
+
+/**
+ * @brief     bus worker thread
+ * @param[in] *arg pointer to a bus worker
+ * @return    NULL
+ * @note      the worker sleeps on its event and flushes its panels round robin until they are clean
+ */
+static void *a_engine_worker(void *arg)
+{
+    uint64_t count;
+    engine_bus_t *bus = (engine_bus_t *)arg;
+    ssd1306_flush_status_t status;
+    
+    while (1)
+    {
+        /* wait for a frame */
+        if (read(bus->event_fd, &count, sizeof(count)) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            
+            break;
+        }
+        if (__atomic_load_n(&gs_stop, __ATOMIC_ACQUIRE) != 0)
+        {
+            break;
+        }
+        
+        /* flush the latest frames */
+        do
+        {
+            a_engine_take(bus);
+            if (ssd1306_bus_flush_step(&bus->bus, &status) != 0)
+            {
+                ssd1306_interface_debug_print("ssd1306: engine flush failed.\n");
+            }
+        } while ((status == SSD1306_FLUSH_STATUS_BUSY) && 
+                 (__atomic_load_n(&gs_stop, __ATOMIC_ACQUIRE) == 0));
+    }
+    
+    return NULL;
+}
+
+/**
+ * @brief      add a panel to the engine
+ * @param[in]  *device pointer to a bus device name, such as /dev/i2c-1 or /dev/spidev0.0
+ * @param[in]  interface interface type
+ * @param[in]  addr iic device address
+ * @param[out] *id pointer to a panel id buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 add failed
+ * @note       every iic device gets its own worker thread, all spi panels share one worker
+ *             because they share the data command gpio, call it before ssd1306_engine_start
+ */
+uint8_t ssd1306_engine_add_panel(char *device, ssd1306_interface_t interface, ssd1306_address_t addr, uint8_t *id)
+{
+    uint8_t i;
+    char *name;
+    engine_bus_t *bus;
+    engine_panel_t *panel;
+    
+    if ((gs_panel_num >= SSD1306_ENGINE_MAX_PANEL) || (strlen(device) >= sizeof(panel->device)))
+    {
+        ssd1306_interface_debug_print("ssd1306: engine add panel failed.\n");
+        
+        return 1;
+    }
+    
+    /* find the worker */
+    name = (interface == SSD1306_INTERFACE_SPI) ? "spi" : device;
+    bus = NULL;
+    for (i = 0; i < gs_bus_num; i++)
+    {
+        if (strcmp(gs_bus[i].name, name) == 0)
+        {
+            bus = &gs_bus[i];
+            
+            break;
+        }
+    }
+    if (bus == NULL)
+    {
+        if (gs_bus_num >= SSD1306_ENGINE_MAX_BUS)
+        {
+            ssd1306_interface_debug_print("ssd1306: engine has too many buses.\n");
+            
+            return 1;
+        }
+        bus = &gs_bus[gs_bus_num];
+        memset(bus, 0, sizeof(engine_bus_t));
+        strcpy(bus->name, name);
+        bus->event_fd = -1;
+        (void)ssd1306_bus_init(&bus->bus, 0);
+        gs_bus_num++;
+    }
+    if (bus->bus.count >= SSD1306_BUS_MAX_PANEL)
+    {
+        ssd1306_interface_debug_print("ssd1306: engine bus is full.\n");
+        
+        return 1;
+    }
+    
+    /* open the bus device once */
+    panel = &gs_panel[gs_panel_num];
+    memset(panel, 0, sizeof(engine_panel_t));
+    strcpy(panel->device, device);
+    panel->bus = bus;
+    panel->spi = (interface == SSD1306_INTERFACE_SPI) ? 1 : 0;
+    panel->fd = -1;
+    for (i = 0; i < gs_panel_num; i++)
+    {
+        if (strcmp(gs_panel[i].device, device) == 0)
+        {
+            panel->fd = gs_panel[i].fd;
+            
+            break;
+        }
+    }
+    if (panel->fd < 0)
+    {
+        if (panel->spi != 0)
+        {
+            if (spi_init(device, &panel->fd, SPI_MODE_TYPE_3, ssd1306_interface_spi_get_frequency()) != 0)
+            {
+                ssd1306_interface_debug_print("ssd1306: engine open %s failed.\n", device);
+                
+                return 1;
+            }
+        }
+        else
+        {
+            if (iic_init(device, &panel->fd) != 0)
+            {
+                ssd1306_interface_debug_print("ssd1306: engine open %s failed.\n", device);
+                
+                return 1;
+            }
+        }
+    }
+    
+    /* link functions */
+    DRIVER_SSD1306_LINK_INIT(&panel->handle, ssd1306_handle_t);
+    DRIVER_SSD1306_LINK_USER_CTX(&panel->handle, panel);
+    DRIVER_SSD1306_LINK_IIC_INIT(&panel->handle, a_engine_bus_init);
+    DRIVER_SSD1306_LINK_IIC_DEINIT(&panel->handle, a_engine_bus_deinit);
+    DRIVER_SSD1306_LINK_IIC_WRITE_CTX(&panel->handle, a_engine_iic_write);
+    DRIVER_SSD1306_LINK_IIC_WRITE_COMMAND_CTX(&panel->handle, a_engine_iic_write_cmd);
+    DRIVER_SSD1306_LINK_SPI_INIT(&panel->handle, a_engine_bus_init);
+    DRIVER_SSD1306_LINK_SPI_DEINIT(&panel->handle, a_engine_bus_deinit);
+    DRIVER_SSD1306_LINK_SPI_WRITE_COMMAND_CTX(&panel->handle, a_engine_spi_write_cmd);
+    DRIVER_SSD1306_LINK_SPI_COMMAND_DATA_GPIO_INIT(&panel->handle, a_engine_gpio_init);
+    DRIVER_SSD1306_LINK_SPI_COMMAND_DATA_GPIO_DEINIT(&panel->handle, a_engine_gpio_deinit);
+    DRIVER_SSD1306_LINK_SPI_COMMAND_DATA_GPIO_WRITE_CTX(&panel->handle, a_engine_gpio_write);
+    DRIVER_SSD1306_LINK_RESET_GPIO_INIT(&panel->handle, a_engine_reset_init);
+    DRIVER_SSD1306_LINK_RESET_GPIO_DEINIT(&panel->handle, a_engine_reset_deinit);
+    DRIVER_SSD1306_LINK_RESET_GPIO_WRITE_CTX(&panel->handle, a_engine_reset_write);
+    DRIVER_SSD1306_LINK_TRANSFER_BEGIN_CTX(&panel->handle, a_engine_transfer_begin);
+    DRIVER_SSD1306_LINK_TRANSFER_END_CTX(&panel->handle, a_engine_transfer_end);
+    DRIVER_SSD1306_LINK_DELAY_MS(&panel->handle, ssd1306_interface_delay_ms);
+    DRIVER_SSD1306_LINK_DEBUG_PRINT(&panel->handle, ssd1306_interface_debug_print);
+    (void)ssd1306_set_interface(&panel->handle, interface);
+    (void)ssd1306_set_addr_pin(&panel->handle, addr);
+    *id = gs_panel_num;
+    gs_panel_num++;
+    
+    return 0;
+}
+
+/**
+ * @brief  init all panels and start the workers
+ * @return status code
+ *         - 0 success
+ *         - 1 start failed
+ * @note   all panels are reset before any of them is configured
+ */
+uint8_t ssd1306_engine_start(void)
+{
+    uint8_t i;
+    uint16_t len;
+    const uint8_t *table;
+    
+    /* reset all panels */
+    __atomic_store_n(&gs_stop, 0, __ATOMIC_RELEASE);
+    (void)ssd1306_group_init(&gs_group);
+    for (i = 0; i < gs_panel_num; i++)
+    {
+        if (ssd1306_init(&gs_panel[i].handle) != 0)
+        {
+            ssd1306_interface_debug_print("ssd1306: engine init panel %d failed.\n", i);
+            (void)ssd1306_engine_stop();
+            
+            return 1;
+        }
+        if ((ssd1306_handoff_init(&gs_panel[i].handoff, &gs_panel[i].handle) != 0) || 
+            ((gs_panel[i].spi != 0) && (ssd1306_group_add(&gs_group, &gs_panel[i].handle) != 0)))
+        {
+            (void)ssd1306_engine_stop();
+            
+            return 1;
+        }
+    }
+    
+    /* configure all panels */
+    (void)ssd1306_basic_get_init_table(&table, &len);
+    if ((gs_group.count != 0) && 
+        (ssd1306_group_load_init_table(&gs_group, table, len) != 0))
+    {
+        ssd1306_interface_debug_print("ssd1306: engine load init table failed.\n");
+        (void)ssd1306_engine_stop();
+        
+        return 1;
+    }
+    for (i = 0; i < gs_panel_num; i++)
+    {
+        if ((gs_panel[i].spi == 0) && 
+            (ssd1306_load_init_table(&gs_panel[i].handle, table, len) != 0))
+        {
+            ssd1306_interface_debug_print("ssd1306: engine load init table failed.\n");
+            (void)ssd1306_engine_stop();
+            
+            return 1;
+        }
+        if (ssd1306_bus_add(&gs_panel[i].bus->bus, &gs_panel[i].handle) != 0)
+        {
+            (void)ssd1306_engine_stop();
+            
+            return 1;
+        }
+    }
+    
+    /* start the workers */
+    for (i = 0; i < gs_bus_num; i++)
+    {
+        gs_bus[i].event_fd = eventfd(0, EFD_CLOEXEC);
+        if (gs_bus[i].event_fd < 0)
+        {
+            ssd1306_interface_debug_print("ssd1306: engine create event failed.\n");
+            (void)ssd1306_engine_stop();
+            
+            return 1;
+        }
+        if (pthread_create(&gs_bus[i].thread, NULL, a_engine_worker, &gs_bus[i]) != 0)
+        {
+            ssd1306_interface_debug_print("ssd1306: engine create worker failed.\n");
+            (void)ssd1306_engine_stop();
+            
+            return 1;
+        }
+        gs_bus[i].running = 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief  stop the workers and deinit all panels
+ * @return status code
+ *         - 0 success
+ *         - 1 stop failed
+ * @note   none
+ */
+uint8_t ssd1306_engine_stop(void)
+{
+    uint8_t i;
+    uint8_t j;
+    uint8_t res;
+    uint64_t one;
+    
+    /* stop the workers */
+    res = 0;
+    one = 1;
+    __atomic_store_n(&gs_stop, 1, __ATOMIC_RELEASE);
+    for (i = 0; i < gs_bus_num; i++)
+    {
+        if (gs_bus[i].running != 0)
+        {
+            (void)write(gs_bus[i].event_fd, &one, sizeof(one));
+            (void)pthread_join(gs_bus[i].thread, NULL);
+            gs_bus[i].running = 0;
+        }
+        if (gs_bus[i].event_fd >= 0)
+        {
+            (void)close(gs_bus[i].event_fd);
+            gs_bus[i].event_fd = -1;
+        }
+    }
+    
+    /* deinit the panels */
+    for (i = 0; i < gs_panel_num; i++)
+    {
+        if ((gs_panel[i].handle.inited == 1) && (ssd1306_deinit(&gs_panel[i].handle) != 0))
+        {
+            res = 1;
+        }
+    }
+    
+    /* close the bus devices once */
+    for (i = 0; i < gs_panel_num; i++)
+    {
+        for (j = 0; j < i; j++)
+        {
+            if (gs_panel[j].fd == gs_panel[i].fd)
+            {
+                break;
+            }
+        }
+        if (j != i)
+        {
+            continue;
+        }
+        if (gs_panel[i].spi != 0)
+        {
+            (void)spi_deinit(gs_panel[i].fd);
+        }
+        else
+        {
+            (void)iic_deinit(gs_panel[i].fd);
+        }
+    }
+    gs_panel_num = 0;
+    gs_bus_num = 0;
+    
+    return res;
+}
+
+/**
+ * @brief     hand a frame to a panel
+ * @param[in] id panel id
+ * @param[in] *frame pointer to a 1024 bytes page format frame
+ * @return    status code
+ *            - 0 success
+ *            - 1 submit failed
+ * @note      lock free, one render thread per panel, a frame not yet taken by the worker
+ *            is replaced by the newer one
+ */
+uint8_t ssd1306_engine_submit(uint8_t id, uint8_t *frame)
+{
+    uint8_t *buf;
+    uint64_t one;
+    engine_panel_t *panel;
+    
+    if ((id >= gs_panel_num) || (gs_panel[id].bus->running == 0))
+    {
+        return 1;
+    }
+    
+    /* publish the frame */
+    panel = &gs_panel[id];
+    (void)ssd1306_handoff_get_frame(&panel->handoff, &buf);
+    memcpy(buf, frame, 1024);
+    (void)ssd1306_handoff_publish(&panel->handoff);
+    
+    /* wake the worker */
+    one = 1;
+    if (write(panel->bus->event_fd, &one, sizeof(one)) != sizeof(one))
+    {
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief      get the statistics of the bus a panel is on
+ * @param[in]  id panel id
+ * @param[out] *stats pointer to a bus statistics structure
+ * @return     status code
+ *             - 0 success
+ *             - 1 get failed
+ * @note       read without a lock, for monitoring only
+ */
+uint8_t ssd1306_engine_get_stats(uint8_t id, ssd1306_bus_stats_t *stats)
+{
+    if (id >= gs_panel_num)
+    {
+        return 1;
+    }
+    
+    return (ssd1306_bus_get_stats(&gs_panel[id].bus->bus, stats) != 0) ? 1 : 0;
+}
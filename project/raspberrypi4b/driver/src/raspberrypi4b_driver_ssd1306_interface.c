@@ -35,7 +35,7 @@
  * </table>
  */
 
-#include "driver_ssd1306_interface.h"
+#include "raspberrypi4b_driver_ssd1306_interface.h"
 #include "iic.h"
 #include "spi.h"
 #include "wire.h"
@@ -54,12 +54,17 @@
 /**
  * @brief iic device handle definition
  */
-static int gs_iic_fd;                       /**< iic handle */
+static int gs_iic_fd = -1;                  /**< iic handle */
 
 /**
  * @brief spi device handle definition
  */
-static int gs_spi_fd;                       /**< spi handle */
+static int gs_spi_fd = -1;                  /**< spi handle */
+
+/**
+ * @brief spi frequency definition
+ */
+static uint32_t gs_spi_frequency = SPI_FREQUENCY;     /**< spi frequency */
 
 /**
  * @brief  interface iic bus init
@@ -82,7 +87,12 @@ uint8_t ssd1306_interface_iic_init(void)
  */
 uint8_t ssd1306_interface_iic_deinit(void)
 {
-    return iic_deinit(gs_iic_fd);
+    uint8_t res;
+    
+    res = iic_deinit(gs_iic_fd);
+    gs_iic_fd = -1;
+    
+    return res;
 }
 
 /**
@@ -98,7 +108,92 @@ uint8_t ssd1306_interface_iic_deinit(void)
  */
 uint8_t ssd1306_interface_iic_write(uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
 {
-    return iic_write(gs_iic_fd, addr, reg, buf, len);
+    return iic_transfer_write(gs_iic_fd, addr, reg, buf, len);
+}
+
+/**
+ * @brief     interface iic bus write command
+ * @param[in] addr iic device write address
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      buf[0] is the control byte
+ */
+uint8_t ssd1306_interface_iic_write_cmd(uint8_t addr, uint8_t *buf, uint16_t len)
+{
+    return iic_transfer_write_cmd(gs_iic_fd, addr, buf, len);
+}
+
+/**
+ * @brief interface bus transfer begin
+ * @note  the iic or spi writes until ssd1306_interface_transfer_end go in one ioctl
+ *        as long as the data command gpio doesn't change
+ */
+void ssd1306_interface_transfer_begin(void)
+{
+    if (gs_iic_fd >= 0)
+    {
+        (void)iic_transfer_begin(gs_iic_fd);
+    }
+    if (gs_spi_fd >= 0)
+    {
+        (void)spi_transfer_begin(gs_spi_fd);
+    }
+}
+
+/**
+ * @brief  interface bus transfer end
+ * @return status code
+ *         - 0 success
+ *         - 1 write failed
+ * @note   none
+ */
+uint8_t ssd1306_interface_transfer_end(void)
+{
+    uint8_t res;
+    
+    res = 0;
+    if ((gs_iic_fd >= 0) && (iic_transfer_end(gs_iic_fd) != 0))
+    {
+        res = 1;
+    }
+    if ((gs_spi_fd >= 0) && (spi_transfer_end(gs_spi_fd) != 0))
+    {
+        res = 1;
+    }
+    
+    return res;
+}
+
+/**
+ * @brief     interface set the spi frequency
+ * @param[in] hz spi frequency
+ * @return    status code
+ *            - 0 success
+ *            - 1 frequency is invalid
+ * @note      0 < hz <= 10MHz, it applies to the spi devices opened after the call
+ */
+uint8_t ssd1306_interface_spi_set_frequency(uint32_t hz)
+{
+    if ((hz == 0) || (hz > SPI_FREQUENCY_MAX))
+    {
+        return 1;
+    }
+    gs_spi_frequency = hz;
+    
+    return 0;
+}
+
+/**
+ * @brief  interface get the spi frequency
+ * @return spi frequency
+ * @note   SPI_FREQUENCY until ssd1306_interface_spi_set_frequency is called
+ */
+uint32_t ssd1306_interface_spi_get_frequency(void)
+{
+    return gs_spi_frequency;
 }
 
 /**
@@ -106,11 +201,11 @@ uint8_t ssd1306_interface_iic_write(uint8_t addr, uint8_t reg, uint8_t *buf, uin
  * @return status code
  *         - 0 success
  *         - 1 spi init failed
- * @note   none
+ * @note   the device is opened with the selected spi frequency
  */
 uint8_t ssd1306_interface_spi_init(void)
 {
-    return spi_init(SPI_DEVICE_NAME, &gs_spi_fd, SPI_MODE_TYPE_3, 1000 * 1000);
+    return spi_init(SPI_DEVICE_NAME, &gs_spi_fd, SPI_MODE_TYPE_3, gs_spi_frequency);
 }
 
 /**
@@ -122,7 +217,12 @@ uint8_t ssd1306_interface_spi_init(void)
  */
 uint8_t ssd1306_interface_spi_deinit(void)
 {
-    return spi_deinit(gs_spi_fd);
+    uint8_t res;
+    
+    res = spi_deinit(gs_spi_fd);
+    gs_spi_fd = -1;
+    
+    return res;
 }
 
 /**
@@ -136,7 +236,7 @@ uint8_t ssd1306_interface_spi_deinit(void)
  */
 uint8_t ssd1306_interface_spi_write_cmd(uint8_t *buf, uint16_t len)
 {
-    return spi_write_cmd(gs_spi_fd, buf, len);
+    return spi_transfer_write_cmd(gs_spi_fd, buf, len);
 }
 
 /**
@@ -201,6 +301,12 @@ uint8_t ssd1306_interface_spi_cmd_data_gpio_deinit(void)
  */
 uint8_t ssd1306_interface_spi_cmd_data_gpio_write(uint8_t value)
 {
+    /* the queued spi writes go out before the level changes */
+    if ((gs_spi_fd >= 0) && (spi_transfer_flush(gs_spi_fd) != 0))
+    {
+        return 1;
+    }
+    
     return wire_write(value);
 }
 
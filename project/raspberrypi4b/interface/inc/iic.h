@@ -156,6 +156,54 @@ uint8_t iic_write(int fd, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
  */
 uint8_t iic_write_address16(int fd, uint8_t addr, uint16_t reg, uint8_t *buf, uint16_t len);
 
+/**
+ * @brief     iic bus transfer begin
+ * @param[in] fd iic handle
+ * @return    status code
+ *            - 0 success
+ *            - 1 begin failed
+ * @note      the writes until iic_transfer_end are submitted with one ioctl,
+ *            the writes go out at once if the adapter can't combine messages
+ */
+uint8_t iic_transfer_begin(int fd);
+
+/**
+ * @brief     iic bus transfer write
+ * @param[in] fd iic handle
+ * @param[in] addr iic device write address
+ * @param[in] reg iic register address
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      addr = device_address_7bits << 1
+ */
+uint8_t iic_transfer_write(int fd, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len);
+
+/**
+ * @brief     iic bus transfer write command
+ * @param[in] fd iic handle
+ * @param[in] addr iic device write address
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      addr = device_address_7bits << 1
+ */
+uint8_t iic_transfer_write_cmd(int fd, uint8_t addr, uint8_t *buf, uint16_t len);
+
+/**
+ * @brief     iic bus transfer end
+ * @param[in] fd iic handle
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      a failed write since iic_transfer_begin is reported here
+ */
+uint8_t iic_transfer_end(int fd);
+
 /**
  * @}
  */
@@ -191,6 +191,47 @@ uint8_t spi_write_read(int fd, uint8_t *in_buf, uint32_t in_len, uint8_t *out_bu
  */
 uint8_t spi_transmit(int fd, uint8_t *tx, uint8_t *rx, uint16_t len);
 
+/**
+ * @brief     spi bus transfer begin
+ * @param[in] fd spi handle
+ * @return    status code
+ *            - 0 success
+ * @note      the writes until spi_transfer_end are submitted with SPI_IOC_MESSAGE(n)
+ */
+uint8_t spi_transfer_begin(int fd);
+
+/**
+ * @brief     spi bus transfer flush
+ * @param[in] fd spi handle
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the queue stays open, call it before other lines such as the data command gpio change
+ */
+uint8_t spi_transfer_flush(int fd);
+
+/**
+ * @brief     spi bus transfer write command
+ * @param[in] fd spi handle
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the queue is flushed first when the data doesn't fit
+ */
+uint8_t spi_transfer_write_cmd(int fd, uint8_t *buf, uint16_t len);
+
+/**
+ * @brief     spi bus transfer end
+ * @param[in] fd spi handle
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      a failed write since spi_transfer_begin is reported here
+ */
+uint8_t spi_transfer_end(int fd);
+
 /**
  * @}
  */
@@ -40,6 +40,25 @@
 #include <sys/ioctl.h>
 #include <fcntl.h>
 
+/**
+ * @brief iic transfer queue definition
+ */
+#define IIC_TRANSFER_MAX_MSGS    I2C_RDWR_IOCTL_MAX_MSGS        /**< max messages in one ioctl */
+#define IIC_TRANSFER_BUF_SIZE    4096                           /**< queued bytes */
+
+/**
+ * @brief iic transfer queue variable definition
+ * @note  every thread has its own queue, so each bus can be driven by its own thread
+ */
+static __thread struct i2c_msg gs_transfer_msgs[IIC_TRANSFER_MAX_MSGS]; /**< queued messages */
+static __thread uint8_t gs_transfer_buf[IIC_TRANSFER_BUF_SIZE];         /**< queued bytes */
+static __thread uint32_t gs_transfer_msgs_num = 0;                      /**< queued message number */
+static __thread uint32_t gs_transfer_len = 0;                           /**< queued byte length */
+static __thread uint8_t gs_transfer_queue = 0;                          /**< queue flag */
+static __thread uint8_t gs_transfer_error = 0;                          /**< queue error flag */
+static __thread int gs_transfer_fd = -1;                                /**< checked iic handle */
+static __thread uint8_t gs_transfer_support = 0;                        /**< multiple message support flag */
+
 /**
  * @brief      iic bus init
  * @param[in]  *name pointer to an iic device name buffer
@@ -291,9 +310,6 @@ uint8_t iic_write(int fd, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
     /* clear msgs data */
     memset(msgs, 0, sizeof(struct i2c_msg) * 1);
     
-    /* clear sent buf */
-    memset(buf_send, 0, sizeof(uint8_t) * (len + 1));
-    
     /* set the param */
     msgs[0].addr = addr >> 1;
     msgs[0].flags = 0;
@@ -363,3 +379,235 @@ uint8_t iic_write_address16(int fd, uint8_t addr, uint16_t reg, uint8_t *buf, ui
      
     return 0;
 }
+
+/**
+ * @brief     submit the queued iic messages
+ * @param[in] fd iic handle
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+static uint8_t a_iic_transfer_submit(int fd)
+{
+    struct i2c_rdwr_ioctl_data i2c_rdwr_data;
+    uint8_t res;
+    
+    /* check the queue */
+    if (gs_transfer_msgs_num == 0)
+    {
+        return 0;
+    }
+    
+    /* set the param */
+    memset(&i2c_rdwr_data, 0, sizeof(struct i2c_rdwr_ioctl_data));
+    i2c_rdwr_data.msgs = gs_transfer_msgs;
+    i2c_rdwr_data.nmsgs = gs_transfer_msgs_num;
+    
+    /* transmit all messages */
+    res = 0;
+    if (ioctl(fd, I2C_RDWR, &i2c_rdwr_data) < 0)
+    {
+        perror("iic: write failed.\n");
+        
+        res = 1;
+    }
+    
+    /* clear the queue */
+    gs_transfer_msgs_num = 0;
+    gs_transfer_len = 0;
+    
+    return res;
+}
+
+/**
+ * @brief     queue one iic message
+ * @param[in] fd iic handle
+ * @param[in] addr iic device write address
+ * @param[in] reg iic register address
+ * @param[in] prefix 1 to put the register address in front of the data
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the queue is submitted first when the message doesn't fit
+ */
+static uint8_t a_iic_transfer_queue(int fd, uint8_t addr, uint8_t reg, uint8_t prefix, uint8_t *buf, uint16_t len)
+{
+    uint32_t size;
+    
+    /* get the message size */
+    size = (uint32_t)len + prefix;
+    
+    /* submit the queue if the message doesn't fit */
+    if ((gs_transfer_msgs_num >= IIC_TRANSFER_MAX_MSGS) || 
+        ((gs_transfer_len + size) > IIC_TRANSFER_BUF_SIZE))
+    {
+        if (a_iic_transfer_submit(fd) != 0)
+        {
+            return 1;
+        }
+    }
+    
+    /* write a message larger than the queue directly */
+    if (size > IIC_TRANSFER_BUF_SIZE)
+    {
+        if (prefix != 0)
+        {
+            return iic_write(fd, addr, reg, buf, len);
+        }
+        else
+        {
+            return iic_write_cmd(fd, addr, buf, len);
+        }
+    }
+    
+    /* copy the message */
+    if (prefix != 0)
+    {
+        gs_transfer_buf[gs_transfer_len] = reg;
+    }
+    memcpy(&gs_transfer_buf[gs_transfer_len + prefix], buf, len);
+    
+    /* set the param */
+    memset(&gs_transfer_msgs[gs_transfer_msgs_num], 0, sizeof(struct i2c_msg));
+    gs_transfer_msgs[gs_transfer_msgs_num].addr = addr >> 1;
+    gs_transfer_msgs[gs_transfer_msgs_num].flags = 0;
+    gs_transfer_msgs[gs_transfer_msgs_num].buf = &gs_transfer_buf[gs_transfer_len];
+    gs_transfer_msgs[gs_transfer_msgs_num].len = (uint16_t)size;
+    gs_transfer_msgs_num++;
+    gs_transfer_len += size;
+    
+    return 0;
+}
+
+/**
+ * @brief     iic bus transfer begin
+ * @param[in] fd iic handle
+ * @return    status code
+ *            - 0 success
+ *            - 1 begin failed
+ * @note      the writes until iic_transfer_end are submitted with one ioctl,
+ *            the writes go out at once if the adapter can't combine messages
+ */
+uint8_t iic_transfer_begin(int fd)
+{
+    unsigned long funcs;
+    
+    /* check the adapter once */
+    if (gs_transfer_fd != fd)
+    {
+        gs_transfer_support = 0;
+        if (ioctl(fd, I2C_FUNCS, &funcs) < 0)
+        {
+            perror("iic: get funcs failed.\n");
+            
+            return 1;
+        }
+        if ((funcs & I2C_FUNC_I2C) != 0)
+        {
+            gs_transfer_support = 1;
+        }
+        gs_transfer_fd = fd;
+    }
+    
+    /* start the queue */
+    gs_transfer_msgs_num = 0;
+    gs_transfer_len = 0;
+    gs_transfer_error = 0;
+    gs_transfer_queue = gs_transfer_support;
+    
+    return 0;
+}
+
+/**
+ * @brief     iic bus transfer write
+ * @param[in] fd iic handle
+ * @param[in] addr iic device write address
+ * @param[in] reg iic register address
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      addr = device_address_7bits << 1
+ */
+uint8_t iic_transfer_write(int fd, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    /* write at once without a queue */
+    if (gs_transfer_queue == 0)
+    {
+        return iic_write(fd, addr, reg, buf, len);
+    }
+    
+    /* queue the message */
+    if (a_iic_transfer_queue(fd, addr, reg, 1, buf, len) != 0)
+    {
+        gs_transfer_error = 1;
+        
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     iic bus transfer write command
+ * @param[in] fd iic handle
+ * @param[in] addr iic device write address
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      addr = device_address_7bits << 1
+ */
+uint8_t iic_transfer_write_cmd(int fd, uint8_t addr, uint8_t *buf, uint16_t len)
+{
+    /* write at once without a queue */
+    if (gs_transfer_queue == 0)
+    {
+        return iic_write_cmd(fd, addr, buf, len);
+    }
+    
+    /* queue the message */
+    if (a_iic_transfer_queue(fd, addr, 0x00, 0, buf, len) != 0)
+    {
+        gs_transfer_error = 1;
+        
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     iic bus transfer end
+ * @param[in] fd iic handle
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      a failed write since iic_transfer_begin is reported here
+ */
+uint8_t iic_transfer_end(int fd)
+{
+    uint8_t res;
+    
+    /* submit the rest */
+    res = 0;
+    if (gs_transfer_queue != 0)
+    {
+        res = a_iic_transfer_submit(fd);
+    }
+    if (gs_transfer_error != 0)
+    {
+        res = 1;
+    }
+    
+    /* stop the queue */
+    gs_transfer_queue = 0;
+    gs_transfer_error = 0;
+    
+    return res;
+}
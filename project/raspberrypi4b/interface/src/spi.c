@@ -39,6 +39,23 @@
 #include <sys/ioctl.h>
 #include <fcntl.h>
 
+/**
+ * @brief spi transfer queue definition
+ */
+#define SPI_TRANSFER_MAX_NUM     32          /**< max transfers in one message */
+#define SPI_TRANSFER_BUF_SIZE    4096        /**< spidev default buffer size */
+
+/**
+ * @brief spi transfer queue variable definition
+ * @note  every thread has its own queue, so each bus can be driven by its own thread
+ */
+static __thread struct spi_ioc_transfer gs_transfer[SPI_TRANSFER_MAX_NUM]; /**< queued transfers */
+static __thread uint8_t gs_transfer_buf[SPI_TRANSFER_BUF_SIZE];            /**< queued bytes */
+static __thread uint32_t gs_transfer_num = 0;                              /**< queued transfer number */
+static __thread uint32_t gs_transfer_len = 0;                              /**< queued byte length */
+static __thread uint8_t gs_transfer_queue = 0;                             /**< queue flag */
+static __thread uint8_t gs_transfer_error = 0;                             /**< queue error flag */
+
 /**
  * @brief      spi bus init
  * @param[in]  *name pointer to a spi device name buffer
@@ -512,3 +529,145 @@ uint8_t spi_transmit(int fd, uint8_t *tx, uint8_t *rx, uint16_t len)
     
     return 0;
 }
+
+/**
+ * @brief     spi bus transfer begin
+ * @param[in] fd spi handle
+ * @return    status code
+ *            - 0 success
+ * @note      the writes until spi_transfer_end are submitted with SPI_IOC_MESSAGE(n)
+ */
+uint8_t spi_transfer_begin(int fd)
+{
+    (void)fd;
+    
+    /* start the queue */
+    gs_transfer_num = 0;
+    gs_transfer_len = 0;
+    gs_transfer_error = 0;
+    gs_transfer_queue = 1;
+    
+    return 0;
+}
+
+/**
+ * @brief     spi bus transfer flush
+ * @param[in] fd spi handle
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the queue stays open, call it before other lines such as the data command gpio change
+ */
+uint8_t spi_transfer_flush(int fd)
+{
+    int l;
+    uint8_t res;
+    
+    /* check the queue */
+    if (gs_transfer_num == 0)
+    {
+        return 0;
+    }
+    
+    /* transmit all transfers */
+    res = 0;
+    l = ioctl(fd, SPI_IOC_MESSAGE(gs_transfer_num), gs_transfer);
+    if (l != (int)gs_transfer_len)
+    {
+        perror("spi: length check error.\n");
+        gs_transfer_error = 1;
+        
+        res = 1;
+    }
+    
+    /* clear the queue */
+    gs_transfer_num = 0;
+    gs_transfer_len = 0;
+    
+    return res;
+}
+
+/**
+ * @brief     spi bus transfer write command
+ * @param[in] fd spi handle
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the queue is flushed first when the data doesn't fit
+ */
+uint8_t spi_transfer_write_cmd(int fd, uint8_t *buf, uint16_t len)
+{
+    /* write at once without a queue */
+    if (gs_transfer_queue == 0)
+    {
+        return spi_write_cmd(fd, buf, len);
+    }
+    
+    /* flush the queue if the data doesn't fit */
+    if ((gs_transfer_num >= SPI_TRANSFER_MAX_NUM) || 
+        ((gs_transfer_len + len) > SPI_TRANSFER_BUF_SIZE))
+    {
+        if (spi_transfer_flush(fd) != 0)
+        {
+            return 1;
+        }
+    }
+    
+    /* write the data larger than the queue directly */
+    if (len > SPI_TRANSFER_BUF_SIZE)
+    {
+        if (spi_write_cmd(fd, buf, len) != 0)
+        {
+            gs_transfer_error = 1;
+            
+            return 1;
+        }
+        
+        return 0;
+    }
+    
+    /* copy the data */
+    memcpy(&gs_transfer_buf[gs_transfer_len], buf, len);
+    
+    /* set the param */
+    memset(&gs_transfer[gs_transfer_num], 0, sizeof(struct spi_ioc_transfer));
+    gs_transfer[gs_transfer_num].tx_buf = (unsigned long)&gs_transfer_buf[gs_transfer_len];
+    gs_transfer[gs_transfer_num].len = len;
+    gs_transfer[gs_transfer_num].cs_change = 0;
+    gs_transfer_num++;
+    gs_transfer_len += len;
+    
+    return 0;
+}
+
+/**
+ * @brief     spi bus transfer end
+ * @param[in] fd spi handle
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      a failed write since spi_transfer_begin is reported here
+ */
+uint8_t spi_transfer_end(int fd)
+{
+    uint8_t res;
+    
+    /* submit the rest */
+    res = 0;
+    if (gs_transfer_queue != 0)
+    {
+        res = spi_transfer_flush(fd);
+    }
+    if (gs_transfer_error != 0)
+    {
+        res = 1;
+    }
+    
+    /* stop the queue */
+    gs_transfer_queue = 0;
+    gs_transfer_error = 0;
+    
+    return res;
+}
@@ -34,8 +34,12 @@
  * </table>
  */
 
+#define _GNU_SOURCE
+
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/mman.h>
+#include <sys/un.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <unistd.h>
@@ -43,27 +47,68 @@
 #include <stdlib.h>
 #include <stdio.h>
 
+/**
+ * @brief binary message definition
+ */
+#define CLIENT_MSG_MAGIC      0xA5               /**< binary message magic */
+#define CLIENT_MSG_FRAME      0x01               /**< full frame message */
+#define CLIENT_MSG_RECT       0x02               /**< rect message */
+#define CLIENT_MSG_SHM        0x03               /**< shared frame request message */
+#define CLIENT_MSG_HEADER     8                  /**< message header length */
+
+/**
+ * @brief shared frame structure definition
+ */
+typedef struct client_shm_s
+{
+    uint32_t gen;                      /**< frame generation, odd while the frame is written */
+    uint32_t reserved;                 /**< reserved */
+    uint8_t frame[1024];               /**< page format frame */
+} client_shm_t;
+
 /**
  * @brief global var definition
  */
 uint8_t g_buf[256];                              /**< uart buffer */
 volatile uint16_t g_len;                         /**< uart buffer length */
 static int gs_sock_fd;                           /**< network handle */
-static int gs_conn_fd;                           /**< network handle */
 static struct sockaddr_in gs_server_addr;        /**< server address */
 
 /**
- * @brief     main function
- * @param[in] argc arg numbers
- * @param[in] **argv arg address
+ * @brief     connect to the server
+ * @param[in] *path pointer to a unix socket path, NULL means tcp 127.0.0.1:6666
  * @return    status code
  *            - 0 success
- *            - 1 run failed
+ *            - 1 connect failed
  * @note      none
  */
-int main(uint8_t argc, char **argv)
+static uint8_t a_client_connect(char *path)
 {
-    uint8_t *p;
+    struct sockaddr_un addr;
+    
+    /* connect to the unix socket */
+    if (path != NULL)
+    {
+        gs_sock_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (gs_sock_fd < 0) 
+        {
+            printf("ssd1306: creat socket failed.\n");
+            
+            return 1;
+        }
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+        if (connect(gs_sock_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) 
+        {
+            printf("ssd1306: connect failed.\n");
+            (void)close(gs_sock_fd);
+            
+            return 1;
+        }
+        
+        return 0;
+    }
     
     /* creat a socket */
     gs_sock_fd = socket(AF_INET, SOCK_STREAM, 0);
@@ -97,17 +142,357 @@ int main(uint8_t argc, char **argv)
         return 1;
     }
     
+    return 0;
+}
+
+/**
+ * @brief     send all bytes
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 send failed
+ * @note      none
+ */
+static uint8_t a_client_send(uint8_t *buf, size_t len)
+{
+    ssize_t n;
+    
+    while (len != 0)
+    {
+        n = send(gs_sock_fd, buf, len, 0);
+        if (n <= 0) 
+        {
+            printf("ssd1306: send failed.\n");
+            
+            return 1;
+        }
+        buf += n;
+        len -= (size_t)n;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     send the frames of a file
+ * @param[in] *file pointer to a file path
+ * @param[in] *rect pointer to a rect buffer, NULL means full frames
+ * @return    status code
+ *            - 0 success
+ *            - 1 send failed
+ * @note      the file holds 1024 bytes page format frames or packed bitmaps of the rect,
+ *            every message gets the next sequence
+ */
+static uint8_t a_client_send_frames(char *file, uint8_t *rect)
+{
+    FILE *fp;
+    size_t len;
+    size_t offset;
+    uint32_t seq;
+    uint8_t msg[CLIENT_MSG_HEADER + 4 + 1024];
+    
+    /* get the payload length */
+    if (rect != NULL)
+    {
+        memcpy(&msg[CLIENT_MSG_HEADER], rect, 4);
+        offset = 4;
+        len = (size_t)((rect[2] - rect[0] + 8) / 8) * (size_t)(rect[3] - rect[1] + 1);
+        msg[1] = CLIENT_MSG_RECT;
+    }
+    else
+    {
+        offset = 0;
+        len = 1024;
+        msg[1] = CLIENT_MSG_FRAME;
+    }
+    msg[0] = CLIENT_MSG_MAGIC;
+    msg[6] = (uint8_t)((offset + len) & 0xFF);
+    msg[7] = (uint8_t)(((offset + len) >> 8) & 0xFF);
+    
+    /* open the file */
+    fp = fopen(file, "rb");
+    if (fp == NULL)
+    {
+        printf("ssd1306: open %s failed.\n", file);
+        
+        return 1;
+    }
+    
+    /* send every frame */
+    seq = 0;
+    while (fread(&msg[CLIENT_MSG_HEADER + offset], 1, len, fp) == len)
+    {
+        seq++;
+        msg[2] = (uint8_t)(seq & 0xFF);
+        msg[3] = (uint8_t)((seq >> 8) & 0xFF);
+        msg[4] = (uint8_t)((seq >> 16) & 0xFF);
+        msg[5] = (uint8_t)((seq >> 24) & 0xFF);
+        if (a_client_send(msg, CLIENT_MSG_HEADER + offset + len) != 0)
+        {
+            (void)fclose(fp);
+            
+            return 1;
+        }
+    }
+    (void)fclose(fp);
+    printf("ssd1306: send %u frames.\n", (unsigned int)seq);
+    
+    return 0;
+}
+
+/**
+ * @brief     write the frames of a file to the shared frame
+ * @param[in] *file pointer to a file path
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the server passes the memfd and the eventfd back over the unix socket,
+ *            every frame is written under the generation counter and then signalled
+ */
+static uint8_t a_client_shm_frames(char *file)
+{
+    FILE *fp;
+    int fds[2];
+    uint8_t ok;
+    uint32_t gen;
+    uint32_t cnt;
+    uint64_t one;
+    uint8_t frame[1024];
+    uint8_t req[CLIENT_MSG_HEADER];
+    struct iovec iov;
+    struct msghdr msg;
+    struct cmsghdr *cmsg;
+    client_shm_t *shm;
+    union
+    {
+        char buf[CMSG_SPACE(sizeof(fds))];
+        struct cmsghdr align;
+    } ctrl;
+    
+    /* request the shared frame */
+    memset(req, 0, sizeof(req));
+    req[0] = CLIENT_MSG_MAGIC;
+    req[1] = CLIENT_MSG_SHM;
+    if (a_client_send(req, sizeof(req)) != 0)
+    {
+        return 1;
+    }
+    
+    /* get the handles */
+    iov.iov_base = &ok;
+    iov.iov_len = 1;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = ctrl.buf;
+    msg.msg_controllen = sizeof(ctrl.buf);
+    if (recvmsg(gs_sock_fd, &msg, 0) != 1)
+    {
+        printf("ssd1306: get shared frame failed.\n");
+        
+        return 1;
+    }
+    cmsg = CMSG_FIRSTHDR(&msg);
+    if ((cmsg == NULL) || (cmsg->cmsg_level != SOL_SOCKET) || (cmsg->cmsg_type != SCM_RIGHTS) || 
+        (cmsg->cmsg_len != CMSG_LEN(sizeof(fds))))
+    {
+        printf("ssd1306: get shared frame failed.\n");
+        
+        return 1;
+    }
+    memcpy(fds, CMSG_DATA(cmsg), sizeof(fds));
+    shm = (client_shm_t *)mmap(NULL, sizeof(client_shm_t), PROT_READ | PROT_WRITE, MAP_SHARED, fds[0], 0);
+    (void)close(fds[0]);
+    if (shm == MAP_FAILED)
+    {
+        printf("ssd1306: map shared frame failed.\n");
+        (void)close(fds[1]);
+        
+        return 1;
+    }
+    
+    /* open the file */
+    fp = fopen(file, "rb");
+    if (fp == NULL)
+    {
+        printf("ssd1306: open %s failed.\n", file);
+        (void)munmap(shm, sizeof(client_shm_t));
+        (void)close(fds[1]);
+        
+        return 1;
+    }
+    
+    /* write every frame */
+    cnt = 0;
+    one = 1;
+    while (fread(frame, 1, sizeof(frame), fp) == sizeof(frame))
+    {
+        gen = __atomic_load_n(&shm->gen, __ATOMIC_RELAXED);
+        __atomic_store_n(&shm->gen, gen + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        memcpy(shm->frame, frame, sizeof(frame));
+        __atomic_store_n(&shm->gen, gen + 2, __ATOMIC_RELEASE);
+        if (write(fds[1], &one, sizeof(one)) != sizeof(one))
+        {
+            printf("ssd1306: signal frame failed.\n");
+            
+            break;
+        }
+        cnt++;
+    }
+    (void)fclose(fp);
+    (void)munmap(shm, sizeof(client_shm_t));
+    (void)close(fds[1]);
+    printf("ssd1306: write %u frames.\n", (unsigned int)cnt);
+    
+    return 0;
+}
+
+/**
+ * @brief     main function
+ * @param[in] argc arg numbers
+ * @param[in] **argv arg address
+ * @return    status code
+ *            - 0 success
+ *            - 1 run failed
+ * @note      ssd1306 [--unix=<path>] <command> sends one command,
+ *            ssd1306 [--unix=<path>] --stdin sends every line of stdin over one connection,
+ *            ssd1306 [--unix=<path>] [--rect=<left>,<top>,<right>,<bottom>] --frame=<file> sends
+ *            the frames of a file as binary messages,
+ *            ssd1306 --unix=<path> --shm --frame=<file> writes the frames of a file to the shared frame
+ */
+int main(uint8_t argc, char **argv)
+{
+    uint8_t *p;
+    char *path;
+    char *frame;
+    uint8_t from_stdin;
+    uint8_t from_shm;
+    uint8_t rect_valid;
+    uint8_t rect[4];
+    unsigned int l, t, r, b;
+    int first;
+    
+    /* get the client options */
+    path = NULL;
+    frame = NULL;
+    from_stdin = 0;
+    from_shm = 0;
+    rect_valid = 0;
+    first = 1;
+    while (first < argc)
+    {
+        if (strncmp(argv[first], "--unix=", 7) == 0)
+        {
+            path = &argv[first][7];
+        }
+        else if (strcmp(argv[first], "--stdin") == 0)
+        {
+            from_stdin = 1;
+        }
+        else if (strcmp(argv[first], "--shm") == 0)
+        {
+            from_shm = 1;
+        }
+        else if (strncmp(argv[first], "--frame=", 8) == 0)
+        {
+            frame = &argv[first][8];
+        }
+        else if (strncmp(argv[first], "--rect=", 7) == 0)
+        {
+            if ((sscanf(&argv[first][7], "%u,%u,%u,%u", &l, &t, &r, &b) != 4) ||
+                (l > r) || (t > b) || (r > 127) || (b > 63))
+            {
+                printf("ssd1306: rect is invalid.\n");
+                
+                return 1;
+            }
+            rect[0] = (uint8_t)l;
+            rect[1] = (uint8_t)t;
+            rect[2] = (uint8_t)r;
+            rect[3] = (uint8_t)b;
+            rect_valid = 1;
+        }
+        else
+        {
+            break;
+        }
+        first++;
+    }
+    
+    /* connect to the server */
+    if (a_client_connect(path) != 0)
+    {
+        return 1;
+    }
+    
+    /* write the shared frames */
+    if ((frame != NULL) && (from_shm != 0))
+    {
+        if (a_client_shm_frames(frame) != 0)
+        {
+            (void)close(gs_sock_fd);
+            
+            return 1;
+        }
+        (void)close(gs_sock_fd);
+        
+        return 0;
+    }
+    
+    /* send the frames */
+    if (frame != NULL)
+    {
+        if (a_client_send_frames(frame, (rect_valid != 0) ? rect : NULL) != 0)
+        {
+            (void)close(gs_sock_fd);
+            
+            return 1;
+        }
+        (void)close(gs_sock_fd);
+        
+        return 0;
+    }
+    
+    /* send every line */
+    if (from_stdin != 0)
+    {
+        while (fgets((char *)g_buf, sizeof(g_buf), stdin) != NULL)
+        {
+            g_len = strlen((char *)g_buf);
+            if ((g_len == 0) || (g_buf[g_len - 1] != '\n'))
+            {
+                if (g_len < (sizeof(g_buf) - 1))
+                {
+                    g_buf[g_len++] = '\n';
+                }
+            }
+            if (a_client_send(g_buf, g_len) != 0)
+            {
+                (void)close(gs_sock_fd);
+                
+                return 1;
+            }
+        }
+        (void)close(gs_sock_fd);
+        
+        return 0;
+    }
+    
     /* cat the full command */
     memset(g_buf, 0, 256);
-    for (int i = 0; i < argc; i++)
+    strcat((char *)g_buf, argv[0]);
+    strcat((char *)g_buf, " ");
+    for (int i = first; i < argc; i++)
     {
-        strcat(g_buf, argv[i]);
-        strcat(g_buf, " ");
+        strcat((char *)g_buf, argv[i]);
+        strcat((char *)g_buf, " ");
     }
     
     /* adjust the command */
-    g_len = strlen(g_buf);
-    if (strstr(g_buf, "./") != NULL)
+    g_len = strlen((char *)g_buf);
+    if (strstr((char *)g_buf, "./") != NULL)
     {
         g_len -= 2;
         p = g_buf + 2;
@@ -120,10 +505,12 @@ int main(uint8_t argc, char **argv)
     /* output */
     printf("ssd1306: send %s\n", p);
     
+    /* end the command */
+    p[g_len - 1] = '\n';
+    
     /* send data */
-    if (send(gs_sock_fd, p, g_len, 0) <0) 
+    if (a_client_send(p, g_len) != 0) 
     {
-        printf("ssd1306: send failed.\n");
         (void)close(gs_sock_fd);
 
         return 1;
@@ -34,26 +34,110 @@
  * </table>
  */
 
+#define _GNU_SOURCE
+
 #include "driver_ssd1306_basic.h"
 #include "driver_ssd1306_advance.h"
 #include "driver_ssd1306_display_test.h"
+#include "driver_ssd1306_flush_test.h"
+#include "driver_ssd1306_diff_test.h"
+#include "driver_ssd1306_async_test.h"
+#include "driver_ssd1306_dc_test.h"
+#include "driver_ssd1306_handoff_test.h"
+#include "driver_ssd1306_ring_test.h"
+#include "driver_ssd1306_batch_test.h"
+#include "driver_ssd1306_combine_test.h"
+#include "driver_ssd1306_bus_test.h"
+#include "driver_ssd1306_group_test.h"
+#include "driver_ssd1306_table_test.h"
+#include "driver_ssd1306_fill_test.h"
+#include "raspberrypi4b_driver_ssd1306_engine.h"
+#include "raspberrypi4b_driver_ssd1306_interface.h"
 #include "shell.h"
 #include <getopt.h>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/un.h>
 #include <netinet/in.h>
 #include <signal.h>
 #include <unistd.h>
 #include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+
+/**
+ * @brief server definition
+ */
+#define SERVER_MAX_CONN       16                 /**< max connections */
+#define SERVER_MAX_EVENTS     16                 /**< max events in one wait */
+#define SERVER_BUF_SIZE       8192               /**< connection buffer size */
+#define SERVER_LISTEN_TCP     0xFFFFFFFEU        /**< tcp listening socket tag */
+#define SERVER_LISTEN_UNIX    0xFFFFFFFFU        /**< unix listening socket tag */
+#define SERVER_FRAME_EVENT    0xFFFFFFFDU        /**< shared frame event tag */
+
+/**
+ * @brief binary message definition
+ * @note  magic(1) type(1) sequence(4, le) length(2, le) payload(length),
+ *        a full frame payload is 1024 bytes in page format,
+ *        a rect payload is left top right bottom and the packed bitmap,
+ *        a shared frame request has no payload
+ */
+#define SERVER_MSG_MAGIC      0xA5               /**< binary message magic, never starts a command */
+#define SERVER_MSG_FRAME      0x01               /**< full frame message */
+#define SERVER_MSG_RECT       0x02               /**< rect message */
+#define SERVER_MSG_SHM        0x03               /**< shared frame request message */
+#define SERVER_MSG_HEADER     8                  /**< message header length */
+#define SERVER_MSG_MAX        (4 + 1024)         /**< max payload length */
+
+/**
+ * @brief server message type definition
+ */
+#define SERVER_NEXT_WAIT      0                  /**< incomplete message */
+#define SERVER_NEXT_TEXT      1                  /**< text command */
+#define SERVER_NEXT_BINARY    2                  /**< binary message */
+#define SERVER_NEXT_INVALID   3                  /**< invalid binary message */
+
+/**
+ * @brief server connection structure definition
+ */
+typedef struct server_conn_s
+{
+    int fd;                            /**< socket handle */
+    uint16_t len;                      /**< buffered length */
+    uint8_t drop;                      /**< drop the rest of a too long command */
+    uint8_t seq_valid;                 /**< a message has been applied */
+    uint32_t seq;                      /**< last applied message sequence */
+    uint8_t buf[SERVER_BUF_SIZE];      /**< command buffer */
+} server_conn_t;
+
+/**
+ * @brief shared frame structure definition
+ * @note  a writer makes gen odd, writes the frame, makes gen even and then writes 1 to the eventfd,
+ *        only one writer may update the frame at a time
+ */
+typedef struct server_shm_s
+{
+    uint32_t gen;                      /**< frame generation, odd while the frame is written */
+    uint32_t reserved;                 /**< reserved */
+    uint8_t frame[1024];               /**< page format frame */
+} server_shm_t;
 
 /**
  * @brief global var definition
  */
-uint8_t g_buf[256];                              /**< uart buffer */
-volatile uint16_t g_len;                         /**< uart buffer length */
 static int gs_listen_fd;                         /**< network handle */
-static int gs_conn_fd;                           /**< network handle */
+static int gs_unix_fd = -1;                      /**< unix socket handle */
+static char *gs_unix_path = NULL;                /**< unix socket path */
+static int gs_epoll_fd;                          /**< epoll handle */
+static server_conn_t gs_conn[SERVER_MAX_CONN];   /**< connections */
 static struct sockaddr_in gs_server_addr;        /**< server address */
+static int gs_shm_fd = -1;                       /**< shared frame handle */
+static int gs_event_fd = -1;                     /**< frame ready event handle */
+static server_shm_t *gs_shm = NULL;              /**< shared frame */
+static uint32_t gs_shm_gen;                      /**< last flushed frame generation */
 
 /**
  * @brief     ssd1306 full function
@@ -93,6 +177,9 @@ uint8_t ssd1306(uint8_t argc, char** argv)
         {"y0", required_argument, NULL, 14},
         {"y1", required_argument, NULL, 15},
         {"y2", required_argument, NULL, 16},
+        {"device", required_argument, NULL, 17},
+        {"times", required_argument, NULL, 18},
+        {"spi-frequency", required_argument, NULL, 19},
         {NULL, 0, NULL, 0},
     };
     char type[33] = "unknown";
@@ -119,6 +206,9 @@ uint8_t ssd1306(uint8_t argc, char** argv)
     uint8_t y2_flag = 0;
     uint8_t color_flag = 0;
     char str[49] = "libdriver";
+    char device[4][32];
+    uint8_t device_num = 0;
+    uint32_t times = 100;
     
     /* if no params */
     if (argc == 1)
@@ -424,6 +514,42 @@ uint8_t ssd1306(uint8_t argc, char** argv)
                 break;
             }
             
+            /* device */
+            case 17 :
+            {
+                /* add the device */
+                if (device_num >= 4)
+                {
+                    return 5;
+                }
+                memset(device[device_num], 0, sizeof(char) * 32);
+                strncpy(device[device_num], optarg, 31);
+                device_num++;
+                
+                break;
+            }
+            
+            /* times */
+            case 18 :
+            {
+                /* set the times */
+                times = atol(optarg);
+                
+                break;
+            }
+            
+            /* spi frequency */
+            case 19 :
+            {
+                /* set the spi frequency */
+                if (ssd1306_interface_spi_set_frequency((uint32_t)atol(optarg)) != 0)
+                {
+                    return 5;
+                }
+                
+                break;
+            }
+            
             /* the end */
             case -1 :
             {
@@ -451,6 +577,150 @@ uint8_t ssd1306(uint8_t argc, char** argv)
             return 0;
         }
     }
+    else if (strcmp("t_flush", type) == 0)
+    {
+        /* run flush test */
+        if (ssd1306_flush_test(interface) != 0)
+        {
+            return 1;
+        }
+        else
+        {
+            return 0;
+        }
+    }
+    else if (strcmp("t_diff", type) == 0)
+    {
+        /* run diff test */
+        if (ssd1306_diff_test(interface) != 0)
+        {
+            return 1;
+        }
+        else
+        {
+            return 0;
+        }
+    }
+    else if (strcmp("t_async", type) == 0)
+    {
+        /* run async test */
+        if (ssd1306_async_test(interface) != 0)
+        {
+            return 1;
+        }
+        else
+        {
+            return 0;
+        }
+    }
+    else if (strcmp("t_dc", type) == 0)
+    {
+        /* run dc test */
+        if (ssd1306_dc_test() != 0)
+        {
+            return 1;
+        }
+        else
+        {
+            return 0;
+        }
+    }
+    else if (strcmp("t_handoff", type) == 0)
+    {
+        /* run handoff test */
+        if (ssd1306_handoff_test() != 0)
+        {
+            return 1;
+        }
+        else
+        {
+            return 0;
+        }
+    }
+    else if (strcmp("t_ring", type) == 0)
+    {
+        /* run ring test */
+        if (ssd1306_ring_test() != 0)
+        {
+            return 1;
+        }
+        else
+        {
+            return 0;
+        }
+    }
+    else if (strcmp("t_batch", type) == 0)
+    {
+        /* run batch test */
+        if (ssd1306_batch_test() != 0)
+        {
+            return 1;
+        }
+        else
+        {
+            return 0;
+        }
+    }
+    else if (strcmp("t_combine", type) == 0)
+    {
+        /* run combine test */
+        if (ssd1306_combine_test(interface) != 0)
+        {
+            return 1;
+        }
+        else
+        {
+            return 0;
+        }
+    }
+    else if (strcmp("t_bus", type) == 0)
+    {
+        /* run bus test */
+        if (ssd1306_bus_test() != 0)
+        {
+            return 1;
+        }
+        else
+        {
+            return 0;
+        }
+    }
+    else if (strcmp("t_group", type) == 0)
+    {
+        /* run group test */
+        if (ssd1306_group_test() != 0)
+        {
+            return 1;
+        }
+        else
+        {
+            return 0;
+        }
+    }
+    else if (strcmp("t_table", type) == 0)
+    {
+        /* run table test */
+        if (ssd1306_table_test(interface) != 0)
+        {
+            return 1;
+        }
+        else
+        {
+            return 0;
+        }
+    }
+    else if (strcmp("t_fill", type) == 0)
+    {
+        /* run fill test */
+        if (ssd1306_fill_test(interface) != 0)
+        {
+            return 1;
+        }
+        else
+        {
+            return 0;
+        }
+    }
     else if (strcmp("e_basic-str", type) == 0)
     {
         uint8_t res;
@@ -940,6 +1210,86 @@ uint8_t ssd1306(uint8_t argc, char** argv)
         
         return 0;
     }
+    else if (strcmp("e_engine", type) == 0)
+    {
+        uint8_t res;
+        uint8_t i;
+        uint8_t page;
+        uint32_t t;
+        uint8_t id[4];
+        uint8_t buf[1024];
+        ssd1306_bus_stats_t stats;
+        ssd1306_interface_t panel_interface;
+        
+        /* check the devices */
+        if (device_num == 0)
+        {
+            ssd1306_interface_debug_print("ssd1306: no device.\n");
+            
+            return 5;
+        }
+        
+        /* add the panels */
+        for (i = 0; i < device_num; i++)
+        {
+            panel_interface = (strncmp(device[i], "/dev/spidev", 11) == 0) ? SSD1306_INTERFACE_SPI : SSD1306_INTERFACE_IIC;
+            res = ssd1306_engine_add_panel(device[i], panel_interface, addr, &id[i]);
+            if (res != 0)
+            {
+                (void)ssd1306_engine_stop();
+                
+                return 1;
+            }
+        }
+        
+        /* start the workers */
+        res = ssd1306_engine_start();
+        if (res != 0)
+        {
+            return 1;
+        }
+        
+        /* move a bar across every panel */
+        for (t = 0; t < times; t++)
+        {
+            for (i = 0; i < device_num; i++)
+            {
+                memset(buf, 0, sizeof(uint8_t) * 1024);
+                for (page = 0; page < 8; page++)
+                {
+                    buf[page * 128 + (t + i * 32) % 128] = 0xFF;
+                }
+                res = ssd1306_engine_submit(id[i], buf);
+                if (res != 0)
+                {
+                    ssd1306_interface_debug_print("ssd1306: engine submit failed.\n");
+                    (void)ssd1306_engine_stop();
+                    
+                    return 1;
+                }
+            }
+            ssd1306_interface_delay_ms(20);
+        }
+        
+        /* output the statistics */
+        for (i = 0; i < device_num; i++)
+        {
+            (void)ssd1306_engine_get_stats(id[i], &stats);
+            ssd1306_interface_debug_print("ssd1306: %s bus sent %d bytes in %d transactions.\n", device[i], stats.bytes, stats.transactions);
+        }
+        
+        /* stop the workers */
+        res = ssd1306_engine_stop();
+        if (res != 0)
+        {
+            return 1;
+        }
+        
+        /* output */
+        ssd1306_interface_debug_print("ssd1306: engine ran %d frames on %d panels.\n", times, device_num);
+        
+        return 0;
+    }
     else if (strcmp("h", type) == 0)
     {
         help:
@@ -947,8 +1297,20 @@ uint8_t ssd1306(uint8_t argc, char** argv)
         ssd1306_interface_debug_print("  ssd1306 (-i | --information)\n");
         ssd1306_interface_debug_print("  ssd1306 (-h | --help)\n");
         ssd1306_interface_debug_print("  ssd1306 (-p | --port)\n");
-        ssd1306_interface_debug_print("  ssd1306 (-t display | --test=display) [--addr=<0 | 1>] [--interface=<iic | spi>]\n");
-        ssd1306_interface_debug_print("  ssd1306 (-e basic-init | --example=basic-init) [--addr=<0 | 1>] [--interface=<iic | spi>]\n");
+        ssd1306_interface_debug_print("  ssd1306 (-t display | --test=display) [--addr=<0 | 1>] [--interface=<iic | spi>] [--spi-frequency=<hz>]\n");
+        ssd1306_interface_debug_print("  ssd1306 (-t flush | --test=flush) [--interface=<iic | spi>]\n");
+        ssd1306_interface_debug_print("  ssd1306 (-t diff | --test=diff) [--interface=<iic | spi>]\n");
+        ssd1306_interface_debug_print("  ssd1306 (-t async | --test=async) [--interface=<iic | spi>]\n");
+        ssd1306_interface_debug_print("  ssd1306 (-t dc | --test=dc)\n");
+        ssd1306_interface_debug_print("  ssd1306 (-t handoff | --test=handoff)\n");
+        ssd1306_interface_debug_print("  ssd1306 (-t ring | --test=ring)\n");
+        ssd1306_interface_debug_print("  ssd1306 (-t batch | --test=batch)\n");
+        ssd1306_interface_debug_print("  ssd1306 (-t combine | --test=combine) [--interface=<iic | spi>]\n");
+        ssd1306_interface_debug_print("  ssd1306 (-t bus | --test=bus)\n");
+        ssd1306_interface_debug_print("  ssd1306 (-t group | --test=group)\n");
+        ssd1306_interface_debug_print("  ssd1306 (-t table | --test=table) [--interface=<iic | spi>]\n");
+        ssd1306_interface_debug_print("  ssd1306 (-t fill | --test=fill) [--interface=<iic | spi>]\n");
+        ssd1306_interface_debug_print("  ssd1306 (-e basic-init | --example=basic-init) [--addr=<0 | 1>] [--interface=<iic | spi>] [--spi-frequency=<hz>]\n");
         ssd1306_interface_debug_print("  ssd1306 (-e basic-deinit | --example=basic-deinit)\n");
         ssd1306_interface_debug_print("  ssd1306 (-e basic-str | --example=basic-str) [--str=<string>]\n");
         ssd1306_interface_debug_print("  ssd1306 (-e basic-display-on | --example=basic-display-on)\n");
@@ -956,7 +1318,7 @@ uint8_t ssd1306(uint8_t argc, char** argv)
         ssd1306_interface_debug_print("  ssd1306 (-e basic-clear | --example=basic-clear)\n");
         ssd1306_interface_debug_print("  ssd1306 (-e basic-point | --example=basic-point) --x0=<x0> --y0=<y0> [--color=<0 | 1>]\n");
         ssd1306_interface_debug_print("  ssd1306 (-e basic-rect | --example=basic-rect) --x1=<x1> --y1=<y1> --x2=<x2> --y2=<y2> [--color=<0 | 1>]\n");
-        ssd1306_interface_debug_print("  ssd1306 (-e advance-init | --example=advance-init) [--addr=<0 | 1>] [--interface=<iic | spi>]\n");
+        ssd1306_interface_debug_print("  ssd1306 (-e advance-init | --example=advance-init) [--addr=<0 | 1>] [--interface=<iic | spi>] [--spi-frequency=<hz>]\n");
         ssd1306_interface_debug_print("  ssd1306 (-e advance-deinit | --example=advance-deinit)\n");
         ssd1306_interface_debug_print("  ssd1306 (-e advance-str | --example=advance-str) [--str=<string>]\n");
         ssd1306_interface_debug_print("  ssd1306 (-e advance-display-on | --example=advance-display-on)\n");
@@ -973,14 +1335,16 @@ uint8_t ssd1306(uint8_t argc, char** argv)
         ssd1306_interface_debug_print("          [--frame=<FRAME_2 | FRAME_3 | FRAME_4 | FRAME_5 | FRAME_25 | FRAME_64 | FRAME_128 | FRAME_256>]\n");
         ssd1306_interface_debug_print("  ssd1306 (-e advance-right-scroll | --example=advance-right-scroll) [--start=<spage>] [--stop=<epage>] [--row=<r>]\n");
         ssd1306_interface_debug_print("          [--frame=<FRAME_2 | FRAME_3 | FRAME_4 | FRAME_5 | FRAME_25 | FRAME_64 | FRAME_128 | FRAME_256>]\n");
+        ssd1306_interface_debug_print("  ssd1306 (-e engine | --example=engine) --device=<path> [--device=<path>] [--addr=<0 | 1>] [--times=<n>] [--spi-frequency=<hz>]\n");
         ssd1306_interface_debug_print("\n");
         ssd1306_interface_debug_print("Options:\n");
         ssd1306_interface_debug_print("      --addr=<0 | 1>      Set the iic addr pin.([default: 0])\n");
         ssd1306_interface_debug_print("      --color=<0 | 1>     Set the chip color.([default: 1])\n");
+        ssd1306_interface_debug_print("      --device=<path>     Add a flush engine panel, /dev/spidev* is spi and the others are iic, up to 4.\n");
         ssd1306_interface_debug_print("  -e <basic-init | basic-deinit | basic-str | basic-display-on | basic-display-off | basic-clear \n");
         ssd1306_interface_debug_print("     | basic-point | basic-rect>, --example=<advance-init | advance-deinit | advance-str | advance-display-on\n");
         ssd1306_interface_debug_print("     | advance-display-off | advance-clear | advance-point | advance-rect | advance-enable-zoom | advance-disable-zoom\n");
-        ssd1306_interface_debug_print("     | advance-fade-blinking | advance-left-scroll | advance-right-scroll | advance-deactivate-scroll>\n");
+        ssd1306_interface_debug_print("     | advance-fade-blinking | advance-left-scroll | advance-right-scroll | advance-deactivate-scroll | engine>\n");
         ssd1306_interface_debug_print("                          Run the driver example.\n");
         ssd1306_interface_debug_print("      --frame=<FRAME_2 | FRAME_3 | FRAME_4 | FRAME_5 | FRAME_25 | FRAME_64 | FRAME_128 | FRAME_256>\n");
         ssd1306_interface_debug_print("                          Set the scrolling frame.([default: FRAME_2])\n");
@@ -995,9 +1359,12 @@ uint8_t ssd1306(uint8_t argc, char** argv)
         ssd1306_interface_debug_print("      --row=<r>           Set the scrolling row.([default: 0])\n");
         ssd1306_interface_debug_print("      --start=<spage>     Set the scrolling start page.([default: 0])\n");
         ssd1306_interface_debug_print("      --stop=<epage>      Set the scrolling stop page.([default: 7])\n");
+        ssd1306_interface_debug_print("      --spi-frequency=<hz>\n");
+        ssd1306_interface_debug_print("                          Set the spi clock of the devices opened next, 10MHz at most.([default: 1000000])\n");
         ssd1306_interface_debug_print("      --str=<string>      Set the display string.([default: libdriver])\n");
-        ssd1306_interface_debug_print("  -t <display>, --test=<display>\n");
-        ssd1306_interface_debug_print("                          Run the driver test.\n");
+        ssd1306_interface_debug_print("  -t <display | flush | diff | async | dc | handoff | ring | batch | combine | bus | group | table | fill>, --test=<display | flush | diff | async | dc | handoff | ring | batch | combine | bus | group | table | fill>\n");
+        ssd1306_interface_debug_print("                          Run the driver test, the tests except display run on an emulated panel.\n");
+        ssd1306_interface_debug_print("      --times=<n>         Set the engine frames.([default: 100])\n");
         ssd1306_interface_debug_print("      --x0=<x0>           Set the x0 and it is the x of the point.\n");
         ssd1306_interface_debug_print("      --x1=<x1>           Set the x1 and it is the top left x of the rect.\n");
         ssd1306_interface_debug_print("      --x2=<x2>           Set the x2 and it is the bottom right x of the rect.\n");
@@ -1057,7 +1424,7 @@ static uint8_t a_socket_init(void)
     int optval;
     
     /* creat a socket */
-    gs_listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    gs_listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
     if (gs_listen_fd < 0) 
     {
         ssd1306_interface_debug_print("ssd1306: create socket failed.\n");
@@ -1103,35 +1470,574 @@ static uint8_t a_socket_init(void)
 }
 
 /**
- * @brief     socket read
- * @param[in] *buf pointer to a buffer address
- * @param[in] len buffer length
+ * @brief     unix socket init
+ * @param[in] *path pointer to a socket path buffer
  * @return    status code
- *             - 0 success
- *             - 1 read failed
+ *            - 0 success
+ *            - 1 init failed
+ * @note      an old socket file at the path is removed
+ */
+static uint8_t a_socket_unix_init(char *path)
+{
+    struct sockaddr_un addr;
+    
+    /* check the path */
+    if (strlen(path) >= sizeof(addr.sun_path))
+    {
+        ssd1306_interface_debug_print("ssd1306: unix socket path is too long.\n");
+        
+        return 1;
+    }
+    
+    /* creat a socket */
+    gs_unix_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    if (gs_unix_fd < 0) 
+    {
+        ssd1306_interface_debug_print("ssd1306: create unix socket failed.\n");
+        
+        return 1;
+    }
+    
+    /* bind the path */
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+    (void)unlink(path);
+    if (bind(gs_unix_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) 
+    {
+        ssd1306_interface_debug_print("ssd1306: bind unix socket failed.\n");
+        (void)close(gs_unix_fd);
+        gs_unix_fd = -1;
+        
+        return 1;
+    }
+    
+    /* listen the path */
+    if (listen(gs_unix_fd, 10) < 0) 
+    {
+        ssd1306_interface_debug_print("ssd1306: listen unix socket failed.\n");
+        (void)close(gs_unix_fd);
+        (void)unlink(path);
+        gs_unix_fd = -1;
+        
+        return 1;
+    }
+    gs_unix_path = path;
+    
+    return 0;
+}
+
+/**
+ * @brief  shared frame init
+ * @return status code
+ *         - 0 success
+ *         - 1 init failed
+ * @note   none
+ */
+static uint8_t a_shm_init(void)
+{
+    /* create the shared frame */
+    gs_shm_fd = memfd_create("ssd1306", MFD_CLOEXEC);
+    if (gs_shm_fd < 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: create shared frame failed.\n");
+        
+        return 1;
+    }
+    if (ftruncate(gs_shm_fd, sizeof(server_shm_t)) < 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: resize shared frame failed.\n");
+        (void)close(gs_shm_fd);
+        gs_shm_fd = -1;
+        
+        return 1;
+    }
+    gs_shm = (server_shm_t *)mmap(NULL, sizeof(server_shm_t), PROT_READ | PROT_WRITE, MAP_SHARED, gs_shm_fd, 0);
+    if (gs_shm == MAP_FAILED)
+    {
+        ssd1306_interface_debug_print("ssd1306: map shared frame failed.\n");
+        (void)close(gs_shm_fd);
+        gs_shm_fd = -1;
+        gs_shm = NULL;
+        
+        return 1;
+    }
+    
+    /* create the frame ready event */
+    gs_event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (gs_event_fd < 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: create event failed.\n");
+        (void)munmap(gs_shm, sizeof(server_shm_t));
+        (void)close(gs_shm_fd);
+        gs_shm_fd = -1;
+        gs_shm = NULL;
+        
+        return 1;
+    }
+    gs_shm_gen = 0;
+    
+    return 0;
+}
+
+/**
+ * @brief     send the shared frame handles to a connection
+ * @param[in] *conn pointer to a connection structure
+ * @note      the memfd and the eventfd are passed with SCM_RIGHTS, so only a unix socket works
+ */
+static void a_shm_send(server_conn_t *conn)
+{
+    int fds[2];
+    uint8_t ok;
+    struct iovec iov;
+    struct msghdr msg;
+    struct cmsghdr *cmsg;
+    union
+    {
+        char buf[CMSG_SPACE(sizeof(fds))];
+        struct cmsghdr align;
+    } ctrl;
+    
+    if (gs_shm == NULL)
+    {
+        ssd1306_interface_debug_print("ssd1306: shared frame is not available.\n");
+        
+        return;
+    }
+    
+    /* set the message */
+    ok = SERVER_MSG_SHM;
+    iov.iov_base = &ok;
+    iov.iov_len = 1;
+    memset(&msg, 0, sizeof(msg));
+    memset(&ctrl, 0, sizeof(ctrl));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = ctrl.buf;
+    msg.msg_controllen = sizeof(ctrl.buf);
+    
+    /* attach the handles */
+    fds[0] = gs_shm_fd;
+    fds[1] = gs_event_fd;
+    cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+    if (sendmsg(conn->fd, &msg, 0) != 1)
+    {
+        ssd1306_interface_debug_print("ssd1306: send shared frame failed.\n");
+    }
+}
+
+/**
+ * @brief  read the shared frame and flush it
+ * @note   a torn or already flushed frame is skipped, the writer signals again after its frame
+ */
+static void a_shm_read(void)
+{
+    uint64_t count;
+    uint32_t gen;
+    uint8_t frame[1024];
+    
+    /* clear the event */
+    if (read(gs_event_fd, &count, sizeof(count)) != sizeof(count))
+    {
+        return;
+    }
+    
+    /* copy a stable frame */
+    gen = __atomic_load_n(&gs_shm->gen, __ATOMIC_ACQUIRE);
+    if (((gen & 1) != 0) || (gen == gs_shm_gen))
+    {
+        return;
+    }
+    memcpy(frame, gs_shm->frame, sizeof(frame));
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (__atomic_load_n(&gs_shm->gen, __ATOMIC_RELAXED) != gen)
+    {
+        return;
+    }
+    gs_shm_gen = gen;
+    
+    /* flush the frame */
+    if (ssd1306_basic_frame(frame) != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: write frame failed.\n");
+    }
+}
+
+/**
+ * @brief     run one shell command
+ * @param[in] *buf pointer to a command buffer
+ * @param[in] len command length
  * @note      none
  */
-static uint16_t a_socket_read(uint8_t *buf, uint16_t len)
+static void a_shell_run(char *buf, uint16_t len)
 {
-    int n;
+    uint8_t res;
+    
+    /* run shell */
+    res = shell_parse(buf, len);
+    if (res == 0)
+    {
+        /* run success */
+    }
+    else if (res == 1)
+    {
+        ssd1306_interface_debug_print("ssd1306: run failed.\n");
+    }
+    else if (res == 2)
+    {
+        ssd1306_interface_debug_print("ssd1306: unknown command.\n");
+    }
+    else if (res == 3)
+    {
+        ssd1306_interface_debug_print("ssd1306: length is too long.\n");
+    }
+    else if (res == 4)
+    {
+        ssd1306_interface_debug_print("ssd1306: pretreat failed.\n");
+    }
+    else if (res == 5)
+    {
+        ssd1306_interface_debug_print("ssd1306: param is invalid.\n");
+    }
+    else
+    {
+        ssd1306_interface_debug_print("ssd1306: unknown status code.\n");
+    }
+}
+
+/**
+ * @brief     accept the new connections
+ * @param[in] listen_fd listening socket handle
+ * @note      a connection over SERVER_MAX_CONN is closed at once
+ */
+static void a_server_accept(int listen_fd)
+{
+    int fd;
+    uint32_t i;
+    struct epoll_event ev;
+    
+    while (1)
+    {
+        /* accept one connection */
+        fd = accept(listen_fd, (struct sockaddr *)NULL, NULL);
+        if (fd < 0)
+        {
+            return;
+        }
+        (void)fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        
+        /* find a free slot */
+        for (i = 0; i < SERVER_MAX_CONN; i++)
+        {
+            if (gs_conn[i].fd < 0)
+            {
+                break;
+            }
+        }
+        if (i == SERVER_MAX_CONN)
+        {
+            ssd1306_interface_debug_print("ssd1306: too many connections.\n");
+            (void)close(fd);
+            
+            continue;
+        }
+        
+        /* watch the connection */
+        ev.events = EPOLLIN;
+        ev.data.u32 = i;
+        if (epoll_ctl(gs_epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0)
+        {
+            ssd1306_interface_debug_print("ssd1306: epoll add failed.\n");
+            (void)close(fd);
+            
+            continue;
+        }
+        gs_conn[i].fd = fd;
+        gs_conn[i].len = 0;
+        gs_conn[i].drop = 0;
+        gs_conn[i].seq_valid = 0;
+    }
+}
+
+/**
+ * @brief     close a connection
+ * @param[in] *conn pointer to a connection structure
+ * @note      none
+ */
+static void a_server_close(server_conn_t *conn)
+{
+    (void)epoll_ctl(gs_epoll_fd, EPOLL_CTL_DEL, conn->fd, NULL);
+    (void)close(conn->fd);
+    conn->fd = -1;
+    conn->len = 0;
+}
+
+/**
+ * @brief      find the next message of a connection
+ * @param[in]  *conn pointer to a connection structure
+ * @param[in]  start message start
+ * @param[out] *end pointer to a message end buffer
+ * @return     message type
+ * @note       a text command ends with '\n', a binary message starts with SERVER_MSG_MAGIC
+ */
+static uint8_t a_server_next(server_conn_t *conn, uint16_t start, uint16_t *end)
+{
+    uint16_t i;
+    uint16_t len;
+    
+    /* text command */
+    if ((conn->drop != 0) || (conn->buf[start] != SERVER_MSG_MAGIC))
+    {
+        for (i = start; i < conn->len; i++)
+        {
+            if (conn->buf[i] == '\n')
+            {
+                *end = (uint16_t)(i + 1);
+                
+                return SERVER_NEXT_TEXT;
+            }
+        }
+        
+        return SERVER_NEXT_WAIT;
+    }
+    
+    /* check the header */
+    if ((conn->len - start) < SERVER_MSG_HEADER)
+    {
+        return SERVER_NEXT_WAIT;
+    }
+    len = (uint16_t)(conn->buf[start + 6] | (conn->buf[start + 7] << 8));
+    if (conn->buf[start + 1] == SERVER_MSG_FRAME)
+    {
+        if (len != 1024)
+        {
+            return SERVER_NEXT_INVALID;
+        }
+    }
+    else if (conn->buf[start + 1] == SERVER_MSG_RECT)
+    {
+        if ((len < 4) || (len > SERVER_MSG_MAX))
+        {
+            return SERVER_NEXT_INVALID;
+        }
+    }
+    else if (conn->buf[start + 1] == SERVER_MSG_SHM)
+    {
+        if (len != 0)
+        {
+            return SERVER_NEXT_INVALID;
+        }
+    }
+    else
+    {
+        return SERVER_NEXT_INVALID;
+    }
     
-    /* wait data */
-    gs_conn_fd = accept(gs_listen_fd, (struct sockaddr *)NULL, NULL);
-    if (gs_conn_fd < 0) 
+    /* check the payload */
+    if ((conn->len - start) < (SERVER_MSG_HEADER + len))
     {
-        ssd1306_interface_debug_print("ssd1306: accept failed.\n");
-        (void)close(gs_conn_fd);
+        return SERVER_NEXT_WAIT;
+    }
+    *end = (uint16_t)(start + SERVER_MSG_HEADER + len);
+    
+    return SERVER_NEXT_BINARY;
+}
 
+/**
+ * @brief     get the sequence of a binary message
+ * @param[in] *msg pointer to a message buffer
+ * @return    message sequence
+ * @note      none
+ */
+static uint32_t a_server_seq(uint8_t *msg)
+{
+    return (uint32_t)msg[2] | ((uint32_t)msg[3] << 8) | 
+           ((uint32_t)msg[4] << 16) | ((uint32_t)msg[5] << 24);
+}
+
+/**
+ * @brief     check if a sequence is newer than the last applied one
+ * @param[in] *conn pointer to a connection structure
+ * @param[in] seq message sequence
+ * @return    1 if newer, else 0
+ * @note      the sequence may wrap around
+ */
+static uint8_t a_server_newer(server_conn_t *conn, uint32_t seq)
+{
+    if (conn->seq_valid == 0)
+    {
         return 1;
     }
     
-    /* read data */
-    n = recv(gs_conn_fd, buf, len, 0);
+    return (int32_t)(seq - conn->seq) > 0 ? 1 : 0;
+}
+
+/**
+ * @brief     apply a binary message
+ * @param[in] *conn pointer to a connection structure
+ * @param[in] *msg pointer to a message buffer
+ * @param[in] len message length
+ * @note      a message not newer than the last applied one is dropped
+ */
+static void a_server_apply(server_conn_t *conn, uint8_t *msg, uint16_t len)
+{
+    uint8_t *p;
+    uint32_t seq;
+    
+    /* drop the stale message */
+    seq = a_server_seq(msg);
+    if (a_server_newer(conn, seq) == 0)
+    {
+        return;
+    }
+    conn->seq_valid = 1;
+    conn->seq = seq;
+    p = &msg[SERVER_MSG_HEADER];
+    len = (uint16_t)(len - SERVER_MSG_HEADER);
     
-    /* close the socket */
-    (void)close(gs_conn_fd);
+    /* full frame */
+    if (msg[1] == SERVER_MSG_FRAME)
+    {
+        if (ssd1306_basic_frame(p) != 0)
+        {
+            ssd1306_interface_debug_print("ssd1306: write frame failed.\n");
+        }
+        
+        return;
+    }
     
-    return n;
+    /* rect */
+    if ((p[2] < p[0]) || (p[3] < p[1]) ||
+        (len != (4 + ((p[2] - p[0] + 8) / 8) * (p[3] - p[1] + 1))))
+    {
+        ssd1306_interface_debug_print("ssd1306: rect is invalid.\n");
+        
+        return;
+    }
+    if (ssd1306_basic_bitmap(p[0], p[1], p[2], p[3], &p[4]) != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: draw rect failed.\n");
+    }
+}
+
+/**
+ * @brief     read a connection and run the complete messages
+ * @param[in] *conn pointer to a connection structure
+ * @note      commands end with '\n', the rest of the buffer runs when the peer closes,
+ *            the binary messages before the last newer full frame are skipped
+ */
+static void a_server_read(server_conn_t *conn)
+{
+    ssize_t n;
+    uint8_t type;
+    uint16_t start;
+    uint16_t end;
+    uint16_t last;
+    
+    while (1)
+    {
+        /* read data */
+        n = recv(conn->fd, &conn->buf[conn->len], SERVER_BUF_SIZE - conn->len, 0);
+        if (n < 0)
+        {
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK))
+            {
+                a_server_close(conn);
+            }
+            
+            return;
+        }
+        if (n == 0)
+        {
+            /* run the last command without '\n' */
+            if ((conn->len != 0) && (conn->drop == 0) && (conn->buf[0] != SERVER_MSG_MAGIC))
+            {
+                a_shell_run((char *)conn->buf, conn->len);
+            }
+            a_server_close(conn);
+            
+            return;
+        }
+        conn->len += (uint16_t)n;
+        
+        /* find the last newer full frame */
+        last = 0;
+        start = 0;
+        while (start < conn->len)
+        {
+            type = a_server_next(conn, start, &end);
+            if ((type == SERVER_NEXT_WAIT) || (type == SERVER_NEXT_INVALID))
+            {
+                break;
+            }
+            if ((type == SERVER_NEXT_BINARY) && (conn->buf[start + 1] == SERVER_MSG_FRAME) &&
+                (a_server_newer(conn, a_server_seq(&conn->buf[start])) != 0))
+            {
+                last = start;
+            }
+            start = end;
+        }
+        
+        /* run all complete messages */
+        start = 0;
+        while (start < conn->len)
+        {
+            type = a_server_next(conn, start, &end);
+            if (type == SERVER_NEXT_WAIT)
+            {
+                break;
+            }
+            else if (type == SERVER_NEXT_INVALID)
+            {
+                ssd1306_interface_debug_print("ssd1306: message is invalid.\n");
+                a_server_close(conn);
+                
+                return;
+            }
+            else if (type == SERVER_NEXT_TEXT)
+            {
+                if ((end - 1 > start) && (conn->drop == 0))
+                {
+                    a_shell_run((char *)&conn->buf[start], (uint16_t)(end - 1 - start));
+                }
+                conn->drop = 0;
+            }
+            else if (conn->buf[start + 1] == SERVER_MSG_SHM)
+            {
+                a_shm_send(conn);
+            }
+            else if (start >= last)
+            {
+                a_server_apply(conn, &conn->buf[start], (uint16_t)(end - start));
+            }
+            else
+            {
+                /* superseded by the last full frame */
+            }
+            start = end;
+        }
+        
+        /* keep the incomplete message */
+        if (start != 0)
+        {
+            memmove(conn->buf, &conn->buf[start], conn->len - start);
+            conn->len = (uint16_t)(conn->len - start);
+        }
+        else if (conn->len == SERVER_BUF_SIZE)
+        {
+            ssd1306_interface_debug_print("ssd1306: length is too long.\n");
+            conn->len = 0;
+            conn->drop = 1;
+        }
+        else
+        {
+            /* wait for more data */
+        }
+    }
 }
 
 /**
@@ -1145,6 +2051,11 @@ static void a_sig_handler(int signum)
     {
         ssd1306_interface_debug_print("ssd1306: close the server.\n");
         (void)close(gs_listen_fd);
+        if (gs_unix_path != NULL)
+        {
+            (void)close(gs_unix_fd);
+            (void)unlink(gs_unix_path);
+        }
         exit(0);
     }
     
@@ -1152,12 +2063,21 @@ static void a_sig_handler(int signum)
 }
 
 /**
- * @brief main function
- * @note  none
+ * @brief     main function
+ * @param[in] argc arg numbers
+ * @param[in] **argv arg address
+ * @return    status code
+ *            - 0 success
+ *            - 1 run failed
+ * @note      ssd1306_server [--unix=<path>]
  */
-int main(void)
+int main(int argc, char **argv)
 {
+    int i;
+    int n;
     uint8_t res;
+    struct epoll_event ev;
+    struct epoll_event events[SERVER_MAX_EVENTS];
     
     /* socket init*/
     res = a_socket_init();
@@ -1168,6 +2088,52 @@ int main(void)
         return 1;
     }
     
+    /* unix socket init */
+    for (i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--unix=", 7) == 0)
+        {
+            res = a_socket_unix_init(&argv[i][7]);
+            if (res != 0)
+            {
+                (void)close(gs_listen_fd);
+                
+                return 1;
+            }
+        }
+    }
+    
+    /* epoll init */
+    gs_epoll_fd = epoll_create1(0);
+    if (gs_epoll_fd < 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: epoll init failed.\n");
+        (void)close(gs_listen_fd);
+        
+        return 1;
+    }
+    for (i = 0; i < SERVER_MAX_CONN; i++)
+    {
+        gs_conn[i].fd = -1;
+    }
+    ev.events = EPOLLIN;
+    ev.data.u32 = SERVER_LISTEN_TCP;
+    (void)epoll_ctl(gs_epoll_fd, EPOLL_CTL_ADD, gs_listen_fd, &ev);
+    if (gs_unix_fd >= 0)
+    {
+        ev.events = EPOLLIN;
+        ev.data.u32 = SERVER_LISTEN_UNIX;
+        (void)epoll_ctl(gs_epoll_fd, EPOLL_CTL_ADD, gs_unix_fd, &ev);
+    }
+    
+    /* shared frame init */
+    if (a_shm_init() == 0)
+    {
+        ev.events = EPOLLIN;
+        ev.data.u32 = SERVER_FRAME_EVENT;
+        (void)epoll_ctl(gs_epoll_fd, EPOLL_CTL_ADD, gs_event_fd, &ev);
+    }
+    
     /* shell init && register ssd1306 function */
     shell_init();
     shell_register("ssd1306", ssd1306);
@@ -1175,42 +2141,45 @@ int main(void)
     
     /* set the signal */
     signal(SIGINT, a_sig_handler);
+    signal(SIGPIPE, SIG_IGN);
     
     while (1)
     {
-        /* read uart */
-        g_len = a_socket_read(g_buf, 256);
-        if (g_len != 0)
+        /* wait events */
+        n = epoll_wait(gs_epoll_fd, events, SERVER_MAX_EVENTS, -1);
+        if (n < 0)
         {
-            /* run shell */
-            res = shell_parse((char *)g_buf, g_len);
-            if (res == 0)
+            if (errno == EINTR)
             {
-                /* run success */
+                continue;
             }
-            else if (res == 1)
-            {
-                ssd1306_interface_debug_print("ssd1306: run failed.\n");
-            }
-            else if (res == 2)
+            ssd1306_interface_debug_print("ssd1306: epoll wait failed.\n");
+            
+            return 1;
+        }
+        
+        /* handle events */
+        for (i = 0; i < n; i++)
+        {
+            if (events[i].data.u32 == SERVER_LISTEN_TCP)
             {
-                ssd1306_interface_debug_print("ssd1306: unknown command.\n");
+                a_server_accept(gs_listen_fd);
             }
-            else if (res == 3)
+            else if (events[i].data.u32 == SERVER_LISTEN_UNIX)
             {
-                ssd1306_interface_debug_print("ssd1306: length is too long.\n");
+                a_server_accept(gs_unix_fd);
             }
-            else if (res == 4)
+            else if (events[i].data.u32 == SERVER_FRAME_EVENT)
             {
-                ssd1306_interface_debug_print("ssd1306: pretreat failed.\n");
+                a_shm_read();
             }
-            else if (res == 5)
+            else if (gs_conn[events[i].data.u32].fd >= 0)
             {
-                ssd1306_interface_debug_print("ssd1306: param is invalid.\n");
+                a_server_read(&gs_conn[events[i].data.u32]);
             }
             else
             {
-                ssd1306_interface_debug_print("ssd1306: unknown status code.\n");
+                /* closed in this round */
             }
         }
     }
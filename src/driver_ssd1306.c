@@ -56,6 +56,40 @@
 #define SSD1306_CMD          0        /**< command */
 #define SSD1306_DATA         1        /**< data */
 
+/**
+ * @brief chip panel cursor definition
+ */
+#define SSD1306_CURSOR_PAGE           (1 << 0)        /**< page is known */
+#define SSD1306_CURSOR_COLUMN_LOW     (1 << 1)        /**< lower column is known */
+#define SSD1306_CURSOR_COLUMN_HIGH    (1 << 2)        /**< higher column is known */
+#define SSD1306_CURSOR_COLUMN         0x06            /**< column is known */
+#define SSD1306_CURSOR_VALID          0x07            /**< cursor is known */
+#define SSD1306_WINDOW_COLUMN         (1 << 0)        /**< column range is known */
+#define SSD1306_WINDOW_PAGE           (1 << 1)        /**< page range is known */
+#define SSD1306_WINDOW_VALID          0x03            /**< window is known */
+
+/**
+ * @brief frame hand-off state definition
+ */
+#define SSD1306_HANDOFF_INDEX    0x03        /**< published frame index */
+#define SSD1306_HANDOFF_FRESH    0x04        /**< the published frame is not consumed */
+
+/**
+ * @brief chip flush job stage definition
+ */
+#define SSD1306_JOB_STAGE_ADDRESS        0        /**< address the next span */
+#define SSD1306_JOB_STAGE_DATA           1        /**< send the span data */
+
+/**
+ * @brief chip default cost model definition, the unit is one bus bit time
+ */
+#define SSD1306_IIC_DEFAULT_TRANSACTION_COST        40        /**< start, address, control byte, stop and call overhead */
+#define SSD1306_IIC_DEFAULT_BYTE_COST               9         /**< 8 bits and ack */
+#define SSD1306_IIC_DEFAULT_DC_SWITCH_COST          0         /**< no command data line */
+#define SSD1306_SPI_DEFAULT_TRANSACTION_COST        8         /**< call and chip select overhead */
+#define SSD1306_SPI_DEFAULT_BYTE_COST               8         /**< 8 bits */
+#define SSD1306_SPI_DEFAULT_DC_SWITCH_COST          8         /**< gpio write */
+
 /**
  * @brief chip command definition
  */
@@ -96,69 +130,452 @@
 #define SSD1306_CMD_NOP                                     0xE3        /**< command nop */ 
 
 /**
- * @brief     write one byte
+ * @brief     forget what the panel ram holds
  * @param[in] *handle pointer to an ssd1306 handle structure
- * @param[in] data written data
- * @param[in] cmd command or data type
- * @return    status code
- *            - 0 success
- *            - 1 write failed
+ * @note      the whole gram becomes dirty and the shadow is dropped
+ */
+static void a_ssd1306_panel_invalidate(ssd1306_handle_t *handle)
+{
+    uint8_t i;
+    
+    for (i = 0; i < 8; i++)                                     /* all pages */
+    {
+        handle->dirty_column_min[i] = 0;                        /* set min column */
+        handle->dirty_column_max[i] = 127;                      /* set max column */
+    }
+    handle->dirty_page = 0xFF;                                  /* set all pages dirty */
+#if (SSD1306_SHADOW_ENABLE != 0)
+    handle->shadow_valid = 0;                                   /* drop the shadow */
+#endif
+}
+
+/**
+ * @brief     get the argument count of a command
+ * @param[in] cmd command
+ * @return    argument count
  * @note      none
  */
-static uint8_t a_ssd1306_write_byte(ssd1306_handle_t *handle, uint8_t data, uint8_t cmd)
+static uint8_t a_ssd1306_cmd_args(uint8_t cmd)
 {
-    uint8_t res;
+    if ((cmd == SSD1306_CMD_RIGHT_HORIZONTAL_SCROLL) || (cmd == SSD1306_CMD_LEFT_HORIZONTAL_SCROLL))                    /* if horizontal scroll */
+    {
+        return 6;                                                                                                      /* 6 arguments */
+    }
+    if ((cmd == SSD1306_CMD_VERTICAL_RIGHT_HORIZONTAL_SCROLL) || (cmd == SSD1306_CMD_VERTICAL_LEFT_HORIZONTAL_SCROLL))  /* if vertical scroll */
+    {
+        return 5;                                                                                                      /* 5 arguments */
+    }
+    if ((cmd == SSD1306_CMD_SET_COLUMN_ADDRESS) || (cmd == SSD1306_CMD_SET_PAGE_ADDRESS) || 
+        (cmd == SSD1306_CMD_VERTICAL_SCROLL_AREA))                                                                     /* if range */
+    {
+        return 2;                                                                                                      /* 2 arguments */
+    }
+    if ((cmd == SSD1306_CMD_MEMORY_ADDRESSING_MODE) || (cmd == SSD1306_CMD_SET_FADE_OUT_AND_BLINKING) || 
+        (cmd == SSD1306_CMD_CONTRAST_CONTROL) || (cmd == SSD1306_CMD_CHARGE_PUMP_SETTING) || 
+        (cmd == SSD1306_CMD_MULTIPLEX_RATIO) || (cmd == SSD1306_CMD_DISPLAY_OFFSET) || 
+        (cmd == SSD1306_CMD_DISPLAY_CLOCK_DIVIDE) || (cmd == SSD1306_CMD_SET_ZOOM_IN) || 
+        (cmd == SSD1306_CMD_PRE_CHARGE_PERIOD) || (cmd == SSD1306_CMD_COM_PINS_CONF) || 
+        (cmd == SSD1306_CMD_COMH_DESELECT_LEVEL))                                                                      /* if one argument */
+    {
+        return 1;                                                                                                      /* 1 argument */
+    }
+    
+    return 0;                                                                                                          /* no argument */
+}
+
+/**
+ * @brief     forget the panel addressing state
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @note      none
+ */
+static void a_ssd1306_address_forget(ssd1306_handle_t *handle)
+{
+    handle->addressing_mode = 0xFF;                                                         /* the mode is unknown */
+    handle->cursor_valid = 0;                                                               /* the cursor is unknown */
+    handle->window_valid = 0;                                                               /* the window is unknown */
+}
+
+/**
+ * @brief     advance the panel cursor after data bytes
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] len data length
+ * @note      the cursor moves the way the controller auto increments
+ */
+static void a_ssd1306_cursor_advance(ssd1306_handle_t *handle, uint16_t len)
+{
+    uint16_t w;
+    uint16_t h;
+    uint32_t pos;
+    
+    if (handle->cursor_valid != SSD1306_CURSOR_VALID)                                       /* if the cursor is unknown */
+    {
+        return;                                                                             /* nothing to track */
+    }
+    if (handle->addressing_mode == SSD1306_MEMORY_ADDRESSING_MODE_PAGE)                     /* if page mode */
+    {
+        if (((uint16_t)handle->cursor_column + len) > 127)                                  /* if the column wraps */
+        {
+            handle->cursor_valid = SSD1306_CURSOR_PAGE;                                     /* the column is unknown */
+        }
+        else
+        {
+            handle->cursor_column = (uint8_t)(handle->cursor_column + len);                 /* next column */
+        }
+        
+        return;                                                                             /* done */
+    }
+    if ((handle->window_valid != SSD1306_WINDOW_VALID) || 
+        (handle->window_column_end < handle->window_column_start) || 
+        (handle->window_page_end < handle->window_page_start) || 
+        (handle->cursor_column < handle->window_column_start) || 
+        (handle->cursor_column > handle->window_column_end) || 
+        (handle->cursor_page < handle->window_page_start) || 
+        (handle->cursor_page > handle->window_page_end))                                    /* if out of the window */
+    {
+        handle->cursor_valid = 0;                                                           /* the cursor is unknown */
+        
+        return;                                                                             /* done */
+    }
+    w = (uint16_t)(handle->window_column_end - handle->window_column_start + 1);            /* get width */
+    h = (uint16_t)(handle->window_page_end - handle->window_page_start + 1);                /* get height */
+    if (handle->addressing_mode == SSD1306_MEMORY_ADDRESSING_MODE_VERTICAL)                 /* if vertical mode */
+    {
+        pos = (uint32_t)(handle->cursor_column - handle->window_column_start) * h + 
+              (handle->cursor_page - handle->window_page_start);                            /* get position */
+        pos = (pos + len) % ((uint32_t)w * h);                                              /* advance */
+        handle->cursor_column = (uint8_t)(handle->window_column_start + pos / h);           /* set column */
+        handle->cursor_page = (uint8_t)(handle->window_page_start + pos % h);               /* set page */
+    }
+    else if (handle->addressing_mode == SSD1306_MEMORY_ADDRESSING_MODE_HORIZONTAL)          /* if horizontal mode */
+    {
+        pos = (uint32_t)(handle->cursor_page - handle->window_page_start) * w + 
+              (handle->cursor_column - handle->window_column_start);                        /* get position */
+        pos = (pos + len) % ((uint32_t)w * h);                                              /* advance */
+        handle->cursor_page = (uint8_t)(handle->window_page_start + pos / w);               /* set page */
+        handle->cursor_column = (uint8_t)(handle->window_column_start + pos % w);           /* set column */
+    }
+    else
+    {
+        handle->cursor_valid = 0;                                                           /* the cursor is unknown */
+    }
+}
+
+/**
+ * @brief     track the panel addressing state of a write
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] *buf pointer to a written buffer
+ * @param[in] len buffer length
+ * @param[in] cmd command or data type
+ * @note      a command split across writes makes the state unknown
+ */
+static void a_ssd1306_track(ssd1306_handle_t *handle, const uint8_t *buf, uint16_t len, uint8_t cmd)
+{
+    uint8_t c;
+    uint8_t args;
+    uint8_t mode;
+    uint16_t i;
     
-    if (handle->iic_spi == SSD1306_INTERFACE_IIC)                              /* if iic */
+    if (cmd != SSD1306_CMD)                                                                 /* if data */
     {
-        if (cmd != 0)                                                          /* if data */
+        a_ssd1306_cursor_advance(handle, len);                                              /* advance the cursor */
+        
+        return;                                                                             /* done */
+    }
+    i = 0;                                                                                  /* init index */
+    while ((handle->cmd_args_left != 0) && (i < len))                                       /* skip the split arguments */
+    {
+        handle->cmd_args_left--;                                                            /* one argument */
+        i++;                                                                                /* next */
+    }
+    mode = handle->addressing_mode;                                                         /* get the mode */
+    while (i < len)                                                                         /* all commands */
+    {
+        c = buf[i];                                                                         /* get the command */
+        args = a_ssd1306_cmd_args(c);                                                       /* get the arguments */
+        if ((i + args) >= len)                                                              /* if the command is split */
+        {
+            handle->cmd_args_left = (uint8_t)(i + args + 1 - len);                          /* save the left arguments */
+            a_ssd1306_address_forget(handle);                                               /* the state is unknown */
+            
+            return;                                                                         /* done */
+        }
+        if (c == SSD1306_CMD_MEMORY_ADDRESSING_MODE)                                        /* if addressing mode */
         {
-            if (handle->iic_write(handle->iic_addr, 0x40, &data, 1) != 0)      /* write data */
+            if ((buf[i + 1] & 0x03) != mode)                                                /* if the mode changes */
             {
-                return 1;                                                      /* return error */
+                mode = buf[i + 1] & 0x03;                                                   /* set the mode */
+                handle->addressing_mode = mode;                                             /* save the mode */
+                handle->cursor_valid = 0;                                                   /* the cursor is unknown */
             }
-            else
+        }
+        else if (c == SSD1306_CMD_SET_COLUMN_ADDRESS)                                       /* if column range */
+        {
+            handle->window_column_start = buf[i + 1] & 0x7F;                                /* set start column */
+            handle->window_column_end = buf[i + 2] & 0x7F;                                  /* set end column */
+            handle->window_valid |= SSD1306_WINDOW_COLUMN;                                  /* the columns are known */
+            handle->cursor_column = handle->window_column_start;                            /* reset the column */
+            handle->cursor_valid |= SSD1306_CURSOR_COLUMN;                                  /* the column is known */
+            if (mode == SSD1306_MEMORY_ADDRESSING_MODE_PAGE)                                /* if page mode */
             {
-                return 0;                                                      /* success return 0 */
+                handle->cursor_valid &= (uint8_t)(~SSD1306_CURSOR_COLUMN);                  /* only for the window modes */
             }
         }
-        else
+        else if (c == SSD1306_CMD_SET_PAGE_ADDRESS)                                         /* if page range */
         {
-            if (handle->iic_write(handle->iic_addr, 0x00, &data, 1) != 0)      /* write command */
+            handle->window_page_start = buf[i + 1] & 0x07;                                  /* set start page */
+            handle->window_page_end = buf[i + 2] & 0x07;                                    /* set end page */
+            handle->window_valid |= SSD1306_WINDOW_PAGE;                                    /* the pages are known */
+            handle->cursor_page = handle->window_page_start;                                /* reset the page */
+            handle->cursor_valid |= SSD1306_CURSOR_PAGE;                                    /* the page is known */
+            if (mode == SSD1306_MEMORY_ADDRESSING_MODE_PAGE)                                /* if page mode */
             {
-                return 1;                                                      /* return error */
+                handle->cursor_valid &= (uint8_t)(~SSD1306_CURSOR_PAGE);                    /* only for the window modes */
             }
-            else
+        }
+        else if ((c >= SSD1306_CMD_PAGE_ADDR) && (c <= (SSD1306_CMD_PAGE_ADDR + 7)))        /* if page */
+        {
+            handle->cursor_page = c & 0x07;                                                 /* set page */
+            handle->cursor_valid |= SSD1306_CURSOR_PAGE;                                    /* the page is known */
+            if (mode != SSD1306_MEMORY_ADDRESSING_MODE_PAGE)                                /* if not page mode */
             {
-                return 0;                                                      /* success return 0 */
+                handle->cursor_valid &= (uint8_t)(~SSD1306_CURSOR_PAGE);                    /* only for page mode */
             }
         }
-    }
-    else if (handle->iic_spi == SSD1306_INTERFACE_SPI)                         /* if spi */
-    {
-        res = handle->spi_cmd_data_gpio_write(cmd);                            /* write data command */
-        if (res != 0)                                                          /* check error */
+        else if (c <= (SSD1306_CMD_LOWER_COLUMN_START_ADDRESS | 0x0F))                      /* if lower column */
         {
-            return 1;                                                          /* return error */
+            handle->cursor_column = (uint8_t)((handle->cursor_column & 0xF0) | (c & 0x0F)); /* set lower column */
+            handle->cursor_valid |= SSD1306_CURSOR_COLUMN_LOW;                              /* the lower column is known */
+            if (mode != SSD1306_MEMORY_ADDRESSING_MODE_PAGE)                                /* if not page mode */
+            {
+                handle->cursor_valid &= (uint8_t)(~SSD1306_CURSOR_COLUMN_LOW);              /* only for page mode */
+            }
         }
-        
-        if (handle->spi_write_cmd(&data, 1) != 0)                              /* write command */
+        else if (c <= (SSD1306_CMD_HIGHER_COLUMN_START_ADDRESS | 0x0F))                     /* if higher column */
         {
-            return 1;                                                          /* return error */
+            handle->cursor_column = (uint8_t)((handle->cursor_column & 0x0F) | ((c & 0x07) << 4)); /* set higher column */
+            handle->cursor_valid |= SSD1306_CURSOR_COLUMN_HIGH;                             /* the higher column is known */
+            if (mode != SSD1306_MEMORY_ADDRESSING_MODE_PAGE)                                /* if not page mode */
+            {
+                handle->cursor_valid &= (uint8_t)(~SSD1306_CURSOR_COLUMN_HIGH);             /* only for page mode */
+            }
         }
-        else
+        i += (uint16_t)(1 + args);                                                          /* next command */
+    }
+}
+
+/**
+ * @brief     call the linked data command gpio write
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] value written value
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the ctx function is used when it is linked
+ */
+static uint8_t a_ssd1306_link_dc_write(ssd1306_handle_t *handle, uint8_t value)
+{
+    if (handle->spi_cmd_data_gpio_write_ctx != NULL)                            /* if ctx */
+    {
+        return handle->spi_cmd_data_gpio_write_ctx(handle->user_ctx, value);    /* write with the ctx */
+    }
+    
+    return handle->spi_cmd_data_gpio_write(value);                              /* write */
+}
+
+/**
+ * @brief     call the linked reset gpio write
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] value written value
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the ctx function is used when it is linked
+ */
+static uint8_t a_ssd1306_link_reset_write(ssd1306_handle_t *handle, uint8_t value)
+{
+    if (handle->reset_gpio_write_ctx != NULL)                                   /* if ctx */
+    {
+        return handle->reset_gpio_write_ctx(handle->user_ctx, value);           /* write with the ctx */
+    }
+    
+    return handle->reset_gpio_write(value);                                     /* write */
+}
+
+/**
+ * @brief     call the linked transfer begin
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @note      the ctx function is used when it is linked
+ */
+static void a_ssd1306_link_transfer_begin(ssd1306_handle_t *handle)
+{
+    if (handle->transfer_begin_ctx != NULL)                                     /* if ctx */
+    {
+        handle->transfer_begin_ctx(handle->user_ctx);                           /* queue the writes with the ctx */
+    }
+    else if (handle->transfer_begin != NULL)                                    /* if the writes can be queued */
+    {
+        handle->transfer_begin();                                               /* queue the writes */
+    }
+    else
+    {
+        /* no queue */
+    }
+}
+
+/**
+ * @brief     call the linked lock
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @note      none
+ */
+static void a_ssd1306_lock(ssd1306_handle_t *handle)
+{
+    if (handle->lock != NULL)                                                   /* if the lock is linked */
+    {
+        handle->lock(handle->user_ctx);                                         /* lock */
+    }
+}
+
+/**
+ * @brief     call the linked unlock
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @note      none
+ */
+static void a_ssd1306_unlock(ssd1306_handle_t *handle)
+{
+    if (handle->unlock != NULL)                                                 /* if the unlock is linked */
+    {
+        handle->unlock(handle->user_ctx);                                       /* unlock */
+    }
+}
+
+/**
+ * @brief     count a bus transaction
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] len bytes on the bus
+ * @note      none
+ */
+static void a_ssd1306_count(ssd1306_handle_t *handle, uint16_t len)
+{
+    handle->tx_bytes += len;                                                    /* add bytes */
+    handle->tx_count++;                                                         /* add one transaction */
+}
+
+/**
+ * @brief     write the spi data command line
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] level command or data level
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the gpio is only written when the cached level changes,
+ *            the panels of a group share one cached level
+ */
+static uint8_t a_ssd1306_dc_write(ssd1306_handle_t *handle, uint8_t level)
+{
+    uint8_t *cache;
+    
+    cache = (handle->group != NULL) ? &handle->group->dc_level : &handle->dc_level;  /* a group shares the line */
+    if (*cache == level)                                                        /* if the level is set */
+    {
+        return 0;                                                               /* success return 0 */
+    }
+    if (a_ssd1306_link_dc_write(handle, level) != 0)                            /* write data command */
+    {
+        *cache = 0xFF;                                                          /* the level is unknown */
+        
+        return 1;                                                               /* return error */
+    }
+    *cache = level;                                                             /* save the level */
+    handle->dc_toggle_count++;                                                  /* count the toggle */
+    
+    return 0;                                                                   /* success return 0 */
+}
+
+/**
+ * @brief     write an iic frame
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] *data pointer to a data buffer
+ * @param[in] len data length
+ * @param[in] ctrl control byte
+ * @param[in] *slot pointer to the driver owned byte right in front of the data, NULL if none
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      with iic_write_cmd linked the control byte is put in the slot and the frame
+ *            is written in place, the slot byte is restored afterwards
+ */
+static uint8_t a_ssd1306_iic_write(ssd1306_handle_t *handle, uint8_t *data, uint16_t len, uint8_t ctrl, uint8_t *slot)
+{
+    uint8_t res;
+    uint8_t save;
+    
+    a_ssd1306_count(handle, (uint16_t)(len + 1));                               /* count the frame */
+    if (((handle->iic_write_cmd == NULL) && (handle->iic_write_cmd_ctx == NULL)) || 
+        (slot == NULL))                                                         /* if no slot */
+    {
+        if (handle->iic_write_ctx != NULL)                                      /* if ctx */
         {
-            return 0;                                                          /* success return 0 */
+            return handle->iic_write_ctx(handle->user_ctx, handle->iic_addr, ctrl, data, len);  /* write with a copy */
         }
+        
+        return handle->iic_write(handle->iic_addr, ctrl, data, len);            /* write with a copy */
+    }
+    save = *slot;                                                               /* save the slot */
+    *slot = ctrl;                                                               /* set the control byte */
+    if (handle->iic_write_cmd_ctx != NULL)                                      /* if ctx */
+    {
+        res = handle->iic_write_cmd_ctx(handle->user_ctx, handle->iic_addr, slot, (uint16_t)(len + 1));  /* write in place */
     }
     else
     {
-        return 1;                                                              /* return error */
+        res = handle->iic_write_cmd(handle->iic_addr, slot, (uint16_t)(len + 1));  /* write in place */
     }
+    *slot = save;                                                               /* restore the slot */
+    
+    return (res != 0) ? 1 : 0;                                                  /* return the result */
 }
 
 /**
- * @brief     write multiple bytes
+ * @brief     get the control byte slot in front of a buffer
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] *data pointer to a data buffer
+ * @return    pointer to the slot, NULL if the byte in front of the data is not owned by the driver
+ * @note      only a transfer starting at the gram or the shadow has a slot there, a chunk inside
+ *            them is copied so a pixel byte is never used as the control byte
+ */
+static uint8_t *a_ssd1306_iic_slot(ssd1306_handle_t *handle, uint8_t *data)
+{
+#if (SSD1306_BATCH_ENABLE != 0)
+    uintptr_t addr;
+    uintptr_t base;
+    
+#endif
+    if ((data == &handle->gram[0][0]) && 
+        ((&handle->gram_ctrl + 1) == &handle->gram[0][0]))                      /* the gram starts right after the slot */
+    {
+        return &handle->gram_ctrl;                                              /* return the gram slot */
+    }
+#if (SSD1306_SHADOW_ENABLE != 0)
+    if ((data == &handle->shadow[0][0]) && 
+        ((&handle->shadow_ctrl + 1) == &handle->shadow[0][0]))                  /* the shadow starts right after the slot */
+    {
+        return &handle->shadow_ctrl;                                            /* return the shadow slot */
+    }
+#endif
+#if (SSD1306_BATCH_ENABLE != 0)
+    addr = (uintptr_t)data;                                                     /* get the data address */
+    base = (uintptr_t)&handle->batch.buf[0];                                    /* get the batch address */
+    if ((addr > base) && ((addr - base) < sizeof(handle->batch.buf)))           /* if in the batch, compared as integers */
+    {
+        return &handle->batch.buf[addr - base - 1];                             /* the byte in front is in the batch too */
+    }
+#endif
+    
+    return NULL;                                                                /* no slot */
+}
+
+/**
+ * @brief     write multiple bytes to the bus
  * @param[in] *handle pointer to an ssd1306 handle structure
  * @param[in] *data pointer to a data buffer
  * @param[in] len data length
@@ -166,17 +583,19 @@ static uint8_t a_ssd1306_write_byte(ssd1306_handle_t *handle, uint8_t data, uint
  * @return    status code
  *            - 0 success
  *            - 1 write failed
- * @note      none
+ * @note      the command batch is bypassed
  */
-static uint8_t a_ssd1306_multiple_write_byte(ssd1306_handle_t *handle, uint8_t *data, uint8_t len, uint8_t cmd)
+static uint8_t a_ssd1306_bus_write(ssd1306_handle_t *handle, uint8_t *data, uint16_t len, uint8_t cmd)
 {    
     uint8_t res;
+    uint8_t *slot;
     
     if (handle->iic_spi == SSD1306_INTERFACE_IIC)                               /* if iic */
     {
+        slot = a_ssd1306_iic_slot(handle, data);                                /* get the slot in front */
         if (cmd != 0)                                                           /* if data */
         {
-            if (handle->iic_write(handle->iic_addr, 0x40, data, len) != 0)      /* write data */
+            if (a_ssd1306_iic_write(handle, data, len, 0x40, slot) != 0)        /* write data */
             {
                 return 1;                                                       /* return error */
             }
@@ -187,7 +606,7 @@ static uint8_t a_ssd1306_multiple_write_byte(ssd1306_handle_t *handle, uint8_t *
         }
         else
         {
-            if (handle->iic_write(handle->iic_addr, 0x00, data, len) != 0)      /* write command */
+            if (a_ssd1306_iic_write(handle, data, len, 0x00, slot) != 0)        /* write command */
             {
                 return 1;                                                       /* return error */
             }
@@ -199,13 +618,21 @@ static uint8_t a_ssd1306_multiple_write_byte(ssd1306_handle_t *handle, uint8_t *
     }
     else if (handle->iic_spi == SSD1306_INTERFACE_SPI)                          /* if spi */
     {
-        res = handle->spi_cmd_data_gpio_write(cmd);                             /* write data command */
+        res = a_ssd1306_dc_write(handle, cmd);                                  /* write data command */
         if (res != 0)                                                           /* check error */
         {
             return 1;                                                           /* return error */
         }
-        
-        if (handle->spi_write_cmd(data, len) != 0)                              /* write command */
+        a_ssd1306_count(handle, len);                                           /* count the transfer */
+        if (handle->spi_write_cmd_ctx != NULL)                                  /* if ctx */
+        {
+            res = handle->spi_write_cmd_ctx(handle->user_ctx, data, len);       /* write command with the ctx */
+        }
+        else
+        {
+            res = handle->spi_write_cmd(data, len);                             /* write command */
+        }
+        if (res != 0)                                                           /* check the result */
         {
             return 1;                                                           /* return error */
         }
@@ -220,222 +647,3035 @@ static uint8_t a_ssd1306_multiple_write_byte(ssd1306_handle_t *handle, uint8_t *
     }
 }
 
+#if (SSD1306_BATCH_ENABLE != 0)
 /**
- * @brief     draw a point in gram
+ * @brief     send the command batch
  * @param[in] *handle pointer to an ssd1306 handle structure
- * @param[in] x coordinate x
- * @param[in] y coordinate y
- * @param[in] data written data
  * @return    status code
  *            - 0 success
- *            - 1 gram draw point failed
- * @note      none
+ *            - 1 write failed
+ * @note      iic commands and data go in one transaction with continuation control bytes,
+ *            buf[0] is kept free for the control byte, the batch stays open
  */
-static uint8_t a_ssd1306_gram_draw_point(ssd1306_handle_t *handle, uint8_t x, uint8_t y, uint8_t data)
+static uint8_t a_ssd1306_batch_send(ssd1306_handle_t *handle)
 {
-    uint8_t pos;
-    uint8_t bx;
-    uint8_t temp = 0;
+    uint8_t i;
+    uint8_t res;
+    ssd1306_batch_t *batch = &handle->batch;
     
-    pos = y / 8;                              /* get y page */
-    bx = y % 8;                               /* get y point */
-    temp = 1 << bx;                           /* set data */
-    if (data != 0)                            /* if 1  */
-    {
-        handle->gram[x][pos] |= temp;         /* set 1 */
+    res = 0;                                                                                /* init res */
+    if ((handle->iic_spi == SSD1306_INTERFACE_IIC) && 
+        (batch->cmd_len != 0) && (batch->data_len != 0))                                    /* if iic commands and data */
+    {
+        batch->buf[2 * batch->cmd_len] = 0x40;                                              /* last control byte, data */
+        if (a_ssd1306_iic_write(handle, &batch->buf[1], 
+                                (uint16_t)(2 * batch->cmd_len + batch->data_len), 
+                                batch->buf[0], &batch->buf[0]) != 0)                        /* write the frame */
+        {
+            res = 1;                                                                        /* set error */
+        }
     }
     else
     {
-        handle->gram[x][pos] &= ~temp;        /* set 0 */
+        for (i = 0; i < batch->cmd_len; i++)                                                /* pack the commands */
+        {
+            batch->buf[i + 1] = batch->buf[2 * i + 1];                                      /* drop the control byte */
+        }
+        if ((batch->cmd_len != 0) && 
+            (a_ssd1306_bus_write(handle, &batch->buf[1], 
+                                 batch->cmd_len, SSD1306_CMD) != 0))                        /* write the commands */
+        {
+            res = 1;                                                                        /* set error */
+        }
+        if ((res == 0) && (batch->data_len != 0) && 
+            (a_ssd1306_bus_write(handle, &batch->buf[2 * batch->cmd_len + 1], 
+                                 batch->data_len, SSD1306_DATA) != 0))                      /* write the data */
+        {
+            res = 1;                                                                        /* set error */
+        }
     }
-  
-    return 0;                                 /* success return 0 */
+    batch->cmd_len = 0;                                                                     /* clear commands */
+    batch->data_len = 0;                                                                    /* clear data */
+    if (res != 0)                                                                           /* check the result */
+    {
+        a_ssd1306_address_forget(handle);                                                   /* the state is unknown */
+        a_ssd1306_panel_invalidate(handle);                                                 /* the panel ram is unknown */
+        
+        return 1;                                                                           /* return error */
+    }
+    
+    return 0;                                                                               /* success return 0 */
 }
 
 /**
- * @brief     draw a char in gram
+ * @brief     append bytes to the command batch
  * @param[in] *handle pointer to an ssd1306 handle structure
- * @param[in] x coordinate x
- * @param[in] y coordinate y
- * @param[in] chr written char
+ * @param[in] *data pointer to a data buffer
+ * @param[in] len data length
+ * @param[in] cmd command or data type
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the batch is sent first if the bytes don't fit or a command follows data,
+ *            bytes larger than the batch are written directly
+ */
+static uint8_t a_ssd1306_batch_append(ssd1306_handle_t *handle, uint8_t *data, uint16_t len, uint8_t cmd)
+{
+    uint16_t i;
+    ssd1306_batch_t *batch = &handle->batch;
+    
+    if (cmd == SSD1306_CMD)                                                                 /* if command */
+    {
+        if ((batch->data_len != 0) || ((batch->cmd_len + len) > SSD1306_BATCH_MAX_CMD_LEN)) /* if the commands don't fit */
+        {
+            if (a_ssd1306_batch_send(handle) != 0)                                          /* send the batch */
+            {
+                return 1;                                                                   /* return error */
+            }
+        }
+        if (len > SSD1306_BATCH_MAX_CMD_LEN)                                                /* if too long */
+        {
+            return a_ssd1306_bus_write(handle, data, len, cmd);                             /* write directly */
+        }
+        for (i = 0; i < len; i++)                                                           /* append the commands */
+        {
+            batch->buf[2 * batch->cmd_len] = 0x80;                                          /* continuation control byte */
+            batch->buf[2 * batch->cmd_len + 1] = data[i];                                   /* set command */
+            batch->cmd_len++;                                                               /* next */
+        }
+        
+        return 0;                                                                           /* success return 0 */
+    }
+    
+    if (((batch->data_len + len) > SSD1306_BATCH_MAX_DATA_LEN) || 
+        ((handle->max_transfer_len != 0) && 
+        ((2 * batch->cmd_len + batch->data_len + len) > handle->max_transfer_len)))         /* if the data doesn't fit */
+    {
+        if (a_ssd1306_batch_send(handle) != 0)                                              /* send the batch */
+        {
+            return 1;                                                                       /* return error */
+        }
+    }
+    if (len > SSD1306_BATCH_MAX_DATA_LEN)                                                   /* if too long */
+    {
+        return a_ssd1306_bus_write(handle, data, len, cmd);                                 /* write directly */
+    }
+    memcpy(&batch->buf[2 * batch->cmd_len + 1 + batch->data_len], data, len);               /* append the data */
+    batch->data_len += len;                                                                 /* update length */
+    
+    return 0;                                                                               /* success return 0 */
+}
+#endif
+
+/**
+ * @brief     submit the queued bus writes
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the panel state is unknown after a failed submission
+ */
+static uint8_t a_ssd1306_transfer_end(ssd1306_handle_t *handle)
+{
+    if (handle->transfer_end_ctx != NULL)                                                   /* if ctx */
+    {
+        if (handle->transfer_end_ctx(handle->user_ctx) == 0)                                /* submit the writes with the ctx */
+        {
+            return 0;                                                                       /* success return 0 */
+        }
+    }
+    else if ((handle->transfer_end == NULL) || (handle->transfer_end() == 0))               /* submit the writes */
+    {
+        return 0;                                                                           /* success return 0 */
+    }
+    else
+    {
+        /* submit failed */
+    }
+    a_ssd1306_address_forget(handle);                                                       /* the state is unknown */
+    a_ssd1306_panel_invalidate(handle);                                                     /* the panel ram is unknown */
+    
+    return 1;                                                                               /* return error */
+}
+
+/**
+ * @brief     open an internal command batch
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @return    1 if the batch is opened here, 0 if a batch is already open
+ * @note      the platform may queue the bus writes until the batch is closed
+ */
+static uint8_t a_ssd1306_batch_enter(ssd1306_handle_t *handle)
+{
+    if (handle->batch.open != 0)                                                            /* if a batch is open */
+    {
+        return 0;                                                                           /* use it */
+    }
+    handle->batch.open = 1;                                                                 /* open */
+#if (SSD1306_BATCH_ENABLE != 0)
+    handle->batch.cmd_len = 0;                                                              /* clear commands */
+    handle->batch.data_len = 0;                                                             /* clear data */
+#endif
+    a_ssd1306_link_transfer_begin(handle);                                                  /* queue the writes */
+    
+    return 1;                                                                               /* opened here */
+}
+
+/**
+ * @brief     close an internal command batch
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] own 1 if the batch is opened by the caller
+ * @param[in] send 1 to send the batch, 0 to drop it
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      a batch opened by the user is left open
+ */
+static uint8_t a_ssd1306_batch_leave(ssd1306_handle_t *handle, uint8_t own, uint8_t send)
+{
+    uint8_t res;
+    
+    if (own == 0)                                                                           /* if not opened here */
+    {
+        return 0;                                                                           /* success return 0 */
+    }
+    handle->batch.open = 0;                                                                 /* close */
+    if (send == 0)                                                                          /* if drop */
+    {
+#if (SSD1306_BATCH_ENABLE != 0)
+        handle->batch.cmd_len = 0;                                                          /* clear commands */
+        handle->batch.data_len = 0;                                                         /* clear data */
+#endif
+        (void)a_ssd1306_transfer_end(handle);                                               /* submit the queued writes */
+        
+        return 0;                                                                           /* success return 0 */
+    }
+    
+#if (SSD1306_BATCH_ENABLE != 0)
+    res = a_ssd1306_batch_send(handle);                                                     /* send the batch */
+#else
+    res = 0;                                                                                /* the writes are already sent */
+#endif
+    if (a_ssd1306_transfer_end(handle) != 0)                                                /* submit the queued writes */
+    {
+        res = 1;                                                                            /* set error */
+    }
+    
+    return res;                                                                             /* return the result */
+}
+
+/**
+ * @brief     write multiple bytes
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] *data pointer to a data buffer
+ * @param[in] len data length
+ * @param[in] cmd command or data type
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the bytes are appended to the command batch if it is open,
+ *            the panel addressing state follows the written bytes
+ */
+static uint8_t a_ssd1306_multiple_write_byte(ssd1306_handle_t *handle, uint8_t *data, uint16_t len, uint8_t cmd)
+{
+    a_ssd1306_track(handle, data, len, cmd);                                    /* track the addressing state */
+#if (SSD1306_BATCH_ENABLE != 0)
+    if (handle->batch.open != 0)                                                /* if a batch is open */
+    {
+        return a_ssd1306_batch_append(handle, data, len, cmd);                  /* append to the batch */
+    }
+#endif
+    if (a_ssd1306_bus_write(handle, data, len, cmd) != 0)                       /* write the bus */
+    {
+        a_ssd1306_address_forget(handle);                                       /* the state is unknown */
+        
+        return 1;                                                               /* return error */
+    }
+    
+    return 0;                                                                   /* success return 0 */
+}
+
+/**
+ * @brief     write one byte
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] data written data
+ * @param[in] cmd command or data type
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the byte is appended to the command batch if it is open
+ */
+static uint8_t a_ssd1306_write_byte(ssd1306_handle_t *handle, uint8_t data, uint8_t cmd)
+{
+    return a_ssd1306_multiple_write_byte(handle, &data, 1, cmd);               /* write one byte */
+}
+
+/**
+ * @brief     put back the addressing mode of the application
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the gram flushes leave the panel in their own mode,
+ *            the raw address and data functions expect the mode the application set
+ */
+static uint8_t a_ssd1306_mode_restore(ssd1306_handle_t *handle)
+{
+    uint8_t buf[2];
+    
+    if (handle->addressing_mode == handle->user_addressing_mode)                            /* if the mode matches */
+    {
+        return 0;                                                                           /* nothing to do */
+    }
+    buf[0] = SSD1306_CMD_MEMORY_ADDRESSING_MODE;                                            /* set command mode */
+    buf[1] = handle->user_addressing_mode;                                                  /* set the application mode */
+    
+    return a_ssd1306_multiple_write_byte(handle, buf, 2, SSD1306_CMD);                      /* write command */
+}
+
+/**
+ * @brief     save the addressing mode left by the application commands
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @note      an unknown mode keeps the saved one
+ */
+static void a_ssd1306_mode_save(ssd1306_handle_t *handle)
+{
+    if (handle->addressing_mode <= SSD1306_MEMORY_ADDRESSING_MODE_PAGE)                     /* if the mode is known */
+    {
+        handle->user_addressing_mode = handle->addressing_mode;                             /* save the mode */
+    }
+}
+
+/**
+ * @brief      build the page mode address commands
+ * @param[in]  *handle pointer to an ssd1306 handle structure
+ * @param[in]  page page index
+ * @param[in]  column start column
+ * @param[out] *cmd pointer to a command buffer with 5 bytes at least
+ * @return     command length
+ * @note       the commands already matching the panel cursor are left out
+ */
+static uint8_t a_ssd1306_page_address(ssd1306_handle_t *handle, uint8_t page, uint8_t column, uint8_t *cmd)
+{
+    uint8_t n;
+    uint8_t valid;
+    
+    n = 0;                                                                                  /* init length */
+    valid = handle->cursor_valid;                                                           /* get the cursor */
+    if (handle->addressing_mode != SSD1306_MEMORY_ADDRESSING_MODE_PAGE)                     /* check the mode */
+    {
+        cmd[n++] = SSD1306_CMD_MEMORY_ADDRESSING_MODE;                                      /* set command mode */
+        cmd[n++] = SSD1306_MEMORY_ADDRESSING_MODE_PAGE;                                     /* set page mode */
+        valid = 0;                                                                          /* the cursor is unknown */
+    }
+    if (((valid & SSD1306_CURSOR_PAGE) == 0) || (handle->cursor_page != page))              /* check the page */
+    {
+        cmd[n++] = SSD1306_CMD_PAGE_ADDR + page;                                            /* set page */
+    }
+    if (((valid & SSD1306_CURSOR_COLUMN_LOW) == 0) || 
+        ((handle->cursor_column & 0x0F) != (column & 0x0F)))                                /* check the lower column */
+    {
+        cmd[n++] = SSD1306_CMD_LOWER_COLUMN_START_ADDRESS | (column & 0x0F);                /* set lower column */
+    }
+    if (((valid & SSD1306_CURSOR_COLUMN_HIGH) == 0) || 
+        ((handle->cursor_column >> 4) != ((column >> 4) & 0x0F)))                           /* check the higher column */
+    {
+        cmd[n++] = SSD1306_CMD_HIGHER_COLUMN_START_ADDRESS | ((column >> 4) & 0x0F);        /* set higher column */
+    }
+    
+    return n;                                                                               /* return the length */
+}
+
+/**
+ * @brief      build the vertical mode window commands
+ * @param[in]  *handle pointer to an ssd1306 handle structure
+ * @param[in]  column_start start column
+ * @param[in]  column_end end column
+ * @param[in]  page_start start page
+ * @param[in]  page_end end page
+ * @param[out] *cmd pointer to a command buffer with 8 bytes at least
+ * @return     command length
+ * @note       the commands already matching the panel window and cursor are left out
+ */
+static uint8_t a_ssd1306_window_address(ssd1306_handle_t *handle, uint8_t column_start, uint8_t column_end, 
+                                        uint8_t page_start, uint8_t page_end, uint8_t *cmd)
+{
+    uint8_t n;
+    uint8_t valid;
+    
+    n = 0;                                                                                  /* init length */
+    valid = handle->cursor_valid;                                                           /* get the cursor */
+    if (handle->addressing_mode != SSD1306_MEMORY_ADDRESSING_MODE_VERTICAL)                 /* check the mode */
+    {
+        cmd[n++] = SSD1306_CMD_MEMORY_ADDRESSING_MODE;                                      /* set command mode */
+        cmd[n++] = SSD1306_MEMORY_ADDRESSING_MODE_VERTICAL;                                 /* set vertical mode */
+        valid = 0;                                                                          /* the cursor is unknown */
+    }
+    if (((handle->window_valid & SSD1306_WINDOW_COLUMN) == 0) || 
+        (handle->window_column_start != column_start) || (handle->window_column_end != column_end) || 
+        ((valid & SSD1306_CURSOR_COLUMN) != SSD1306_CURSOR_COLUMN) || 
+        (handle->cursor_column != column_start))                                            /* check the columns */
+    {
+        cmd[n++] = SSD1306_CMD_SET_COLUMN_ADDRESS;                                          /* set column address */
+        cmd[n++] = column_start;                                                            /* set start column */
+        cmd[n++] = column_end;                                                              /* set end column */
+    }
+    if (((handle->window_valid & SSD1306_WINDOW_PAGE) == 0) || 
+        (handle->window_page_start != page_start) || (handle->window_page_end != page_end) || 
+        ((valid & SSD1306_CURSOR_PAGE) == 0) || (handle->cursor_page != page_start))        /* check the pages */
+    {
+        cmd[n++] = SSD1306_CMD_SET_PAGE_ADDRESS;                                            /* set page address */
+        cmd[n++] = page_start;                                                              /* set start page */
+        cmd[n++] = page_end;                                                                /* set end page */
+    }
+    
+    return n;                                                                               /* return the length */
+}
+
+/**
+ * @brief     check if drawing would race with a running flush job
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @return    1 if the drawing buffer is being flushed, else 0
+ * @note      a back buffer can be drawn while the flushing buffer is sent
+ */
+static uint8_t a_ssd1306_draw_busy(ssd1306_handle_t *handle)
+{
+    if ((handle->job.active != 0) && (handle->gram_draw == handle->gram_flush))  /* if the job reads the drawing buffer */
+    {
+        return 1;                                                               /* busy */
+    }
+    
+    return 0;                                                                   /* not busy */
+}
+
+/**
+ * @brief     mark a gram byte as dirty
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] x column
+ * @param[in] page page index
+ * @note      none
+ */
+static void a_ssd1306_gram_mark_dirty(ssd1306_handle_t *handle, uint8_t x, uint8_t page)
+{
+    uint8_t *mask = &handle->dirty_page;
+    uint8_t *column_min = handle->dirty_column_min;
+    uint8_t *column_max = handle->dirty_column_max;
+    
+    if (handle->gram_draw != handle->gram_flush)                /* if drawing in the back buffer */
+    {
+        mask = &handle->back_dirty_page;                        /* mark the back buffer */
+        column_min = handle->back_dirty_column_min;             /* back buffer min columns */
+        column_max = handle->back_dirty_column_max;             /* back buffer max columns */
+    }
+    if (((*mask) & (1 << page)) == 0)                           /* if the page is clean */
+    {
+        *mask |= (uint8_t)(1 << page);                          /* set the page dirty */
+        column_min[page] = x;                                   /* set min column */
+        column_max[page] = x;                                   /* set max column */
+    }
+    else
+    {
+        if (x < column_min[page])                               /* check min column */
+        {
+            column_min[page] = x;                               /* set min column */
+        }
+        if (x > column_max[page])                               /* check max column */
+        {
+            column_max[page] = x;                               /* set max column */
+        }
+    }
+}
+
+/**
+ * @brief     merge the back buffer dirty marks into the flush dirty marks
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @note      called when the drawn frame becomes the flushing frame
+ */
+static void a_ssd1306_back_dirty_merge(ssd1306_handle_t *handle)
+{
+    uint8_t i;
+    
+    for (i = 0; i < 8; i++)                                                     /* all pages */
+    {
+        if ((handle->back_dirty_page & (1 << i)) == 0)                          /* if the page is clean */
+        {
+            continue;                                                           /* next page */
+        }
+        if ((handle->dirty_page & (1 << i)) == 0)                               /* if the flush page is clean */
+        {
+            handle->dirty_page |= (uint8_t)(1 << i);                            /* set the page dirty */
+            handle->dirty_column_min[i] = handle->back_dirty_column_min[i];     /* set min column */
+            handle->dirty_column_max[i] = handle->back_dirty_column_max[i];     /* set max column */
+        }
+        else
+        {
+            if (handle->back_dirty_column_min[i] < handle->dirty_column_min[i]) /* check min column */
+            {
+                handle->dirty_column_min[i] = handle->back_dirty_column_min[i]; /* set min column */
+            }
+            if (handle->back_dirty_column_max[i] > handle->dirty_column_max[i]) /* check max column */
+            {
+                handle->dirty_column_max[i] = handle->back_dirty_column_max[i]; /* set max column */
+            }
+        }
+    }
+    handle->back_dirty_page = 0;                                                /* back buffer is clean */
+}
+
+/**
+ * @brief      get the next span to flush in a page
+ * @param[in]  *handle pointer to an ssd1306 handle structure
+ * @param[in]  source flush source
+ * @param[in]  page page index
+ * @param[in]  from first column to check
+ * @param[out] *start pointer to a start column buffer
+ * @param[out] *end pointer to an end column buffer
+ * @return     1 if a span is found, else 0
+ * @note       none
+ */
+static uint8_t a_ssd1306_next_span(ssd1306_handle_t *handle, uint8_t source, uint8_t page, 
+                                   uint16_t from, uint8_t *start, uint8_t *end)
+{
+    uint16_t n;
+    
+    if (from > 127)                                                                         /* check the column */
+    {
+        return 0;                                                                           /* no span */
+    }
+#if (SSD1306_SHADOW_ENABLE == 0)
+    if (source == SSD1306_FLUSH_SOURCE_ALL)                                                 /* if the whole page */
+#else
+    if ((source == SSD1306_FLUSH_SOURCE_ALL) ||
+        ((source == SSD1306_FLUSH_SOURCE_DIFF) && ((handle->shadow_valid & (1 << page)) == 0))) /* if the whole page */
+#endif
+    {
+        *start = (uint8_t)from;                                                             /* set start */
+        *end = 127;                                                                         /* set end */
+        
+        return 1;                                                                           /* found */
+    }
+    if (source == SSD1306_FLUSH_SOURCE_DIRTY)                                               /* if dirty */
+    {
+        if (((handle->job.dirty_page & (1 << page)) == 0) || 
+            (from > handle->job.dirty_column_max[page]))                                    /* if clean */
+        {
+            return 0;                                                                       /* no span */
+        }
+        *start = (from > handle->job.dirty_column_min[page]) ? 
+                 (uint8_t)from : handle->job.dirty_column_min[page];                        /* set start */
+        *end = handle->job.dirty_column_max[page];                                          /* set end */
+        
+        return 1;                                                                           /* found */
+    }
+#if (SSD1306_SHADOW_ENABLE != 0)
+    for (n = from; n < 128; n++)                                                            /* find the start */
+    {
+        if (handle->gram_flush[n][page] != handle->shadow[n][page])                         /* if changed */
+        {
+            break;                                                                          /* break */
+        }
+    }
+    if (n == 128)                                                                           /* if not changed */
+    {
+        return 0;                                                                           /* no span */
+    }
+    *start = (uint8_t)n;                                                                    /* set start */
+    for (; n < 128; n++)                                                                    /* find the end */
+    {
+        if (handle->gram_flush[n][page] == handle->shadow[n][page])                         /* if not changed */
+        {
+            break;                                                                          /* break */
+        }
+    }
+    *end = (uint8_t)(n - 1);                                                                /* set end */
+    
+    return 1;                                                                               /* found */
+#else
+    (void)n;                                                                                /* no diff scan */
+    
+    return 0;                                                                               /* no span */
+#endif
+}
+
+/**
+ * @brief     get the cost of one command write
+ * @param[in] *model pointer to a cost model structure
+ * @param[in] len command length
+ * @return    cost
+ * @note      none
+ */
+static uint32_t a_ssd1306_cost_cmd(const ssd1306_cost_model_t *model, uint16_t len)
+{
+    return (uint32_t)model->transaction_cost + (uint32_t)model->byte_cost * len + 
+           (uint32_t)model->dc_switch_cost;                                                 /* return the cost */
+}
+
+/**
+ * @brief     get the cost of one data burst
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] *model pointer to a cost model structure
+ * @param[in] len data length
+ * @param[in] chunk max bytes in one write
+ * @return    cost
+ * @note      none
+ */
+static uint32_t a_ssd1306_cost_data(ssd1306_handle_t *handle, const ssd1306_cost_model_t *model, 
+                                    uint16_t len, uint16_t chunk)
+{
+    uint32_t n;
+    
+    if ((handle->max_transfer_len != 0) && ((chunk == 0) || (chunk > handle->max_transfer_len)))  /* check the limit */
+    {
+        chunk = handle->max_transfer_len;                                                   /* set the limit */
+    }
+    if (chunk == 0)                                                                         /* if no limit */
+    {
+        n = 1;                                                                              /* one write */
+    }
+    else
+    {
+        n = ((uint32_t)len + chunk - 1) / chunk;                                            /* get the writes */
+    }
+    
+    return n * model->transaction_cost + (uint32_t)model->byte_cost * len + 
+           (uint32_t)model->dc_switch_cost;                                                 /* return the cost */
+}
+
+/**
+ * @brief      get the active cost model
+ * @param[in]  *handle pointer to an ssd1306 handle structure
+ * @param[out] *model pointer to a cost model structure
+ * @note       the interface default is used if no model is set
+ */
+static void a_ssd1306_cost_model(ssd1306_handle_t *handle, ssd1306_cost_model_t *model)
+{
+    if ((handle->cost_model.transaction_cost != 0) || (handle->cost_model.byte_cost != 0) ||
+        (handle->cost_model.dc_switch_cost != 0))                                           /* if set */
+    {
+        *model = handle->cost_model;                                                        /* copy the model */
+    }
+    else if (handle->iic_spi == SSD1306_INTERFACE_IIC)                                      /* if iic */
+    {
+        model->transaction_cost = SSD1306_IIC_DEFAULT_TRANSACTION_COST;                     /* set transaction cost */
+        model->byte_cost = SSD1306_IIC_DEFAULT_BYTE_COST;                                   /* set byte cost */
+        model->dc_switch_cost = SSD1306_IIC_DEFAULT_DC_SWITCH_COST;                         /* set dc switch cost */
+    }
+    else
+    {
+        model->transaction_cost = SSD1306_SPI_DEFAULT_TRANSACTION_COST;                     /* set transaction cost */
+        model->byte_cost = SSD1306_SPI_DEFAULT_BYTE_COST;                                   /* set byte cost */
+        model->dc_switch_cost = SSD1306_SPI_DEFAULT_DC_SWITCH_COST;                         /* set dc switch cost */
+    }
+}
+
+/**
+ * @brief     get the max gap worth merging into a span
+ * @param[in] *model pointer to a cost model structure
+ * @return    max merged gap in bytes
+ * @note      a gap is merged when sending it costs less than re-addressing after it
+ */
+static uint8_t a_ssd1306_merge_gap(const ssd1306_cost_model_t *model)
+{
+    uint32_t readdress;
+    
+    readdress = a_ssd1306_cost_cmd(model, 3) + model->transaction_cost + 
+                model->dc_switch_cost;                                                      /* get re-addressing cost */
+    if ((model->byte_cost == 0) || ((readdress / model->byte_cost) > 127))                  /* check the gap */
+    {
+        return 127;                                                                         /* merge all */
+    }
+    
+    return (uint8_t)(readdress / model->byte_cost);                                         /* return the gap */
+}
+
+/**
+ * @brief     get the cost of the page mode flush plan
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] *model pointer to a cost model structure
+ * @param[in] source flush source
+ * @param[in] gap max merged gap in bytes
+ * @return    cost
+ * @note      none
+ */
+static uint32_t a_ssd1306_page_plan_cost(ssd1306_handle_t *handle, const ssd1306_cost_model_t *model, 
+                                         uint8_t source, uint8_t gap)
+{
+    uint8_t i;
+    uint8_t start;
+    uint8_t end;
+    uint8_t s;
+    uint8_t e;
+    uint8_t found;
+    uint32_t cost;
+    
+    cost = 0;                                                                               /* init cost */
+    if (handle->addressing_mode != SSD1306_MEMORY_ADDRESSING_MODE_PAGE)                     /* if not page mode */
+    {
+        cost += (uint32_t)model->byte_cost * 2;                                             /* add mode cost */
+    }
+    for (i = 0; i < 8; i++)                                                                 /* all pages */
+    {
+        found = a_ssd1306_next_span(handle, source, i, 0, &start, &end);                    /* get the first span */
+        while (found != 0)                                                                  /* all spans */
+        {
+            found = a_ssd1306_next_span(handle, source, i, (uint16_t)end + 1, &s, &e);      /* get the next span */
+            if ((found != 0) && ((s - end - 1) <= gap))                                     /* if the gap is cheap */
+            {
+                end = e;                                                                    /* merge */
+                
+                continue;                                                                   /* next */
+            }
+            cost += a_ssd1306_cost_cmd(model, 3) + 
+                    a_ssd1306_cost_data(handle, model, (uint16_t)(end - start + 1), 0);     /* add span cost */
+            start = s;                                                                      /* set start */
+            end = e;                                                                        /* set end */
+        }
+    }
+    
+    return cost;                                                                            /* return the cost */
+}
+
+/**
+ * @brief     send the pending span of combined points
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+static uint8_t a_ssd1306_pending_flush(ssd1306_handle_t *handle)
+{
+    uint8_t i;
+    uint8_t n;
+    uint8_t own;
+    uint8_t page;
+    uint8_t start;
+    uint8_t len;
+    uint8_t buf[5];
+    uint8_t data[128];
+    
+    if (handle->pending_len == 0)                                                           /* if nothing is pending */
+    {
+        return 0;                                                                           /* success return 0 */
+    }
+    if (handle->job.active != 0)                                                            /* if a job owns the bus */
+    {
+        return 1;                                                                           /* return error */
+    }
+    a_ssd1306_lock(handle);                                                                 /* lock the gram */
+    page = handle->pending_page;                                                            /* get page */
+    start = handle->pending_start;                                                          /* get start column */
+    len = handle->pending_len;                                                              /* get length */
+    handle->pending_len = 0;                                                                /* nothing pending */
+    for (i = 0; i < len; i++)                                                               /* gather the span */
+    {
+        data[i] = handle->gram_flush[start + i][page];                                      /* copy one column */
+    }
+    a_ssd1306_unlock(handle);                                                               /* unlock the gram */
+    n = a_ssd1306_page_address(handle, page, start, buf);                                   /* build the address */
+    own = a_ssd1306_batch_enter(handle);                                                    /* batch address and data */
+    if (((n != 0) && (a_ssd1306_multiple_write_byte(handle, (uint8_t *)buf, n, SSD1306_CMD) != 0)) || 
+        (a_ssd1306_multiple_write_byte(handle, (uint8_t *)data, len, SSD1306_DATA) != 0))   /* write the span */
+    {
+        (void)a_ssd1306_batch_leave(handle, own, 0);                                        /* drop the batch */
+        a_ssd1306_panel_invalidate(handle);                                                 /* the panel ram is unknown */
+        
+        return 1;                                                                           /* return error */
+    }
+    if (a_ssd1306_batch_leave(handle, own, 1) != 0)                                         /* send the batch */
+    {
+        return 1;                                                                           /* return error */
+    }
+#if (SSD1306_SHADOW_ENABLE != 0)
+    a_ssd1306_lock(handle);                                                                 /* lock the shadow */
+    for (i = 0; i < len; i++)                                                               /* update the shadow */
+    {
+        handle->shadow[start + i][page] = data[i];                                          /* save one column */
+    }
+    a_ssd1306_unlock(handle);                                                               /* unlock the shadow */
+#endif
+    
+    return 0;                                                                               /* success return 0 */
+}
+
+/**
+ * @brief     plan a flush job
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] source flush source
+ * @param[in] frame 1 to force the full frame window
+ * @return    1 if there is data to flush, else 0
+ * @note      the plan is page mode spans or one vertical mode window,
+ *            the dirty spans are moved from the handle to the job
+ */
+static uint8_t a_ssd1306_job_plan(ssd1306_handle_t *handle, uint8_t source, uint8_t frame)
+{
+    uint8_t i;
+    uint8_t n;
+    uint8_t start;
+    uint8_t end;
+    uint8_t c0 = 127;
+    uint8_t c1 = 0;
+    uint8_t p0 = 7;
+    uint8_t p1 = 0;
+    uint8_t found = 0;
+    uint16_t size;
+    uint32_t page_cost;
+    uint32_t window_cost;
+    ssd1306_cost_model_t model;
+    ssd1306_flush_job_t *job = &handle->job;
+    
+    a_ssd1306_lock(handle);                                                                 /* lock the dirty state */
+    job->dirty_page = handle->dirty_page;                                                   /* take the dirty pages */
+    memcpy(job->dirty_column_min, handle->dirty_column_min, 8);                             /* take min columns */
+    memcpy(job->dirty_column_max, handle->dirty_column_max, 8);                             /* take max columns */
+    handle->dirty_page = 0;                                                                 /* drawing marks again */
+    a_ssd1306_unlock(handle);                                                               /* unlock the dirty state */
+    if (frame != 0)                                                                         /* if full frame */
+    {
+        found = 1;                                                                          /* found */
+        c0 = 0;                                                                             /* set start column */
+        c1 = 127;                                                                           /* set end column */
+        p0 = 0;                                                                             /* set start page */
+        p1 = 7;                                                                             /* set end page */
+    }
+    for (i = 0; (i < 8) && (frame == 0); i++)                                               /* all pages */
+    {
+        if (a_ssd1306_next_span(handle, source, i, 0, &start, &end) == 0)                   /* get the first span */
+        {
+            continue;                                                                       /* next page */
+        }
+        found = 1;                                                                          /* found */
+        c0 = (start < c0) ? start : c0;                                                     /* update start column */
+        while (a_ssd1306_next_span(handle, source, i, (uint16_t)end + 1, &start, &end) != 0) /* find the last span */
+        {
+        }
+        c1 = (end > c1) ? end : c1;                                                         /* update end column */
+        p0 = (i < p0) ? i : p0;                                                             /* update start page */
+        p1 = i;                                                                             /* update end page */
+    }
+    if (found == 0)                                                                         /* if nothing to flush */
+    {
+        return 0;                                                                           /* no job */
+    }
+    
+    a_ssd1306_cost_model(handle, &model);                                                   /* get the model */
+    job->gap = a_ssd1306_merge_gap(&model);                                                 /* set the gap */
+    job->source = source;                                                                   /* set source */
+    job->column_start = c0;                                                                 /* set start column */
+    job->column_end = c1;                                                                   /* set end column */
+    job->page_start = p0;                                                                   /* set start page */
+    job->page_end = p1;                                                                     /* set end page */
+    job->stage = SSD1306_JOB_STAGE_ADDRESS;                                                 /* address first */
+    job->page = 0;                                                                          /* first page */
+    job->next = 0;                                                                          /* first column */
+    job->len = 0;                                                                           /* nothing pending */
+    job->sent = 0;                                                                          /* nothing sent */
+    job->async = 0;                                                                         /* blocking job */
+    if (frame != 0)                                                                         /* if full frame */
+    {
+        job->window = 1;                                                                    /* use the window */
+        
+        return 1;                                                                           /* job planned */
+    }
+    page_cost = a_ssd1306_page_plan_cost(handle, &model, source, job->gap);                 /* get page mode cost */
+    size = (uint16_t)((c1 - c0 + 1) * (p1 - p0 + 1));                                       /* get window size */
+    n = a_ssd1306_window_address(handle, c0, c1, p0, p1, job->cmd);                         /* get the window commands */
+    window_cost = ((n != 0) ? a_ssd1306_cost_cmd(&model, n) : 0) + 
+                  a_ssd1306_cost_data(handle, &model, size, 
+                  ((p0 == 0) && (p1 == 7)) ? 0 : 128);                                      /* get window cost */
+    job->window = (window_cost < page_cost) ? 1 : 0;                                        /* choose the plan */
+    
+    return 1;                                                                               /* job planned */
+}
+
+/**
+ * @brief     gather the current span of the flush job
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @note      none
+ */
+static void a_ssd1306_job_gather(ssd1306_handle_t *handle)
+{
+    uint8_t n;
+    ssd1306_flush_job_t *job = &handle->job;
+    
+    for (n = 0; n < job->span_len; n++)                                                     /* gather the span */
+    {
+        job->buf[n] = handle->gram_flush[job->span_start + n][job->page];                   /* copy one column */
+    }
+    job->data = job->buf;                                                                   /* set data */
+    job->len = job->span_len;                                                               /* set length */
+    job->dc = SSD1306_DATA;                                                                 /* data */
+    job->stage = SSD1306_JOB_STAGE_ADDRESS;                                                 /* address next */
+    job->next = (uint16_t)job->span_start + job->span_len;                                  /* next column */
+}
+
+/**
+ * @brief     prepare the next transfer of the flush job
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @return    1 if a transfer is ready, 0 if the job is done
+ * @note      none
+ */
+static uint8_t a_ssd1306_job_prepare(ssd1306_handle_t *handle)
+{
+    uint8_t n;
+    uint8_t h;
+    uint8_t start;
+    uint8_t end;
+    uint8_t s;
+    uint8_t e;
+    uint16_t total;
+    ssd1306_flush_job_t *job = &handle->job;
+    
+    if (job->len != 0)                                                                      /* if a transfer is left */
+    {
+        return 1;                                                                           /* ready */
+    }
+    if (job->window != 0)                                                                   /* if window */
+    {
+        h = (uint8_t)(job->page_end - job->page_start + 1);                                 /* get height */
+        total = (uint16_t)((job->column_end - job->column_start + 1) * h);                  /* get size */
+        if (job->stage == SSD1306_JOB_STAGE_ADDRESS)                                        /* if address */
+        {
+            n = a_ssd1306_window_address(handle, job->column_start, job->column_end, 
+                                         job->page_start, job->page_end, job->cmd);        /* build the window */
+            job->stage = SSD1306_JOB_STAGE_DATA;                                            /* data next */
+            if (n != 0)                                                                     /* if the window is needed */
+            {
+                job->data = job->cmd;                                                       /* set data */
+                job->len = n;                                                               /* set length */
+                job->dc = SSD1306_CMD;                                                      /* command */
+                
+                return 1;                                                                   /* ready */
+            }
+        }
+        if (job->next >= total)                                                             /* if all sent */
+        {
+            return 0;                                                                       /* done */
+        }
+        if (h == 8)                                                                         /* if full height */
+        {
+#if (SSD1306_SHADOW_ENABLE != 0)
+            memcpy(&handle->shadow[job->column_start][0], 
+                   &handle->gram_flush[job->column_start][0], total);                       /* snapshot into the shadow */
+            job->data = &handle->shadow[job->column_start][0];                              /* send the snapshot */
+#else
+            job->data = &handle->gram_flush[job->column_start][0];                          /* send the gram, drawing in it is refused */
+#endif
+            job->len = total;                                                               /* set length */
+            job->next = total;                                                              /* all planned */
+        }
+        else
+        {
+            n = 0;                                                                          /* init length */
+            while ((job->next < total) && (n < 128))                                        /* gather 128 bytes */
+            {
+                job->buf[n++] = handle->gram_flush[job->column_start + job->next / h]
+                                            [job->page_start + job->next % h];              /* gather one byte */
+                job->next++;                                                                /* next byte */
+            }
+            job->data = job->buf;                                                           /* set data */
+            job->len = n;                                                                   /* set length */
+        }
+        job->dc = SSD1306_DATA;                                                             /* data */
+        
+        return 1;                                                                           /* ready */
+    }
+    
+    if (job->stage == SSD1306_JOB_STAGE_DATA)                                               /* if data */
+    {
+        a_ssd1306_job_gather(handle);                                                       /* gather the span */
+        
+        return 1;                                                                           /* ready */
+    }
+    while (job->page < 8)                                                                   /* all pages */
+    {
+        if (a_ssd1306_next_span(handle, job->source, job->page, job->next, &start, &end) != 0) /* get the next span */
+        {
+            while ((a_ssd1306_next_span(handle, job->source, job->page, 
+                                        (uint16_t)end + 1, &s, &e) != 0) &&
+                   ((s - end - 1) <= job->gap))                                             /* merge the cheap gaps */
+            {
+                end = e;                                                                    /* merge */
+            }
+            n = a_ssd1306_page_address(handle, job->page, start, job->cmd);                /* build the address */
+            job->span_start = start;                                                        /* set span start */
+            job->span_len = (uint8_t)(end - start + 1);                                     /* set span length */
+            if (n == 0)                                                                     /* if the cursor is there */
+            {
+                a_ssd1306_job_gather(handle);                                               /* gather the span */
+                
+                return 1;                                                                   /* ready */
+            }
+            job->data = job->cmd;                                                           /* set data */
+            job->len = n;                                                                   /* set length */
+            job->dc = SSD1306_CMD;                                                          /* command */
+            job->stage = SSD1306_JOB_STAGE_DATA;                                            /* data next */
+            
+            return 1;                                                                       /* ready */
+        }
+        job->page++;                                                                        /* next page */
+        job->next = 0;                                                                      /* first column */
+    }
+    
+    return 0;                                                                               /* done */
+}
+
+/**
+ * @brief     get the length of the next transfer
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @return    transfer length
+ * @note      data is split at the max transfer length
+ */
+static uint16_t a_ssd1306_job_chunk(ssd1306_handle_t *handle)
+{
+    ssd1306_flush_job_t *job = &handle->job;
+    
+    job->chunk = job->len;                                                                  /* set the length */
+    if ((job->dc == SSD1306_DATA) && (handle->max_transfer_len != 0) && 
+        (job->chunk > handle->max_transfer_len))                                            /* check the limit */
+    {
+        job->chunk = handle->max_transfer_len;                                              /* set the limit */
+    }
+    
+    return job->chunk;                                                                      /* return the length */
+}
+
+/**
+ * @brief     complete the transfer of the flush job
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @note      none
+ */
+static void a_ssd1306_job_complete(ssd1306_handle_t *handle)
+{
+#if (SSD1306_SHADOW_ENABLE != 0)
+    uint8_t h;
+    uint16_t i;
+    uint16_t n;
+#endif
+    ssd1306_flush_job_t *job = &handle->job;
+    
+    if ((job->window != 0) && (job->dc == SSD1306_DATA))                                    /* if window data */
+    {
+#if (SSD1306_SHADOW_ENABLE != 0)
+        h = (uint8_t)(job->page_end - job->page_start + 1);                                 /* get height */
+        for (i = 0; (h != 8) && (i < job->chunk); i++)                                      /* a full height window is sent from the shadow */
+        {
+            n = job->sent + i;                                                              /* get the window byte */
+            handle->shadow[job->column_start + n / h][job->page_start + n % h] = job->data[i]; /* save one byte */
+        }
+#endif
+        job->sent += job->chunk;                                                            /* update sent bytes */
+    }
+    job->data += job->chunk;                                                                /* next data */
+    job->len -= job->chunk;                                                                 /* update length */
+#if (SSD1306_SHADOW_ENABLE != 0)
+    if ((job->len == 0) && (job->dc == SSD1306_DATA) && (job->window == 0))                 /* if a span is sent */
+    {
+        for (i = 0; i < job->span_len; i++)                                                 /* update the shadow */
+        {
+            handle->shadow[job->span_start + i][job->page] = job->buf[i];                   /* save one column */
+        }
+        if (job->span_len == 128)                                                           /* if the whole page */
+        {
+            handle->shadow_valid |= (uint8_t)(1 << job->page);                              /* the page shadow is valid */
+        }
+    }
+#endif
+}
+
+/**
+ * @brief     finish the flush job
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @note      none
+ */
+static void a_ssd1306_job_finish(ssd1306_handle_t *handle)
+{
+#if (SSD1306_SHADOW_ENABLE != 0)
+    uint8_t p;
+#endif
+    ssd1306_flush_job_t *job = &handle->job;
+    
+#if (SSD1306_SHADOW_ENABLE != 0)
+    if ((job->window != 0) && (job->column_start == 0) && (job->column_end == 127))         /* if a full width window */
+    {
+        for (p = job->page_start; p <= job->page_end; p++)                                  /* all pages */
+        {
+            handle->shadow_valid |= (uint8_t)(1 << p);                                      /* the page shadow is valid */
+        }
+    }
+#endif
+    job->active = 0;                                                                        /* job done */
+}
+
+/**
+ * @brief     abort the flush job after a failed transfer
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @note      the panel state is unknown afterwards, it can run in the irq handler
+ *            so the panel ram is only flagged lost and a_ssd1306_job_reap invalidates it
+ */
+static void a_ssd1306_job_fail(ssd1306_handle_t *handle)
+{
+    handle->job.len = 0;                                                                    /* nothing pending */
+    a_ssd1306_address_forget(handle);                                                       /* the state is unknown */
+    handle->job.lost = 1;                                                                   /* panel ram is unknown */
+    handle->job.active = 0;                                                                 /* job done */
+}
+
+/**
+ * @brief     invalidate the panel ram lost by a failed job
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @note      thread context only, the dirty state is changed under the lock
+ */
+static void a_ssd1306_job_reap(ssd1306_handle_t *handle)
+{
+    if ((handle->job.active == 0) && (handle->job.lost != 0))                               /* if a job lost the panel ram */
+    {
+        handle->job.lost = 0;                                                               /* clear the flag */
+        a_ssd1306_lock(handle);                                                             /* lock the gram */
+        a_ssd1306_panel_invalidate(handle);                                                 /* panel ram is unknown */
+        a_ssd1306_unlock(handle);                                                           /* unlock the gram */
+    }
+}
+
+/**
+ * @brief     flush the gram with the cheapest plan
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] source flush source
+ * @param[in] frame 1 to force the full frame window
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+static uint8_t a_ssd1306_flush(ssd1306_handle_t *handle, uint8_t source, uint8_t frame)
+{
+    uint8_t own;
+    ssd1306_flush_job_t *job = &handle->job;
+    
+    if (job->active != 0)                                                                   /* if a job is running */
+    {
+        return 1;                                                                           /* return error */
+    }
+    a_ssd1306_job_reap(handle);                                                             /* resend a lost panel ram */
+    if (a_ssd1306_pending_flush(handle) != 0)                                               /* send the pending span */
+    {
+        return 1;                                                                           /* return error */
+    }
+    if (a_ssd1306_job_plan(handle, source, frame) == 0)                                     /* plan the job */
+    {
+        return 0;                                                                           /* success return 0 */
+    }
+    job->active = 1;                                                                        /* job active */
+    own = a_ssd1306_batch_enter(handle);                                                    /* batch address and data */
+    while (a_ssd1306_job_prepare(handle) != 0)                                              /* all transfers */
+    {
+        if (a_ssd1306_multiple_write_byte(handle, job->data, 
+                                          a_ssd1306_job_chunk(handle), job->dc) != 0)       /* write the transfer */
+        {
+            (void)a_ssd1306_batch_leave(handle, own, 0);                                    /* drop the batch */
+            a_ssd1306_job_fail(handle);                                                     /* abort the job */
+            a_ssd1306_job_reap(handle);                                                     /* resend the panel ram next time */
+            
+            return 1;                                                                       /* return error */
+        }
+        a_ssd1306_job_complete(handle);                                                     /* transfer done */
+    }
+    a_ssd1306_job_finish(handle);                                                           /* job done */
+    if (a_ssd1306_batch_leave(handle, own, 1) != 0)                                         /* send the batch */
+    {
+        return 1;                                                                           /* return error */
+    }
+    
+    return 0;                                                                               /* success return 0 */
+}
+
+/**
+ * @brief     fill the gram and the panel with a pattern
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] pattern fill byte of every column in a page
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the filled gram is sent as one full frame burst,
+ *            the dirty marks of both buffers are cleared
+ */
+static uint8_t a_ssd1306_fill(ssd1306_handle_t *handle, uint8_t pattern)
+{
+    handle->pending_len = 0;                                                                /* the fill covers the span */
+    memset(handle->gram_draw, pattern, sizeof(handle->gram));                               /* fill the draw buffer */
+    memset(handle->gram_flush, pattern, sizeof(handle->gram));                              /* fill the flush buffer */
+    handle->back_dirty_page = 0;                                                            /* the fill covers the back marks */
+    memset(handle->back_dirty_column_min, 0, sizeof(handle->back_dirty_column_min));        /* clear the back min columns */
+    memset(handle->back_dirty_column_max, 0, sizeof(handle->back_dirty_column_max));        /* clear the back max columns */
+    
+    return a_ssd1306_flush(handle, SSD1306_FLUSH_SOURCE_ALL, 1);                            /* write the full frame */
+}
+
+/**
+ * @brief     start the next asynchronous transfer of the flush job
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the job is finished when no transfer is left
+ */
+static uint8_t a_ssd1306_job_kick(ssd1306_handle_t *handle)
+{
+    uint8_t res;
+    uint16_t len;
+    ssd1306_flush_job_t *job = &handle->job;
+    
+    if (a_ssd1306_job_prepare(handle) == 0)                                                 /* if no transfer is left */
+    {
+        a_ssd1306_job_finish(handle);                                                       /* job done */
+        
+        return 0;                                                                           /* success return 0 */
+    }
+    len = a_ssd1306_job_chunk(handle);                                                      /* get the length */
+    a_ssd1306_track(handle, job->data, len, job->dc);                                       /* track the addressing state */
+    job->busy = 1;                                                                          /* transfer in flight */
+    if (handle->iic_spi == SSD1306_INTERFACE_IIC)                                           /* if iic */
+    {
+        a_ssd1306_count(handle, (uint16_t)(len + 1));                                       /* count the frame */
+        if (handle->iic_write_async_ctx != NULL)                                            /* if ctx */
+        {
+            res = handle->iic_write_async_ctx(handle->user_ctx, handle->iic_addr, 
+                                              (job->dc != 0) ? 0x40 : 0x00, job->data, len);/* start the write with the ctx */
+        }
+        else
+        {
+            res = handle->iic_write_async(handle->iic_addr, (job->dc != 0) ? 0x40 : 0x00, 
+                                          job->data, len);                                  /* start the write */
+        }
+    }
+    else
+    {
+        res = a_ssd1306_dc_write(handle, job->dc);                                          /* write data command */
+        if (res == 0)                                                                       /* check the result */
+        {
+            a_ssd1306_count(handle, len);                                                   /* count the transfer */
+            if (handle->spi_write_cmd_async_ctx != NULL)                                    /* if ctx */
+            {
+                res = handle->spi_write_cmd_async_ctx(handle->user_ctx, job->data, len);    /* start the write with the ctx */
+            }
+            else
+            {
+                res = handle->spi_write_cmd_async(job->data, len);                          /* start the write */
+            }
+        }
+    }
+    if (res != 0)                                                                           /* check the result */
+    {
+        job->busy = 0;                                                                      /* no transfer */
+        job->error = 1;                                                                     /* flag error */
+        a_ssd1306_job_fail(handle);                                                         /* abort the job */
+        
+        return 1;                                                                           /* return error */
+    }
+    
+    return 0;                                                                               /* success return 0 */
+}
+
+/**
+ * @brief     draw a point in gram
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] x coordinate x
+ * @param[in] y coordinate y
+ * @param[in] data written data
+ * @return    status code
+ *            - 0 success
+ *            - 1 gram draw point failed
+ * @note      none
+ */
+static uint8_t a_ssd1306_gram_draw_point(ssd1306_handle_t *handle, uint8_t x, uint8_t y, uint8_t data)
+{
+    uint8_t pos;
+    uint8_t bx;
+    uint8_t temp = 0;
+    
+    pos = y / 8;                                /* get y page */
+    bx = y % 8;                                 /* get y point */
+    temp = 1 << bx;                             /* set data */
+    a_ssd1306_gram_mark_dirty(handle, x, pos);  /* mark dirty */
+    if (data != 0)                              /* if 1  */
+    {
+        handle->gram_draw[x][pos] |= temp;      /* set 1 */
+    }
+    else
+    {
+        handle->gram_draw[x][pos] &= ~temp;     /* set 0 */
+    }
+  
+    return 0;                                   /* success return 0 */
+}
+
+/**
+ * @brief     draw a char in gram
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] x coordinate x
+ * @param[in] y coordinate y
+ * @param[in] chr written char
  * @param[in] size char size
  * @param[in] mode display mode
  * @return    status code
  *            - 0 success
- *            - 1 gram show char failed
- * @note      none
+ *            - 1 gram show char failed
+ * @note      none
+ */
+static uint8_t a_ssd1306_gram_show_char(ssd1306_handle_t *handle, uint8_t x, uint8_t y, uint8_t chr, uint8_t size, uint8_t mode)
+{
+    uint8_t temp, t, t1;
+    uint8_t y0 = y;
+    uint8_t csize = (size / 8 + ((size % 8) ? 1 : 0)) * (size / 2);                 /* get size */
+    
+    chr = chr - ' ';                                                                /* get index */
+    for (t = 0; t < csize; t++)                                                     /* write size */
+    {   
+        if (size == 12)                                                             /* if size 12 */
+        {
+            temp = gsc_ssd1306_ascii_1206[chr][t];                                  /* get ascii 1206 */
+        }
+        else if (size == 16)                                                        /* if size 16 */
+        {
+            temp = gsc_ssd1306_ascii_1608[chr][t];                                  /* get ascii 1608 */
+        }
+        else if(size == 24)                                                         /* if size 24 */
+        {
+            temp = gsc_ssd1306_ascii_2412[chr][t];                                  /* get ascii 2412 */
+        }
+        else
+        {
+            return 1;                                                               /* return error */
+        }
+        for (t1 = 0; t1 < 8; t1++)                                                  /* write one line */
+        {
+            if ((temp & 0x80) != 0)                                                 /* if 1 */
+            {
+                if (a_ssd1306_gram_draw_point(handle, x, y, mode) != 0)             /* draw point */
+                {
+                    return 1;                                                       /* return error */
+                }
+            }
+            else 
+            {
+                if (a_ssd1306_gram_draw_point(handle, x, y, !mode) != 0)            /* draw point */
+                {
+                    return 1;                                                       /* return error */
+                }
+            }
+            temp <<= 1;                                                             /* left shift 1 */
+            y++;
+            if ((y - y0) == size)                                                   /* reset size */
+            {
+                y = y0;                                                             /* set y */
+                x++;                                                                /* x++ */
+                
+                break;                                                              /* break */
+            }
+        }
+    }
+  
+    return 0;                                                                       /* success return 0 */
+}
+
+/**
+ * @brief     clear the screen
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 clear failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 flush is busy
+ * @note      the gram is filled in memory and sent as one full frame burst
+ */
+uint8_t ssd1306_clear(ssd1306_handle_t *handle)
+{
+    if (handle == NULL)                                                                               /* check handle */
+    {
+        return 2;                                                                                     /* return error */
+    }
+    if (handle->inited != 1)                                                                          /* check handle initialization */
+    {
+        return 3;                                                                                     /* return error */
+    }
+    if (handle->job.active != 0)                                                                      /* check the job */
+    {
+        handle->debug_print("ssd1306: flush is busy.\n");                                             /* flush is busy */
+        
+        return 4;                                                                                     /* return error */
+    }
+    
+    if (a_ssd1306_fill(handle, 0x00) != 0)                                                            /* fill the screen */
+    {
+        handle->debug_print("ssd1306: clear failed.\n");                                              /* clear failed */
+        
+        return 1;                                                                                     /* return error */
+    }
+    
+    return 0;                                                                                         /* success return 0 */
+}
+
+/**
+ * @brief     fill the screen with a pattern
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] pattern fill byte of every column in a page
+ * @return    status code
+ *            - 0 success
+ *            - 1 fill failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 flush is busy
+ * @note      the gram is filled in memory and sent as one full frame burst
+ */
+uint8_t ssd1306_fill(ssd1306_handle_t *handle, uint8_t pattern)
+{
+    if (handle == NULL)                                                                               /* check handle */
+    {
+        return 2;                                                                                     /* return error */
+    }
+    if (handle->inited != 1)                                                                          /* check handle initialization */
+    {
+        return 3;                                                                                     /* return error */
+    }
+    if (handle->job.active != 0)                                                                      /* check the job */
+    {
+        handle->debug_print("ssd1306: flush is busy.\n");                                             /* flush is busy */
+        
+        return 4;                                                                                     /* return error */
+    }
+    
+    if (a_ssd1306_fill(handle, pattern) != 0)                                                         /* fill the screen */
+    {
+        handle->debug_print("ssd1306: fill failed.\n");                                               /* fill failed */
+        
+        return 1;                                                                                     /* return error */
+    }
+    
+    return 0;                                                                                         /* success return 0 */
+}
+
+/**
+ * @brief      check a command stream
+ * @param[in]  *table pointer to a command buffer
+ * @param[in]  len buffer length
+ * @param[out] *scroll pointer to a scroll flag buffer, 1 if the stream leaves the scroll on
+ * @return     status code
+ *             - 0 success
+ *             - 1 a command is split
+ * @note       none
+ */
+static uint8_t a_ssd1306_table_check(const uint8_t *table, uint16_t len, uint8_t *scroll)
+{
+    uint16_t i;
+    uint8_t args;
+    
+    *scroll = 0;                                                                                      /* scroll is not set */
+    for (i = 0; i < len; i += (uint16_t)(1 + args))                                                   /* parse the table */
+    {
+        args = a_ssd1306_cmd_args(table[i]);                                                          /* get the arguments */
+        if ((i + args) >= len)                                                                        /* check the arguments */
+        {
+            return 1;                                                                                 /* return error */
+        }
+        if (table[i] == SSD1306_CMD_ACTIVATE_SCROLL)                                                  /* if activate scroll */
+        {
+            *scroll = 1;                                                                              /* scroll is set */
+        }
+        else if (table[i] == SSD1306_CMD_DEACTIVATE_SCROLL)                                           /* if deactivate scroll */
+        {
+            *scroll = 0;                                                                              /* scroll is not set */
+        }
+    }
+    
+    return 0;                                                                                         /* success return 0 */
+}
+
+/**
+ * @brief     load an init table and clear the screen
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] *table pointer to an init table buffer
+ * @param[in] len table length
+ * @return    status code
+ *            - 0 success
+ *            - 1 load init table failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 table is invalid
+ *            - 5 flush is busy
+ * @note      the table is built with the SSD1306_INIT_* macros and sent in one command burst
+ *            after a full frame clear
+ */
+uint8_t ssd1306_load_init_table(ssd1306_handle_t *handle, const uint8_t *table, uint16_t len)
+{
+    uint8_t scroll;
+    
+    if (handle == NULL)                                                                               /* check handle */
+    {
+        return 2;                                                                                     /* return error */
+    }
+    if (handle->inited != 1)                                                                          /* check handle initialization */
+    {
+        return 3;                                                                                     /* return error */
+    }
+    if ((table == NULL) || (len == 0))                                                                /* check the table */
+    {
+        handle->debug_print("ssd1306: table is invalid.\n");                                          /* table is invalid */
+        
+        return 4;                                                                                     /* return error */
+    }
+    
+    if (a_ssd1306_table_check(table, len, &scroll) != 0)                                              /* parse the table */
+    {
+        handle->debug_print("ssd1306: table is invalid.\n");                                          /* table is invalid */
+        
+        return 4;                                                                                     /* return error */
+    }
+    if (handle->job.active != 0)                                                                      /* check the job */
+    {
+        handle->debug_print("ssd1306: flush is busy.\n");                                             /* flush is busy */
+        
+        return 5;                                                                                     /* return error */
+    }
+    
+    if (a_ssd1306_fill(handle, 0x00) != 0)                                                            /* clear the screen */
+    {
+        handle->debug_print("ssd1306: clear failed.\n");                                              /* clear failed */
+        
+        return 1;                                                                                     /* return error */
+    }
+    if ((a_ssd1306_mode_restore(handle) != 0) || 
+        (a_ssd1306_multiple_write_byte(handle, (uint8_t *)table, len, SSD1306_CMD) != 0))             /* write the table */
+    {
+        handle->debug_print("ssd1306: write table failed.\n");                                        /* write table failed */
+        
+        return 1;                                                                                     /* return error */
+    }
+    a_ssd1306_mode_save(handle);                                                                      /* save the application mode */
+    if (scroll != 0)                                                                                  /* if the scroll is on */
+    {
+        a_ssd1306_panel_invalidate(handle);                                                           /* scroll moves the panel ram */
+    }
+    
+    return 0;                                                                                         /* success return 0 */
+}
+
+/**
+ * @brief     update the gram data
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 gram update failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      the flush plan is chosen by the transport cost model
+ */
+uint8_t ssd1306_gram_update(ssd1306_handle_t *handle)
+{
+    if (handle == NULL)                                                                               /* check handle */
+    {
+        return 2;                                                                                     /* return error */
+    }
+    if (handle->inited != 1)                                                                          /* check handle initialization */
+    {
+        return 3;                                                                                     /* return error */
+    }
+    
+    if (a_ssd1306_flush(handle, SSD1306_FLUSH_SOURCE_ALL, 0) != 0)                                    /* flush the gram */
+    {
+        handle->debug_print("ssd1306: flush failed.\n");                                              /* flush failed */
+        
+        return 1;                                                                                     /* return error */
+    }
+    
+    return 0;                                                                                         /* success return 0 */
+}
+
+/**
+ * @brief     update the whole gram data in one transfer
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 gram update frame failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      the frame is sent in vertical addressing mode with the full window,
+ *            which matches the gram layout so the frame is sent in one burst, from its
+ *            snapshot in the shadow if SSD1306_SHADOW_ENABLE is set,
+ *            the next raw address or data call puts the application mode back
+ */
+uint8_t ssd1306_gram_update_frame(ssd1306_handle_t *handle)
+{
+    if (handle == NULL)                                                                               /* check handle */
+    {
+        return 2;                                                                                     /* return error */
+    }
+    if (handle->inited != 1)                                                                          /* check handle initialization */
+    {
+        return 3;                                                                                     /* return error */
+    }
+    
+    if (a_ssd1306_flush(handle, SSD1306_FLUSH_SOURCE_ALL, 1) != 0)                                    /* write the frame */
+    {
+        handle->debug_print("ssd1306: write frame failed.\n");                                        /* write frame failed */
+        
+        return 1;                                                                                     /* return error */
+    }
+    
+    return 0;                                                                                         /* success return 0 */
+}
+
+/**
+ * @brief     update the dirty gram data
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 gram update dirty failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      only the dirty column span of each dirty page is sent,
+ *            the flush plan is chosen by the transport cost model
+ */
+uint8_t ssd1306_gram_update_dirty(ssd1306_handle_t *handle)
+{
+    if (handle == NULL)                                                                               /* check handle */
+    {
+        return 2;                                                                                     /* return error */
+    }
+    if (handle->inited != 1)                                                                          /* check handle initialization */
+    {
+        return 3;                                                                                     /* return error */
+    }
+    
+    if (a_ssd1306_flush(handle, SSD1306_FLUSH_SOURCE_DIRTY, 0) != 0)                                  /* flush the gram */
+    {
+        handle->debug_print("ssd1306: flush failed.\n");                                              /* flush failed */
+        
+        return 1;                                                                                     /* return error */
+    }
+    
+    return 0;                                                                                         /* success return 0 */
+}
+
+/**
+ * @brief     update the changed gram data
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 gram update diff failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 shadow is disabled
+ * @note      the gram is compared with the last data sent to the panel and only
+ *            the changed runs are sent, the flush plan is chosen by the transport
+ *            cost model, it needs SSD1306_SHADOW_ENABLE
+ */
+uint8_t ssd1306_gram_update_diff(ssd1306_handle_t *handle)
+{
+    if (handle == NULL)                                                                               /* check handle */
+    {
+        return 2;                                                                                     /* return error */
+    }
+    if (handle->inited != 1)                                                                          /* check handle initialization */
+    {
+        return 3;                                                                                     /* return error */
+    }
+#if (SSD1306_SHADOW_ENABLE == 0)
+    handle->debug_print("ssd1306: shadow is disabled.\n");                                            /* shadow is disabled */
+    
+    return 4;                                                                                         /* return error */
+#else
+    
+    if (a_ssd1306_flush(handle, SSD1306_FLUSH_SOURCE_DIFF, 0) != 0)                                   /* flush the gram */
+    {
+        handle->debug_print("ssd1306: flush failed.\n");                                              /* flush failed */
+        
+        return 1;                                                                                     /* return error */
+    }
+    
+    return 0;                                                                                         /* success return 0 */
+#endif
+}
+
+/**
+ * @brief     start an asynchronous gram update
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] source flush source
+ * @return    status code
+ *            - 0 success
+ *            - 1 gram update async failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 async write is not linked
+ *            - 5 flush is busy
+ *            - 6 shadow is disabled
+ * @note      the gram and the other driver functions can't be used until
+ *            ssd1306_flush_poll reports the flush is not busy, the gram functions
+ *            return busy unless they draw in a back buffer
+ */
+uint8_t ssd1306_gram_update_async(ssd1306_handle_t *handle, ssd1306_flush_source_t source)
+{
+    uint8_t res;
+    
+    if (handle == NULL)                                                                               /* check handle */
+    {
+        return 2;                                                                                     /* return error */
+    }
+    if (handle->inited != 1)                                                                          /* check handle initialization */
+    {
+        return 3;                                                                                     /* return error */
+    }
+    if (((handle->iic_spi == SSD1306_INTERFACE_IIC) && (handle->iic_write_async == NULL) && 
+         (handle->iic_write_async_ctx == NULL)) ||
+        ((handle->iic_spi == SSD1306_INTERFACE_SPI) && (handle->spi_write_cmd_async == NULL) && 
+         (handle->spi_write_cmd_async_ctx == NULL)))                                                  /* check the async write */
+    {
+        handle->debug_print("ssd1306: async write is null.\n");                                       /* async write is null */
+        
+        return 4;                                                                                     /* return error */
+    }
+    if (handle->job.active != 0)                                                                      /* check the job */
+    {
+        handle->debug_print("ssd1306: flush is busy.\n");                                             /* flush is busy */
+        
+        return 5;                                                                                     /* return error */
+    }
+#if (SSD1306_SHADOW_ENABLE == 0)
+    if (source == SSD1306_FLUSH_SOURCE_DIFF)                                                          /* if no shadow to compare */
+    {
+        handle->debug_print("ssd1306: shadow is disabled.\n");                                        /* shadow is disabled */
+        
+        return 6;                                                                                     /* return error */
+    }
+#endif
+    if (handle->batch.open != 0)                                                                      /* if a batch is open */
+    {
+#if (SSD1306_BATCH_ENABLE != 0)
+        res = a_ssd1306_batch_send(handle);                                                           /* send the batched writes first */
+#else
+        res = 0;                                                                                      /* the writes are already sent */
+#endif
+        if (a_ssd1306_transfer_end(handle) != 0)                                                      /* submit the queued writes */
+        {
+            res = 1;                                                                                  /* set error */
+        }
+        a_ssd1306_link_transfer_begin(handle);                                                        /* queue the rest of the batch */
+        if (res != 0)                                                                                 /* check the result */
+        {
+            handle->debug_print("ssd1306: batch send failed.\n");                                     /* batch send failed */
+            
+            return 1;                                                                                 /* return error */
+        }
+    }
+    
+    a_ssd1306_job_reap(handle);                                                                       /* resend a lost panel ram */
+    if (a_ssd1306_pending_flush(handle) != 0)                                                         /* send the pending span */
+    {
+        handle->debug_print("ssd1306: flush pending failed.\n");                                      /* flush pending failed */
+        
+        return 1;                                                                                     /* return error */
+    }
+    
+    handle->job.error = 0;                                                                            /* clear error */
+    if (a_ssd1306_job_plan(handle, (uint8_t)source, 0) == 0)                                          /* plan the job */
+    {
+        return 0;                                                                                     /* success return 0 */
+    }
+    handle->job.active = 1;                                                                           /* job active */
+    handle->job.async = 1;                                                                            /* asynchronous job */
+    if (a_ssd1306_job_kick(handle) != 0)                                                              /* start the first write */
+    {
+        handle->debug_print("ssd1306: async write failed.\n");                                        /* async write failed */
+        
+        return 1;                                                                                     /* return error */
+    }
+    
+    return 0;                                                                                         /* success return 0 */
+}
+
+/**
+ * @brief      poll the flush status
+ * @param[in]  *handle pointer to an ssd1306 handle structure
+ * @param[out] *status pointer to a flush status buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       an error status is reported once and then cleared,
+ *             the panel ram lost by the failed job is marked dirty here or at the next update
+ */
+uint8_t ssd1306_flush_poll(ssd1306_handle_t *handle, ssd1306_flush_status_t *status)
+{
+    if (handle == NULL)                                           /* check handle */
+    {
+        return 2;                                                 /* return error */
+    }
+    if (handle->inited != 1)                                      /* check handle initialization */
+    {
+        return 3;                                                 /* return error */
+    }
+    
+    if (handle->job.active != 0)                                  /* if the job is active */
+    {
+        *status = SSD1306_FLUSH_STATUS_BUSY;                      /* busy */
+    }
+    else if (handle->job.error != 0)                              /* if the job failed */
+    {
+        a_ssd1306_job_reap(handle);                               /* resend the panel ram next time */
+        handle->job.error = 0;                                    /* clear error */
+        *status = SSD1306_FLUSH_STATUS_ERROR;                     /* error */
+    }
+    else
+    {
+        *status = SSD1306_FLUSH_STATUS_DONE;                      /* done */
+    }
+    
+    return 0;                                                     /* success return 0 */
+}
+
+/**
+ * @brief     irq handler
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 run failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      call it when an asynchronous write is done, it starts the next write
+ */
+uint8_t ssd1306_flush_irq_handler(ssd1306_handle_t *handle)
+{
+    if (handle == NULL)                                           /* check handle */
+    {
+        return 2;                                                 /* return error */
+    }
+    if (handle->inited != 1)                                      /* check handle initialization */
+    {
+        return 3;                                                 /* return error */
+    }
+    if (handle->job.busy == 0)                                    /* check the transfer */
+    {
+        return 0;                                                 /* success return 0 */
+    }
+    
+    handle->job.busy = 0;                                         /* transfer done */
+    a_ssd1306_job_complete(handle);                               /* complete the transfer */
+    if (a_ssd1306_job_kick(handle) != 0)                          /* start the next write */
+    {
+        return 1;                                                 /* return error */
+    }
+    
+    return 0;                                                     /* success return 0 */
+}
+
+/**
+ * @brief     swap the drawing and the flushing gram buffers
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 flush is busy
+ * @note      the new drawing buffer starts as a copy of the swapped frame,
+ *            the dirty marks of the drawn frame are handed to the next flush,
+ *            it does nothing without a back buffer
+ */
+uint8_t ssd1306_gram_swap(ssd1306_handle_t *handle)
+{
+    uint8_t (*buf)[8];
+    
+    if (handle == NULL)                                                     /* check handle */
+    {
+        return 2;                                                           /* return error */
+    }
+    if (handle->inited != 1)                                                /* check handle initialization */
+    {
+        return 3;                                                           /* return error */
+    }
+    if (handle->job.active != 0)                                            /* check the job */
+    {
+        handle->debug_print("ssd1306: flush is busy.\n");                   /* flush is busy */
+        
+        return 4;                                                           /* return error */
+    }
+    if (handle->gram_draw == handle->gram_flush)                            /* if single buffer */
+    {
+        return 0;                                                           /* success return 0 */
+    }
+    
+    a_ssd1306_lock(handle);                                                 /* lock the gram */
+    a_ssd1306_back_dirty_merge(handle);                                     /* hand the drawing marks to the flush */
+    buf = handle->gram_flush;                                               /* save the flushing buffer */
+    handle->gram_flush = handle->gram_draw;                                 /* flush the drawn frame */
+    handle->gram_draw = buf;                                                /* draw in the other buffer */
+    memcpy(handle->gram_draw, handle->gram_flush, sizeof(handle->gram));    /* start from the swapped frame */
+    a_ssd1306_unlock(handle);                                               /* unlock the gram */
+    
+    return 0;                                                               /* success return 0 */
+}
+
+/**
+ * @brief      run one bounded step of a gram update
+ * @param[in]  *handle pointer to an ssd1306 handle structure
+ * @param[in]  source flush source
+ * @param[in]  max_len max bytes sent in this call
+ * @param[out] *status pointer to a flush status buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 gram update step failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 flush is busy
+ *             - 5 shadow is disabled
+ * @note       a new update is planned when no update is in progress, 0 max_len means one page,
+ *             at least one write is done in each call and a command is never split,
+ *             the gram functions return busy between the steps unless they draw in a back buffer
+ */
+uint8_t ssd1306_gram_update_step(ssd1306_handle_t *handle, ssd1306_flush_source_t source, 
+                                 uint16_t max_len, ssd1306_flush_status_t *status)
+{
+    uint16_t len;
+    uint16_t sent;
+    ssd1306_flush_job_t *job;
+    
+    if (handle == NULL)                                                                  /* check handle */
+    {
+        return 2;                                                                        /* return error */
+    }
+    if (handle->inited != 1)                                                             /* check handle initialization */
+    {
+        return 3;                                                                        /* return error */
+    }
+    
+    job = &handle->job;                                                                  /* get the job */
+    if ((job->active != 0) && (job->async != 0))                                         /* check the job */
+    {
+        handle->debug_print("ssd1306: flush is busy.\n");                                /* flush is busy */
+        
+        return 4;                                                                        /* return error */
+    }
+#if (SSD1306_SHADOW_ENABLE == 0)
+    if (source == SSD1306_FLUSH_SOURCE_DIFF)                                             /* if no shadow to compare */
+    {
+        handle->debug_print("ssd1306: shadow is disabled.\n");                           /* shadow is disabled */
+        
+        return 5;                                                                        /* return error */
+    }
+#endif
+    if (job->active == 0)                                                                /* if no update */
+    {
+        a_ssd1306_job_reap(handle);                                                      /* resend a lost panel ram */
+        if (a_ssd1306_pending_flush(handle) != 0)                                        /* send the pending span */
+        {
+            *status = SSD1306_FLUSH_STATUS_ERROR;                                        /* error */
+            handle->debug_print("ssd1306: flush pending failed.\n");                     /* flush pending failed */
+            
+            return 1;                                                                    /* return error */
+        }
+        if (a_ssd1306_job_plan(handle, (uint8_t)source, 0) == 0)                         /* plan the job */
+        {
+            *status = SSD1306_FLUSH_STATUS_DONE;                                         /* done */
+            
+            return 0;                                                                    /* success return 0 */
+        }
+        job->active = 1;                                                                 /* job active */
+    }
+    if (max_len == 0)                                                                    /* if one page */
+    {
+        max_len = 128;                                                                   /* set one page */
+    }
+    sent = 0;                                                                            /* init sent */
+    while ((sent < max_len) && (a_ssd1306_job_prepare(handle) != 0))                     /* send in the budget */
+    {
+        len = a_ssd1306_job_chunk(handle);                                               /* get the length */
+        if (job->dc == SSD1306_CMD)                                                      /* if command */
+        {
+            if ((sent != 0) && ((sent + len) > max_len))                                 /* if the command doesn't fit */
+            {
+                break;                                                                   /* next call */
+            }
+        }
+        else if (len > (max_len - sent))                                                 /* if the data doesn't fit */
+        {
+            len = max_len - sent;                                                        /* cut the data */
+            job->chunk = len;                                                            /* set the chunk */
+        }
+        if (a_ssd1306_multiple_write_byte(handle, job->data, len, job->dc) != 0)         /* write the transfer */
+        {
+            a_ssd1306_job_fail(handle);                                                  /* abort the job */
+            a_ssd1306_job_reap(handle);                                                  /* resend the panel ram next time */
+            *status = SSD1306_FLUSH_STATUS_ERROR;                                        /* error */
+            handle->debug_print("ssd1306: flush failed.\n");                             /* flush failed */
+            
+            return 1;                                                                    /* return error */
+        }
+        a_ssd1306_job_complete(handle);                                                  /* transfer done */
+        sent += len;                                                                     /* update sent */
+    }
+    if ((job->len == 0) && (a_ssd1306_job_prepare(handle) == 0))                         /* if nothing is left */
+    {
+        a_ssd1306_job_finish(handle);                                                    /* job done */
+        *status = SSD1306_FLUSH_STATUS_DONE;                                             /* done */
+    }
+    else
+    {
+        *status = SSD1306_FLUSH_STATUS_BUSY;                                             /* in progress */
+    }
+    
+    return 0;                                                                            /* success return 0 */
+}
+
+/**
+ * @brief     init a bus scheduler
+ * @param[in] *bus pointer to an ssd1306 bus structure
+ * @param[in] quantum max bytes sent for one panel in one turn
+ * @return    status code
+ *            - 0 success
+ *            - 2 bus is NULL
+ * @note      0 quantum means one page
+ */
+uint8_t ssd1306_bus_init(ssd1306_bus_t *bus, uint16_t quantum)
+{
+    if (bus == NULL)                                                                     /* check bus */
+    {
+        return 2;                                                                        /* return error */
+    }
+    
+    memset(bus, 0, sizeof(ssd1306_bus_t));                                               /* clear the bus */
+    bus->quantum = quantum;                                                              /* set the quantum */
+    
+    return 0;                                                                            /* success return 0 */
+}
+
+/**
+ * @brief     add a panel to a bus scheduler
+ * @param[in] *bus pointer to an ssd1306 bus structure
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 bus or handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 bus is full
+ *            - 5 panel is already on the bus
+ * @note      none
+ */
+uint8_t ssd1306_bus_add(ssd1306_bus_t *bus, ssd1306_handle_t *handle)
+{
+    uint8_t i;
+    
+    if ((bus == NULL) || (handle == NULL))                                               /* check bus and handle */
+    {
+        return 2;                                                                        /* return error */
+    }
+    if (handle->inited != 1)                                                             /* check handle initialization */
+    {
+        return 3;                                                                        /* return error */
+    }
+    if (bus->count >= SSD1306_BUS_MAX_PANEL)                                             /* check the count */
+    {
+        handle->debug_print("ssd1306: bus is full.\n");                                  /* bus is full */
+        
+        return 4;                                                                        /* return error */
+    }
+    for (i = 0; i < bus->count; i++)                                                     /* check the panels */
+    {
+        if (bus->panel[i] == handle)                                                     /* if already added */
+        {
+            handle->debug_print("ssd1306: panel is already on the bus.\n");              /* panel is already on the bus */
+            
+            return 5;                                                                    /* return error */
+        }
+    }
+    
+    bus->panel[bus->count] = handle;                                                     /* add the panel */
+    bus->count++;                                                                        /* count++ */
+    
+    return 0;                                                                            /* success return 0 */
+}
+
+/**
+ * @brief     check if a panel has flush work for the bus scheduler
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @return    1 if the panel has work, else 0
+ * @note      a panel with an asynchronous flush in flight is skipped
+ */
+static uint8_t a_ssd1306_bus_work(ssd1306_handle_t *handle)
+{
+    if (handle->job.active != 0)                                                         /* if an update is in progress */
+    {
+        return (handle->job.async == 0) ? 1 : 0;                                         /* only a stepped update */
+    }
+    
+    return ((handle->dirty_page != 0) || (handle->pending_len != 0)) ? 1 : 0;            /* dirty or pending */
+}
+
+/**
+ * @brief      run one turn of a bus scheduler
+ * @param[in]  *bus pointer to an ssd1306 bus structure
+ * @param[out] *status pointer to a flush status buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 bus flush step failed
+ *             - 2 bus is NULL
+ * @note       the next panel with dirty data after the last served one gets one bounded update step,
+ *             so every dirty panel is served within one turn per panel on the bus,
+ *             status is busy while any panel still has dirty data
+ */
+uint8_t ssd1306_bus_flush_step(ssd1306_bus_t *bus, ssd1306_flush_status_t *status)
+{
+    uint8_t i;
+    uint8_t n;
+    uint8_t res;
+    uint32_t bytes;
+    uint32_t count;
+    uint32_t toggles;
+    ssd1306_cost_model_t model;
+    ssd1306_flush_status_t step;
+    ssd1306_handle_t *handle;
+    
+    if (bus == NULL)                                                                     /* check bus */
+    {
+        return 2;                                                                        /* return error */
+    }
+    
+    i = 0;                                                                               /* init the index */
+    for (n = 0; n < bus->count; n++)                                                     /* find the next panel */
+    {
+        i = (uint8_t)((bus->next + n) % bus->count);                                     /* round robin */
+        if (a_ssd1306_bus_work(bus->panel[i]) != 0)                                      /* if work */
+        {
+            break;                                                                       /* found */
+        }
+    }
+    if (n == bus->count)                                                                 /* if no work */
+    {
+        *status = SSD1306_FLUSH_STATUS_DONE;                                             /* done */
+        
+        return 0;                                                                        /* success return 0 */
+    }
+    
+    handle = bus->panel[i];                                                              /* get the panel */
+    bus->next = (uint8_t)((i + 1) % bus->count);                                         /* serve the next one later */
+    bytes = handle->tx_bytes;                                                            /* save bytes */
+    count = handle->tx_count;                                                            /* save transactions */
+    toggles = handle->dc_toggle_count;                                                   /* save toggles */
+    res = ssd1306_gram_update_step(handle, SSD1306_FLUSH_SOURCE_DIRTY, bus->quantum, &step);  /* run one step */
+    a_ssd1306_cost_model(handle, &model);                                                /* get the cost model */
+    bytes = handle->tx_bytes - bytes;                                                    /* get the bytes */
+    count = handle->tx_count - count;                                                    /* get the transactions */
+    toggles = handle->dc_toggle_count - toggles;                                         /* get the toggles */
+    bus->stats.bytes += bytes;                                                           /* add bytes */
+    bus->stats.transactions += count;                                                    /* add transactions */
+    bus->stats.estimated_cost += count * model.transaction_cost + bytes * model.byte_cost + 
+                                 toggles * model.dc_switch_cost;                         /* add the estimated cost */
+    bus->stats.turns[i]++;                                                               /* add one turn */
+    if (res != 0)                                                                        /* check the result */
+    {
+        *status = SSD1306_FLUSH_STATUS_ERROR;                                            /* error */
+        
+        return 1;                                                                        /* return error */
+    }
+    
+    *status = SSD1306_FLUSH_STATUS_DONE;                                                 /* set done */
+    for (i = 0; i < bus->count; i++)                                                     /* check all panels */
+    {
+        if (a_ssd1306_bus_work(bus->panel[i]) != 0)                                      /* if work */
+        {
+            *status = SSD1306_FLUSH_STATUS_BUSY;                                         /* in progress */
+            
+            break;                                                                       /* break */
+        }
+    }
+    
+    return 0;                                                                            /* success return 0 */
+}
+
+/**
+ * @brief      get the bus scheduler statistics
+ * @param[in]  *bus pointer to an ssd1306 bus structure
+ * @param[out] *stats pointer to a bus statistics structure
+ * @return     status code
+ *             - 0 success
+ *             - 2 bus is NULL
+ * @note       stats.estimated_cost is summed from the cost model of each panel, the driver keeps no clock,
+ *             so a utilization is stats.estimated_cost over an elapsed time the caller measures in the same unit
+ */
+uint8_t ssd1306_bus_get_stats(ssd1306_bus_t *bus, ssd1306_bus_stats_t *stats)
+{
+    if (bus == NULL)                                                                     /* check bus */
+    {
+        return 2;                                                                        /* return error */
+    }
+    
+    *stats = bus->stats;                                                                 /* get the stats */
+    
+    return 0;                                                                            /* success return 0 */
+}
+
+/**
+ * @brief     clear the bus scheduler statistics
+ * @param[in] *bus pointer to an ssd1306 bus structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 bus is NULL
+ * @note      none
+ */
+uint8_t ssd1306_bus_clear_stats(ssd1306_bus_t *bus)
+{
+    if (bus == NULL)                                                                     /* check bus */
+    {
+        return 2;                                                                        /* return error */
+    }
+    
+    memset(&bus->stats, 0, sizeof(ssd1306_bus_stats_t));                                 /* clear the stats */
+    
+    return 0;                                                                            /* success return 0 */
+}
+
+/**
+ * @brief     init a panel group
+ * @param[in] *group pointer to an ssd1306 group structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 group is NULL
+ * @note      none
+ */
+uint8_t ssd1306_group_init(ssd1306_group_t *group)
+{
+    if (group == NULL)                                                                   /* check group */
+    {
+        return 2;                                                                        /* return error */
+    }
+    
+    memset(group, 0, sizeof(ssd1306_group_t));                                           /* clear the group */
+    group->dc_level = 0xFF;                                                              /* the level is unknown */
+    
+    return 0;                                                                            /* success return 0 */
+}
+
+/**
+ * @brief     add a panel to a group
+ * @param[in] *group pointer to an ssd1306 group structure
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 group or handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 group is full
+ *            - 5 handle is not spi or is in a group
+ * @note      the panels of a group share sclk, mosi and the data command line and differ in chip select
+ */
+uint8_t ssd1306_group_add(ssd1306_group_t *group, ssd1306_handle_t *handle)
+{
+    if ((group == NULL) || (handle == NULL))                                             /* check group and handle */
+    {
+        return 2;                                                                        /* return error */
+    }
+    if (handle->inited != 1)                                                             /* check handle initialization */
+    {
+        return 3;                                                                        /* return error */
+    }
+    if (group->count >= SSD1306_GROUP_MAX_PANEL)                                         /* check the count */
+    {
+        handle->debug_print("ssd1306: group is full.\n");                                /* group is full */
+        
+        return 4;                                                                        /* return error */
+    }
+    if ((handle->iic_spi != SSD1306_INTERFACE_SPI) || (handle->group != NULL))           /* check the interface */
+    {
+        handle->debug_print("ssd1306: handle can't join the group.\n");                  /* handle can't join the group */
+        
+        return 5;                                                                        /* return error */
+    }
+    
+    handle->group = group;                                                               /* share the data command line */
+    group->dc_level = 0xFF;                                                              /* the level is unknown */
+    group->panel[group->count] = handle;                                                 /* add the panel */
+    group->count++;                                                                      /* count++ */
+    
+    return 0;                                                                            /* success return 0 */
+}
+
+/**
+ * @brief     check the panels of a group
+ * @param[in] *group pointer to an ssd1306 group structure
+ * @return    status code
+ *            - 0 success
+ *            - 3 group is empty or a panel is not initialized
+ *            - 5 flush is busy
+ * @note      none
+ */
+static uint8_t a_ssd1306_group_check(ssd1306_group_t *group)
+{
+    uint8_t i;
+    
+    if (group->count == 0)                                                               /* check the count */
+    {
+        return 3;                                                                        /* return error */
+    }
+    for (i = 0; i < group->count; i++)                                                   /* check all panels */
+    {
+        if (group->panel[i]->inited != 1)                                                /* check handle initialization */
+        {
+            return 3;                                                                    /* return error */
+        }
+        if ((group->panel[i]->job.active != 0) || (group->panel[i]->batch.open != 0))    /* check the job and the batch */
+        {
+            group->panel[i]->debug_print("ssd1306: flush is busy.\n");                   /* flush is busy */
+            
+            return 5;                                                                    /* return error */
+        }
+    }
+    
+    return 0;                                                                            /* success return 0 */
+}
+
+/**
+ * @brief     write a checked command stream to every panel of a group
+ * @param[in] *group pointer to an ssd1306 group structure
+ * @param[in] *buf pointer to a command buffer
+ * @param[in] len buffer length
+ * @param[in] scroll 1 if the stream leaves the scroll on
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      every panel tracks and counts the stream as if it was sent to it alone
+ */
+static uint8_t a_ssd1306_group_write(ssd1306_group_t *group, uint8_t *buf, uint16_t len, uint8_t scroll)
+{
+    uint8_t i;
+    uint8_t res;
+    
+    res = 0;                                                                             /* init res */
+    for (i = 0; i < group->count; i++)                                                   /* all panels */
+    {
+        if (a_ssd1306_mode_restore(group->panel[i]) != 0)                                /* put back the mode */
+        {
+            return 1;                                                                    /* return error */
+        }
+    }
+    if (group->spi_write_cmd_all != NULL)                                                /* if the stream can be broadcast */
+    {
+        if (a_ssd1306_dc_write(group->panel[0], SSD1306_CMD) != 0)                       /* write the shared data command line */
+        {
+            return 1;                                                                    /* return error */
+        }
+        group->tx_bytes += len;                                                          /* add bytes */
+        group->tx_count++;                                                               /* add one transaction */
+        res = group->spi_write_cmd_all(group->user_ctx, buf, len);                       /* write once with every chip select */
+        for (i = 0; i < group->count; i++)                                               /* all panels */
+        {
+            a_ssd1306_count(group->panel[i], len);                                       /* every panel received the stream */
+            if (res != 0)                                                                /* if failed */
+            {
+                a_ssd1306_address_forget(group->panel[i]);                               /* the state is unknown */
+            }
+            else
+            {
+                a_ssd1306_track(group->panel[i], buf, len, SSD1306_CMD);                 /* track the addressing state */
+            }
+        }
+    }
+    else
+    {
+        for (i = 0; i < group->count; i++)                                               /* all panels */
+        {
+            if (a_ssd1306_multiple_write_byte(group->panel[i], buf, len, SSD1306_CMD) != 0)  /* write the panel */
+            {
+                res = 1;                                                                 /* set error */
+                
+                break;                                                                   /* break */
+            }
+        }
+    }
+    for (i = 0; (res == 0) && (i < group->count); i++)                                   /* all panels */
+    {
+        a_ssd1306_mode_save(group->panel[i]);                                            /* save the application mode */
+        if (scroll != 0)                                                                 /* if the scroll is on */
+        {
+            a_ssd1306_panel_invalidate(group->panel[i]);                                 /* scroll moves the panel ram */
+        }
+    }
+    
+    return (res != 0) ? 1 : 0;                                                           /* return the result */
+}
+
+/**
+ * @brief     write a command stream to every panel of a group
+ * @param[in] *group pointer to an ssd1306 group structure
+ * @param[in] *buf pointer to a command buffer
+ * @param[in] len buffer length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write command failed
+ *            - 2 group is NULL
+ *            - 3 group is empty or a panel is not initialized
+ *            - 4 command stream is invalid
+ *            - 5 flush is busy
+ * @note      the stream is sent once with spi_write_cmd_all when it is linked, else once per panel
+ */
+uint8_t ssd1306_group_write_command(ssd1306_group_t *group, uint8_t *buf, uint16_t len)
+{
+    uint8_t res;
+    uint8_t scroll;
+    
+    if (group == NULL)                                                                   /* check group */
+    {
+        return 2;                                                                        /* return error */
+    }
+    res = a_ssd1306_group_check(group);                                                  /* check the panels */
+    if (res != 0)                                                                        /* check the result */
+    {
+        return res;                                                                      /* return error */
+    }
+    if ((buf == NULL) || (len == 0) || (a_ssd1306_table_check(buf, len, &scroll) != 0))  /* check the stream */
+    {
+        group->panel[0]->debug_print("ssd1306: command stream is invalid.\n");           /* command stream is invalid */
+        
+        return 4;                                                                        /* return error */
+    }
+    
+    if (a_ssd1306_group_write(group, buf, len, scroll) != 0)                             /* write the stream */
+    {
+        group->panel[0]->debug_print("ssd1306: write command failed.\n");                /* write command failed */
+        
+        return 1;                                                                        /* return error */
+    }
+    
+    return 0;                                                                            /* success return 0 */
+}
+
+/**
+ * @brief     load an init table to every panel of a group and clear the screens
+ * @param[in] *group pointer to an ssd1306 group structure
+ * @param[in] *table pointer to an init table buffer
+ * @param[in] len table length
+ * @return    status code
+ *            - 0 success
+ *            - 1 load init table failed
+ *            - 2 group is NULL
+ *            - 3 group is empty or a panel is not initialized
+ *            - 4 table is invalid
+ *            - 5 flush is busy
+ * @note      the screens are cleared panel by panel, the table is sent like ssd1306_group_write_command
+ */
+uint8_t ssd1306_group_load_init_table(ssd1306_group_t *group, const uint8_t *table, uint16_t len)
+{
+    uint8_t i;
+    uint8_t res;
+    uint8_t scroll;
+    
+    if (group == NULL)                                                                   /* check group */
+    {
+        return 2;                                                                        /* return error */
+    }
+    res = a_ssd1306_group_check(group);                                                  /* check the panels */
+    if (res != 0)                                                                        /* check the result */
+    {
+        return res;                                                                      /* return error */
+    }
+    if ((table == NULL) || (len == 0) || (a_ssd1306_table_check(table, len, &scroll) != 0))  /* check the table */
+    {
+        group->panel[0]->debug_print("ssd1306: table is invalid.\n");                    /* table is invalid */
+        
+        return 4;                                                                        /* return error */
+    }
+    
+    for (i = 0; i < group->count; i++)                                                   /* gram data is per panel */
+    {
+        if (a_ssd1306_fill(group->panel[i], 0x00) != 0)                                  /* clear the screen */
+        {
+            group->panel[i]->debug_print("ssd1306: clear failed.\n");                    /* clear failed */
+            
+            return 1;                                                                    /* return error */
+        }
+    }
+    if (a_ssd1306_group_write(group, (uint8_t *)table, len, scroll) != 0)                /* write the table */
+    {
+        group->panel[0]->debug_print("ssd1306: write table failed.\n");                  /* write table failed */
+        
+        return 1;                                                                        /* return error */
+    }
+    
+    return 0;                                                                            /* success return 0 */
+}
+
+/**
+ * @brief     enable or disable the display of every panel of a group
+ * @param[in] *group pointer to an ssd1306 group structure
+ * @param[in] on_off display on or off
+ * @return    status code
+ *            - 0 success
+ *            - 1 set display failed
+ *            - 2 group is NULL
+ *            - 3 group is empty or a panel is not initialized
+ *            - 5 flush is busy
+ * @note      none
+ */
+uint8_t ssd1306_group_set_display(ssd1306_group_t *group, ssd1306_display_t on_off)
+{
+    uint8_t res;
+    uint8_t buf[1];
+    
+    if (group == NULL)                                                                   /* check group */
+    {
+        return 2;                                                                        /* return error */
+    }
+    res = a_ssd1306_group_check(group);                                                  /* check the panels */
+    if (res != 0)                                                                        /* check the result */
+    {
+        return res;                                                                      /* return error */
+    }
+    
+    buf[0] = (on_off != 0) ? SSD1306_CMD_DISPLAY_ON : SSD1306_CMD_DISPLAY_OFF;          /* set display */
+    if (a_ssd1306_group_write(group, buf, 1, 0) != 0)                                    /* write the command */
+    {
+        group->panel[0]->debug_print("ssd1306: write command failed.\n");                /* write command failed */
+        
+        return 1;                                                                        /* return error */
+    }
+    
+    return 0;                                                                            /* success return 0 */
+}
+
+/**
+ * @brief     set the contrast of every panel of a group
+ * @param[in] *group pointer to an ssd1306 group structure
+ * @param[in] contrast display contrast
+ * @return    status code
+ *            - 0 success
+ *            - 1 set contrast failed
+ *            - 2 group is NULL
+ *            - 3 group is empty or a panel is not initialized
+ *            - 5 flush is busy
+ * @note      none
+ */
+uint8_t ssd1306_group_set_contrast(ssd1306_group_t *group, uint8_t contrast)
+{
+    uint8_t res;
+    uint8_t buf[2];
+    
+    if (group == NULL)                                                                   /* check group */
+    {
+        return 2;                                                                        /* return error */
+    }
+    res = a_ssd1306_group_check(group);                                                  /* check the panels */
+    if (res != 0)                                                                        /* check the result */
+    {
+        return res;                                                                      /* return error */
+    }
+    
+    buf[0] = SSD1306_CMD_CONTRAST_CONTROL;                                               /* set contrast control */
+    buf[1] = contrast;                                                                   /* set contrast */
+    if (a_ssd1306_group_write(group, buf, 2, 0) != 0)                                    /* write the command */
+    {
+        group->panel[0]->debug_print("ssd1306: write command failed.\n");                /* write command failed */
+        
+        return 1;                                                                        /* return error */
+    }
+    
+    return 0;                                                                            /* success return 0 */
+}
+
+/**
+ * @brief     swap the published frame index
+ * @param[in] *handoff pointer to an ssd1306 hand-off structure
+ * @param[in] state new state
+ * @return    old state
+ * @note      c11 atomics or the lock hooks
+ */
+static uint8_t a_ssd1306_handoff_exchange(ssd1306_handoff_t *handoff, uint8_t state)
+{
+#if (SSD1306_ATOMIC != 0)
+    return (uint8_t)atomic_exchange_explicit(&handoff->state, state, memory_order_acq_rel);  /* swap */
+#else
+    uint8_t old;
+    
+    a_ssd1306_lock(handoff->handle);                                                     /* lock */
+    old = handoff->state;                                                                /* get the old state */
+    handoff->state = state;                                                              /* set the new state */
+    a_ssd1306_unlock(handoff->handle);                                                   /* unlock */
+    
+    return old;                                                                          /* return the old state */
+#endif
+}
+
+/**
+ * @brief     init a frame hand-off
+ * @param[in] *handoff pointer to an ssd1306 hand-off structure
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 handoff or handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 no atomics and no lock linked
+ * @note      one renderer publishes frames and one flush task consumes them,
+ *            without c11 atomics the index swap is done under the lock hooks
+ */
+uint8_t ssd1306_handoff_init(ssd1306_handoff_t *handoff, ssd1306_handle_t *handle)
+{
+    if ((handoff == NULL) || (handle == NULL))                                           /* check handoff and handle */
+    {
+        return 2;                                                                        /* return error */
+    }
+    if (handle->inited != 1)                                                             /* check handle initialization */
+    {
+        return 3;                                                                        /* return error */
+    }
+    if ((SSD1306_ATOMIC == 0) && ((handle->lock == NULL) || (handle->unlock == NULL)))  /* check the lock */
+    {
+        handle->debug_print("ssd1306: no atomics and no lock linked.\n");                /* no atomics and no lock linked */
+        
+        return 4;                                                                        /* return error */
+    }
+    
+    memset(handoff->frame, 0, sizeof(handoff->frame));                                   /* clear the frames */
+    handoff->handle = handle;                                                            /* set the handle */
+    handoff->write = 0;                                                                  /* renderer draws in frame 0 */
+    handoff->read = 2;                                                                   /* flush task holds frame 2 */
+#if (SSD1306_ATOMIC != 0)
+    atomic_init(&handoff->state, 1);                                                     /* frame 1 is published */
+#else
+    handoff->state = 1;                                                                  /* frame 1 is published */
+#endif
+    
+    return 0;                                                                            /* success return 0 */
+}
+
+/**
+ * @brief      get the frame the renderer draws in
+ * @param[in]  *handoff pointer to an ssd1306 hand-off structure
+ * @param[out] **frame pointer to a frame pointer buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handoff is NULL
+ * @note       the frame is 1024 bytes in page format and holds an older frame, draw all of it,
+ *             it changes after every ssd1306_handoff_publish
+ */
+uint8_t ssd1306_handoff_get_frame(ssd1306_handoff_t *handoff, uint8_t **frame)
+{
+    if (handoff == NULL)                                                                 /* check handoff */
+    {
+        return 2;                                                                        /* return error */
+    }
+    
+    *frame = handoff->frame[handoff->write];                                             /* get the frame */
+    
+    return 0;                                                                            /* success return 0 */
+}
+
+/**
+ * @brief     publish the drawn frame
+ * @param[in] *handoff pointer to an ssd1306 hand-off structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 handoff is NULL
+ * @note      renderer only, never blocks on the flush, a frame not yet consumed is replaced
  */
-static uint8_t a_ssd1306_gram_show_char(ssd1306_handle_t *handle, uint8_t x, uint8_t y, uint8_t chr, uint8_t size, uint8_t mode)
+uint8_t ssd1306_handoff_publish(ssd1306_handoff_t *handoff)
 {
-    uint8_t temp, t, t1;
-    uint8_t y0 = y;
-    uint8_t csize = (size / 8 + ((size % 8) ? 1 : 0)) * (size / 2);                 /* get size */
+    uint8_t old;
     
-    chr = chr - ' ';                                                                /* get index */
-    for (t = 0; t < csize; t++)                                                     /* write size */
-    {   
-        if (size == 12)                                                             /* if size 12 */
-        {
-            temp = gsc_ssd1306_ascii_1206[chr][t];                                  /* get ascii 1206 */
-        }
-        else if (size == 16)                                                        /* if size 16 */
-        {
-            temp = gsc_ssd1306_ascii_1608[chr][t];                                  /* get ascii 1608 */
-        }
-        else if(size == 24)                                                         /* if size 24 */
-        {
-            temp = gsc_ssd1306_ascii_2412[chr][t];                                  /* get ascii 2412 */
-        }
-        else
-        {
-            return 1;                                                               /* return error */
-        }
-        for (t1 = 0; t1 < 8; t1++)                                                  /* write one line */
-        {
-            if ((temp & 0x80) != 0)                                                 /* if 1 */
-            {
-                if (a_ssd1306_gram_draw_point(handle, x, y, mode) != 0)             /* draw point */
-                {
-                    return 1;                                                       /* return error */
-                }
-            }
-            else 
-            {
-                if (a_ssd1306_gram_draw_point(handle, x, y, !mode) != 0)            /* draw point */
-                {
-                    return 1;                                                       /* return error */
-                }
-            }
-            temp <<= 1;                                                             /* left shift 1 */
-            y++;
-            if ((y - y0) == size)                                                   /* reset size */
-            {
-                y = y0;                                                             /* set y */
-                x++;                                                                /* x++ */
-                
-                break;                                                              /* break */
-            }
-        }
+    if (handoff == NULL)                                                                 /* check handoff */
+    {
+        return 2;                                                                        /* return error */
     }
-  
-    return 0;                                                                       /* success return 0 */
+    
+    old = a_ssd1306_handoff_exchange(handoff, 
+                                     (uint8_t)(handoff->write | SSD1306_HANDOFF_FRESH)); /* publish the frame */
+    handoff->write = old & SSD1306_HANDOFF_INDEX;                                        /* draw in the old published frame */
+    
+    return 0;                                                                            /* success return 0 */
 }
 
 /**
- * @brief     clear the screen
+ * @brief      consume the latest published frame
+ * @param[in]  *handoff pointer to an ssd1306 hand-off structure
+ * @param[out] *fresh pointer to a fresh flag buffer, 1 if a new frame is written to the gram
+ * @return     status code
+ *             - 0 success
+ *             - 2 handoff is NULL
+ *             - 3 handle is not initialized
+ * @note       flush task only, the changed bytes of the frame are marked dirty,
+ *             call a gram update afterwards
+ */
+uint8_t ssd1306_handoff_consume(ssd1306_handoff_t *handoff, uint8_t *fresh)
+{
+    uint8_t old;
+    
+    if (handoff == NULL)                                                                 /* check handoff */
+    {
+        return 2;                                                                        /* return error */
+    }
+    if ((handoff->handle == NULL) || (handoff->handle->inited != 1))                     /* check handle initialization */
+    {
+        return 3;                                                                        /* return error */
+    }
+    
+#if (SSD1306_ATOMIC != 0)
+    old = (uint8_t)atomic_load_explicit(&handoff->state, memory_order_acquire);          /* peek the state */
+#else
+    a_ssd1306_lock(handoff->handle);                                                     /* lock */
+    old = handoff->state;                                                                /* peek the state */
+    a_ssd1306_unlock(handoff->handle);                                                   /* unlock */
+#endif
+    if ((old & SSD1306_HANDOFF_FRESH) == 0)                                              /* if nothing new */
+    {
+        *fresh = 0;                                                                      /* not fresh */
+        
+        return 0;                                                                        /* success return 0 */
+    }
+    old = a_ssd1306_handoff_exchange(handoff, handoff->read);                            /* take the published frame */
+    handoff->read = old & SSD1306_HANDOFF_INDEX;                                         /* hold it */
+    *fresh = 1;                                                                          /* fresh */
+    
+    return ssd1306_gram_write_frame(handoff->handle, handoff->frame[handoff->read]);     /* write the gram */
+}
+
+/**
+ * @brief     init a command ring
+ * @param[in] *ring pointer to an ssd1306 ring structure
  * @param[in] *handle pointer to an ssd1306 handle structure
  * @return    status code
  *            - 0 success
- *            - 1 clear failed
- *            - 2 handle is NULL
+ *            - 2 ring or handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ *            - 4 no atomics and no ring lock linked
+ * @note      without c11 atomics the ring is guarded by the ring lock hooks,
+ *            which must mask the interrupts that push, the gram lock is never taken
  */
-uint8_t ssd1306_clear(ssd1306_handle_t *handle)
+uint8_t ssd1306_ring_init(ssd1306_ring_t *ring, ssd1306_handle_t *handle)
 {
     uint8_t i;
-    uint8_t n;
     
-    if (handle == NULL)                                                                               /* check handle */
+    if ((ring == NULL) || (handle == NULL))                                              /* check ring and handle */
     {
-        return 2;                                                                                     /* return error */
+        return 2;                                                                        /* return error */
     }
-    if (handle->inited != 1)                                                                          /* check handle initialization */
+    if (handle->inited != 1)                                                             /* check handle initialization */
     {
-        return 3;                                                                                     /* return error */
+        return 3;                                                                        /* return error */
+    }
+    if ((SSD1306_ATOMIC == 0) && 
+        ((handle->ring_lock == NULL) || (handle->ring_unlock == NULL)))                  /* check the ring lock */
+    {
+        handle->debug_print("ssd1306: no atomics and no ring lock linked.\n");           /* no atomics and no ring lock linked */
+        
+        return 4;                                                                        /* return error */
     }
     
-    for (i = 0; i < 8; i++)                                                                           /* write 8 page */
-    {  
-        if (a_ssd1306_write_byte(handle, SSD1306_CMD_PAGE_ADDR+i, SSD1306_CMD) != 0)                  /* set page */
-        {
-            handle->debug_print("ssd1306: write byte failed.\n");                                     /* write byte failed */
-            
-            return 1;                                                                                 /* return error */
-        }
-        if (a_ssd1306_write_byte(handle, SSD1306_CMD_LOWER_COLUMN_START_ADDRESS, SSD1306_CMD) != 0)   /* set lower column 0 */
+    memset(ring, 0, sizeof(ssd1306_ring_t));                                             /* clear the ring */
+    ring->handle = handle;                                                               /* set the handle */
+    ring->tail = 0;                                                                      /* drain from 0 */
+#if (SSD1306_ATOMIC != 0)
+    atomic_init(&ring->head, 0);                                                         /* push from 0 */
+    atomic_init(&ring->dropped, 0);                                                      /* nothing dropped */
+    for (i = 0; i < SSD1306_RING_SIZE; i++)                                              /* all slots */
+    {
+        atomic_init(&ring->slot[i].seq, i);                                              /* slot i is free for position i */
+    }
+#else
+    ring->head = 0;                                                                      /* push from 0 */
+    ring->dropped = 0;                                                                   /* nothing dropped */
+    for (i = 0; i < SSD1306_RING_SIZE; i++)                                              /* all slots */
+    {
+        ring->slot[i].seq = i;                                                           /* slot i is free for position i */
+    }
+#endif
+    
+    return 0;                                                                            /* success return 0 */
+}
+
+/**
+ * @brief     push a command stream to a ring
+ * @param[in] *ring pointer to an ssd1306 ring structure
+ * @param[in] *cmd pointer to a command buffer
+ * @param[in] len buffer length
+ * @return    status code
+ *            - 0 success
+ *            - 2 ring is NULL
+ *            - 4 command stream is invalid
+ *            - 5 ring is full
+ * @note      interrupt safe, lock free with c11 atomics, else under the ring lock,
+ *            it never blocks on the bus, the stream is made of whole commands and is SSD1306_RING_MAX_CMD_LEN bytes at most
+ */
+uint8_t ssd1306_ring_push(ssd1306_ring_t *ring, uint8_t *cmd, uint8_t len)
+{
+    uint8_t scroll;
+    uint_least32_t pos;
+    ssd1306_ring_slot_t *slot;
+#if (SSD1306_ATOMIC != 0)
+    int32_t diff;
+#endif
+    
+    if (ring == NULL)                                                                    /* check ring */
+    {
+        return 2;                                                                        /* return error */
+    }
+    if ((cmd == NULL) || (len == 0) || (len > SSD1306_RING_MAX_CMD_LEN) || 
+        (a_ssd1306_table_check(cmd, len, &scroll) != 0))                                 /* check the stream */
+    {
+        return 4;                                                                        /* return error */
+    }
+    
+#if (SSD1306_ATOMIC != 0)
+    pos = atomic_load_explicit(&ring->head, memory_order_relaxed);                       /* get the head */
+    while (1)                                                                            /* claim a slot */
+    {
+        slot = &ring->slot[pos & (SSD1306_RING_SIZE - 1)];                               /* get the slot */
+        diff = (int32_t)(atomic_load_explicit(&slot->seq, memory_order_acquire) - pos);  /* get the slot state */
+        if (diff == 0)                                                                   /* if the slot is free */
         {
-            handle->debug_print("ssd1306: write byte failed.\n");                                     /* write byte failed */
-            
-            return 1;                                                                                 /* return error */
+            if (atomic_compare_exchange_weak_explicit(&ring->head, &pos, pos + 1, 
+                                                      memory_order_relaxed, 
+                                                      memory_order_relaxed) != 0)        /* take the position */
+            {
+                break;                                                                   /* claimed */
+            }
         }
-        if (a_ssd1306_write_byte(handle, SSD1306_CMD_HIGHER_COLUMN_START_ADDRESS, SSD1306_CMD) != 0)  /* set higher column 0 */
+        else if (diff < 0)                                                               /* if the ring is full */
         {
-            handle->debug_print("ssd1306: write byte failed.\n");                                     /* write byte failed */
+            (void)atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);    /* count the drop */
             
-            return 1;                                                                                 /* return error */
+            return 5;                                                                    /* return error */
         }
-        for (n = 0; n < 128; n++)                                                                     /* write 128 */
+        else
         {
-            handle->gram[n][i] = 0x00;                                                                /* set black */
-            if (a_ssd1306_write_byte(handle, handle->gram[n][i], SSD1306_DATA) != 0)                  /* write data */
-            {
-                handle->debug_print("ssd1306: write byte failed.\n");                                 /* write byte failed */
-                
-                return 1;                                                                             /* return error */
-            }
+            pos = atomic_load_explicit(&ring->head, memory_order_relaxed);               /* another pusher won, reload */
         }
     }
+    memcpy(slot->cmd, cmd, len);                                                         /* copy the command */
+    slot->len = len;                                                                     /* set the length */
+    atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);                    /* publish the slot */
+#else
+    ring->handle->ring_lock(ring->handle->user_ctx);                                     /* mask the pushers */
+    pos = ring->head;                                                                    /* get the head */
+    slot = &ring->slot[pos & (SSD1306_RING_SIZE - 1)];                                   /* get the slot */
+    if (slot->seq != pos)                                                                /* if the ring is full */
+    {
+        ring->dropped++;                                                                 /* count the drop */
+        ring->handle->ring_unlock(ring->handle->user_ctx);                               /* unmask the pushers */
+        
+        return 5;                                                                        /* return error */
+    }
+    memcpy(slot->cmd, cmd, len);                                                         /* copy the command */
+    slot->len = len;                                                                     /* set the length */
+    slot->seq = pos + 1;                                                                 /* publish the slot */
+    ring->head = pos + 1;                                                                /* next position */
+    ring->handle->ring_unlock(ring->handle->user_ctx);                                   /* unmask the pushers */
+#endif
     
-    return 0;                                                                                         /* success return 0 */
+    return 0;                                                                            /* success return 0 */
 }
 
 /**
- * @brief     update the gram data
- * @param[in] *handle pointer to an ssd1306 handle structure
+ * @brief     push a contrast change to a ring
+ * @param[in] *ring pointer to an ssd1306 ring structure
+ * @param[in] contrast display contrast
  * @return    status code
  *            - 0 success
- *            - 1 gram update failed
- *            - 2 handle is NULL
- *            - 3 handle is not initialized
- * @note      none
+ *            - 2 ring is NULL
+ *            - 5 ring is full
+ * @note      interrupt safe
  */
-uint8_t ssd1306_gram_update(ssd1306_handle_t *handle)
+uint8_t ssd1306_ring_push_contrast(ssd1306_ring_t *ring, uint8_t contrast)
+{
+    uint8_t buf[2];
+    
+    buf[0] = SSD1306_CMD_CONTRAST_CONTROL;                                               /* set contrast control */
+    buf[1] = contrast;                                                                   /* set contrast */
+    
+    return ssd1306_ring_push(ring, buf, 2);                                              /* push the command */
+}
+
+/**
+ * @brief     push a display mode change to a ring
+ * @param[in] *ring pointer to an ssd1306 ring structure
+ * @param[in] mode display mode
+ * @return    status code
+ *            - 0 success
+ *            - 2 ring is NULL
+ *            - 5 ring is full
+ * @note      interrupt safe
+ */
+uint8_t ssd1306_ring_push_display_mode(ssd1306_ring_t *ring, ssd1306_display_mode_t mode)
+{
+    uint8_t buf[1];
+    
+    buf[0] = (mode != 0) ? SSD1306_CMD_INVERSE_DISPLAY : SSD1306_CMD_NORMAL_DISPLAY;    /* set display mode */
+    
+    return ssd1306_ring_push(ring, buf, 1);                                              /* push the command */
+}
+
+/**
+ * @brief     push a display on or off to a ring
+ * @param[in] *ring pointer to an ssd1306 ring structure
+ * @param[in] on_off display on or off
+ * @return    status code
+ *            - 0 success
+ *            - 2 ring is NULL
+ *            - 5 ring is full
+ * @note      interrupt safe
+ */
+uint8_t ssd1306_ring_push_display(ssd1306_ring_t *ring, ssd1306_display_t on_off)
+{
+    uint8_t buf[1];
+    
+    buf[0] = (on_off != 0) ? SSD1306_CMD_DISPLAY_ON : SSD1306_CMD_DISPLAY_OFF;          /* set display */
+    
+    return ssd1306_ring_push(ring, buf, 1);                                              /* push the command */
+}
+
+/**
+ * @brief      pop the oldest published command of a ring
+ * @param[in]  *ring pointer to an ssd1306 ring structure
+ * @param[out] *cmd pointer to a command buffer with SSD1306_RING_MAX_CMD_LEN bytes
+ * @param[out] *len pointer to a command length buffer
+ * @return     1 if a command is popped, else 0
+ * @note       a slot claimed by an interrupted pusher stops the drain until it is published
+ */
+static uint8_t a_ssd1306_ring_pop(ssd1306_ring_t *ring, uint8_t *cmd, uint8_t *len)
+{
+    ssd1306_ring_slot_t *slot = &ring->slot[ring->tail & (SSD1306_RING_SIZE - 1)];
+    
+#if (SSD1306_ATOMIC != 0)
+    if (atomic_load_explicit(&slot->seq, memory_order_acquire) != (uint_least32_t)(ring->tail + 1))  /* if not published */
+    {
+        return 0;                                                                        /* nothing */
+    }
+    *len = slot->len;                                                                    /* get the length */
+    memcpy(cmd, slot->cmd, slot->len);                                                   /* copy the command */
+    atomic_store_explicit(&slot->seq, (uint_least32_t)(ring->tail + SSD1306_RING_SIZE), 
+                          memory_order_release);                                         /* free the slot */
+#else
+    ring->handle->ring_lock(ring->handle->user_ctx);                                     /* mask the pushers */
+    if (slot->seq != (uint_least32_t)(ring->tail + 1))                                   /* if not published */
+    {
+        ring->handle->ring_unlock(ring->handle->user_ctx);                               /* unmask the pushers */
+        
+        return 0;                                                                        /* nothing */
+    }
+    *len = slot->len;                                                                    /* get the length */
+    memcpy(cmd, slot->cmd, slot->len);                                                   /* copy the command */
+    slot->seq = (uint_least32_t)(ring->tail + SSD1306_RING_SIZE);                        /* free the slot */
+    ring->handle->ring_unlock(ring->handle->user_ctx);                                   /* unmask the pushers */
+#endif
+    ring->tail++;                                                                        /* next position */
+    
+    return 1;                                                                            /* popped */
+}
+
+/**
+ * @brief     get the merge key of a queued command
+ * @param[in] *cmd pointer to a command buffer
+ * @param[in] len command length
+ * @return    merge key, 0 if the command is never merged
+ * @note      a later command with the same key overrides the earlier one
+ */
+static uint8_t a_ssd1306_ring_key(uint8_t *cmd, uint8_t len)
+{
+    if ((len == 2) && (cmd[0] == SSD1306_CMD_CONTRAST_CONTROL))                          /* if contrast */
+    {
+        return 1;                                                                        /* contrast key */
+    }
+    if (len != 1)                                                                        /* if not one byte */
+    {
+        return 0;                                                                        /* never merged */
+    }
+    if ((cmd[0] & 0xFE) == SSD1306_CMD_ENTIRE_DISPLAY_OFF)                               /* if entire display */
+    {
+        return 2;                                                                        /* entire display key */
+    }
+    if ((cmd[0] & 0xFE) == SSD1306_CMD_NORMAL_DISPLAY)                                   /* if display mode */
+    {
+        return 3;                                                                        /* display mode key */
+    }
+    if ((cmd[0] & 0xFE) == SSD1306_CMD_DISPLAY_OFF)                                      /* if display */
+    {
+        return 4;                                                                        /* display key */
+    }
+    
+    return 0;                                                                            /* never merged */
+}
+
+/**
+ * @brief      send the commands queued in a ring
+ * @param[in]  *ring pointer to an ssd1306 ring structure
+ * @param[out] *count pointer to a drained command count buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 drain failed
+ *             - 2 ring is NULL
+ *             - 3 handle is not initialized
+ *             - 4 flush is busy
+ * @note       flush task only, the queued commands go out in one command write,
+ *             back to back contrast, display mode, display or entire display settings
+ *             of the same kind collapse to the last one, queue order is kept otherwise
+ */
+uint8_t ssd1306_ring_drain(ssd1306_ring_t *ring, uint8_t *count)
 {
     uint8_t i;
+    uint8_t j;
     uint8_t n;
+    uint8_t key;
+    uint8_t scroll;
+    uint16_t total;
+    uint8_t len[SSD1306_RING_SIZE];
+    uint8_t cmd[SSD1306_RING_SIZE][SSD1306_RING_MAX_CMD_LEN];
+    uint8_t buf[SSD1306_RING_SIZE * SSD1306_RING_MAX_CMD_LEN];
+    ssd1306_handle_t *handle;
     
-    if (handle == NULL)                                                                               /* check handle */
+    if (ring == NULL)                                                                    /* check ring */
     {
-        return 2;                                                                                     /* return error */
+        return 2;                                                                        /* return error */
     }
-    if (handle->inited != 1)                                                                          /* check handle initialization */
+    handle = ring->handle;                                                               /* get the handle */
+    if ((handle == NULL) || (handle->inited != 1))                                       /* check handle initialization */
     {
-        return 3;                                                                                     /* return error */
+        return 3;                                                                        /* return error */
+    }
+    if (handle->job.active != 0)                                                         /* check the job */
+    {
+        handle->debug_print("ssd1306: flush is busy.\n");                                /* flush is busy */
+        
+        return 4;                                                                        /* return error */
     }
     
-    for (i = 0; i < 8; i++)                                                                           /* write 8 page */
-    {  
-        if (a_ssd1306_write_byte(handle, SSD1306_CMD_PAGE_ADDR+i, SSD1306_CMD) != 0)                  /* set page */
-        {
-            handle->debug_print("ssd1306: write byte failed.\n");                                     /* write byte failed */
-            
-            return 1;                                                                                 /* return error */
-        }
-        if (a_ssd1306_write_byte(handle, SSD1306_CMD_LOWER_COLUMN_START_ADDRESS, SSD1306_CMD) != 0)   /* set lower column 0 */
-        {
-            handle->debug_print("ssd1306: write byte failed.\n");                                     /* write byte failed */
-            
-            return 1;                                                                                 /* return error */
-        }
-        if (a_ssd1306_write_byte(handle, SSD1306_CMD_HIGHER_COLUMN_START_ADDRESS, SSD1306_CMD) != 0)  /* set higher column 0 */
-        {
-            handle->debug_print("ssd1306: write byte failed.\n");                                     /* write byte failed */
-            
-            return 1;                                                                                 /* return error */
-        }
-        for (n = 0; n < 128; n++)                                                                     /* write 128 */
+    n = 0;                                                                               /* init n */
+    while ((n < SSD1306_RING_SIZE) && (a_ssd1306_ring_pop(ring, cmd[n], &len[n]) != 0))  /* take the queued commands */
+    {
+        n++;                                                                             /* n++ */
+    }
+    *count = n;                                                                          /* set the count */
+    if (n == 0)                                                                          /* if nothing */
+    {
+        return 0;                                                                        /* success return 0 */
+    }
+    
+    total = 0;                                                                           /* init total */
+    for (i = 0; i < n; i++)                                                              /* merge the settings */
+    {
+        key = a_ssd1306_ring_key(cmd[i], len[i]);                                        /* get the key */
+        j = (uint8_t)(i + 1);                                                            /* only the next command may override */
+        if ((key != 0) && (j < n) && (a_ssd1306_ring_key(cmd[j], len[j]) == key))        /* if overridden by an adjacent setting */
         {
-            if (a_ssd1306_write_byte(handle, handle->gram[n][i], SSD1306_DATA) != 0)                  /* write data */
-            {
-                handle->debug_print("ssd1306: write byte failed.\n");                                 /* write byte failed */
-                
-                return 1;                                                                             /* return error */
-            }
+            continue;                                                                    /* skip */
         }
+        memcpy(&buf[total], cmd[i], len[i]);                                             /* append the command */
+        total = (uint16_t)(total + len[i]);                                              /* add the length */
+    }
+    (void)a_ssd1306_table_check(buf, total, &scroll);                                    /* get the scroll state */
+    if (a_ssd1306_multiple_write_byte(handle, buf, total, SSD1306_CMD) != 0)             /* write all commands */
+    {
+        handle->debug_print("ssd1306: drain failed.\n");                                 /* drain failed */
+        
+        return 1;                                                                        /* return error */
+    }
+    if (scroll != 0)                                                                     /* if the scroll is on */
+    {
+        a_ssd1306_panel_invalidate(handle);                                              /* scroll moves the panel ram */
     }
     
-    return 0;                                                                                         /* success return 0 */
+    return 0;                                                                            /* success return 0 */
 }
 
 /**
@@ -450,13 +3690,20 @@ uint8_t ssd1306_gram_update(ssd1306_handle_t *handle)
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
  *            - 4 x or y is invalid
- * @note      none
+ *            - 5 flush is busy
+ * @note      the point is held in a pending span if write combine is enabled
  */
 uint8_t ssd1306_write_point(ssd1306_handle_t *handle, uint8_t x, uint8_t y, uint8_t data)
 {
     uint8_t pos;
     uint8_t bx;
+    uint8_t n;
+    uint8_t own;
+    uint8_t gap;
+    uint8_t value;
     uint8_t temp = 0;
+    uint8_t buf[5];
+    ssd1306_cost_model_t model;
     
     if (handle == NULL)                                                                                        /* check handle */
     {
@@ -472,46 +3719,93 @@ uint8_t ssd1306_write_point(ssd1306_handle_t *handle, uint8_t x, uint8_t y, uint
         
         return 4;                                                                                              /* return error */
     }
+    if (handle->job.active != 0)                                                                               /* check the job */
+    {
+        handle->debug_print("ssd1306: flush is busy.\n");                                                      /* flush is busy */
+        
+        return 5;                                                                                              /* return error */
+    }
     
     pos = y / 8;                                                                                               /* get y page */
     bx = y % 8;                                                                                                /* get y point */
     temp = 1 << bx;                                                                                            /* set data */
+    a_ssd1306_cost_model(handle, &model);                                                                      /* get the model */
+    gap = a_ssd1306_merge_gap(&model);                                                                         /* get the merged gap */
+    a_ssd1306_lock(handle);                                                                                    /* lock the gram */
     if (data != 0)                                                                                             /* check the data */
     {
-        handle->gram[x][pos] |= temp;                                                                          /* set 1 */
+        handle->gram_draw[x][pos] |= temp;                                                                     /* set 1 */
     }
     else
     {
-        handle->gram[x][pos] &= ~temp;                                                                         /* set 0 */
+        handle->gram_draw[x][pos] &= ~temp;                                                                    /* set 0 */
     }
-    if (a_ssd1306_write_byte(handle, SSD1306_CMD_PAGE_ADDR + pos, SSD1306_CMD) != 0)                           /* write page addr */
+    handle->gram_flush[x][pos] = handle->gram_draw[x][pos];                                                    /* keep the buffers same */
+    value = handle->gram_flush[x][pos];                                                                        /* get the sent byte */
+    if (handle->write_combine != 0)                                                                            /* if write combine */
     {
-        handle->debug_print("ssd1306: write byte failed.\n");                                                  /* write byte failed */
+        if ((handle->pending_len != 0) && (handle->pending_page == pos) && 
+            ((x + gap + 1) >= handle->pending_start) && 
+            (x <= (handle->pending_start + handle->pending_len + gap)))                                        /* if near the pending span */
+        {
+            if (x < handle->pending_start)                                                                     /* if left of the span */
+            {
+                handle->pending_len = (uint8_t)(handle->pending_len + handle->pending_start - x);              /* grow left */
+                handle->pending_start = x;                                                                     /* set start column */
+            }
+            else if (x >= (handle->pending_start + handle->pending_len))                                       /* if right of the span */
+            {
+                handle->pending_len = (uint8_t)(x - handle->pending_start + 1);                                /* grow right */
+            }
+            a_ssd1306_unlock(handle);                                                                          /* unlock the gram */
+            
+            return 0;                                                                                          /* success return 0 */
+        }
+        a_ssd1306_unlock(handle);                                                                              /* unlock the gram */
+        if (a_ssd1306_pending_flush(handle) != 0)                                                              /* send the pending span */
+        {
+            handle->debug_print("ssd1306: flush pending failed.\n");                                           /* flush pending failed */
+            
+            return 1;                                                                                          /* return error */
+        }
+        a_ssd1306_lock(handle);                                                                                /* lock the gram */
+        handle->pending_page = pos;                                                                            /* set page */
+        handle->pending_start = x;                                                                             /* set start column */
+        handle->pending_len = 1;                                                                               /* one column */
+        a_ssd1306_unlock(handle);                                                                              /* unlock the gram */
         
-        return 1;                                                                                              /* return error */
+        return 0;                                                                                              /* success return 0 */
     }
-    if (a_ssd1306_write_byte(handle, SSD1306_CMD_LOWER_COLUMN_START_ADDRESS|(x&0x0F), SSD1306_CMD) != 0)       /* write lower column */
+    a_ssd1306_unlock(handle);                                                                                  /* unlock the gram */
+    n = a_ssd1306_page_address(handle, pos, x, buf);                                                           /* build the address */
+    own = a_ssd1306_batch_enter(handle);                                                                       /* batch the writes */
+    if ((n != 0) && (a_ssd1306_multiple_write_byte(handle, (uint8_t *)buf, n, SSD1306_CMD) != 0))              /* write the address */
     {
+        (void)a_ssd1306_batch_leave(handle, own, 0);                                                           /* drop the batch */
         handle->debug_print("ssd1306: write byte failed.\n");                                                  /* write byte failed */
         
         return 1;                                                                                              /* return error */
     }
-    if (a_ssd1306_write_byte(handle, SSD1306_CMD_HIGHER_COLUMN_START_ADDRESS|((x>>4)&0x0F), SSD1306_CMD) != 0) /* write higher column */
+    if (a_ssd1306_write_byte(handle, value, SSD1306_DATA) != 0)                                                /* write data */
     {
+        (void)a_ssd1306_batch_leave(handle, own, 0);                                                           /* drop the batch */
         handle->debug_print("ssd1306: write byte failed.\n");                                                  /* write byte failed */
         
         return 1;                                                                                              /* return error */
     }
-    if (a_ssd1306_write_byte(handle, handle->gram[x][pos], SSD1306_DATA) != 0)                                 /* write data */
+    if (a_ssd1306_batch_leave(handle, own, 1) != 0)                                                            /* send the batch */
     {
         handle->debug_print("ssd1306: write byte failed.\n");                                                  /* write byte failed */
-        
-        return 1;                                                                                              /* return error */
-    }
-    else
-    {
-       return 0;                                                                                               /* success return 0 */
+        
+        return 1;                                                                                              /* return error */
     }
+#if (SSD1306_SHADOW_ENABLE != 0)
+    a_ssd1306_lock(handle);                                                                                    /* lock the shadow */
+    handle->shadow[x][pos] = value;                                                                            /* update the shadow */
+    a_ssd1306_unlock(handle);                                                                                  /* unlock the shadow */
+#endif
+    
+    return 0;                                                                                                  /* success return 0 */
 }
 
 /**
@@ -552,7 +3846,7 @@ uint8_t ssd1306_read_point(ssd1306_handle_t *handle, uint8_t x, uint8_t y, uint8
     pos = y / 8;                                                     /* get y page */
     bx = y % 8;                                                      /* get y point */
     temp = 1 << bx;                                                  /* set data */
-    if ((handle->gram[x][pos] & temp) != 0)                          /* get data */
+    if ((handle->gram_flush[x][pos] & temp) != 0)                    /* get data */
     {
         *data = 1;                                                   /* set 1 */
     }
@@ -576,6 +3870,7 @@ uint8_t ssd1306_read_point(ssd1306_handle_t *handle, uint8_t x, uint8_t y, uint8
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
  *            - 4 x or y is invalid
+ *            - 5 flush is busy
  * @note      none
  */
 uint8_t ssd1306_gram_write_point(ssd1306_handle_t *handle, uint8_t x, uint8_t y, uint8_t data)
@@ -598,18 +3893,27 @@ uint8_t ssd1306_gram_write_point(ssd1306_handle_t *handle, uint8_t x, uint8_t y,
         
         return 4;                                                    /* return error */
     }
+    if (a_ssd1306_draw_busy(handle) != 0)                            /* check the job */
+    {
+        handle->debug_print("ssd1306: flush is busy.\n");            /* flush is busy */
+        
+        return 5;                                                    /* return error */
+    }
     
     pos = y / 8;                                                     /* get y page */
     bx = y % 8;                                                      /* get y point */
     temp = 1 << bx;                                                  /* set data */
+    a_ssd1306_lock(handle);                                          /* lock the gram */
+    a_ssd1306_gram_mark_dirty(handle, x, pos);                       /* mark dirty */
     if (data != 0)                                                   /* if 1 */
     {
-        handle->gram[x][pos] |= temp;                                /* set 1 */
+        handle->gram_draw[x][pos] |= temp;                           /* set 1 */
     }
     else
     {
-        handle->gram[x][pos] &= ~temp;                               /* set 0 */
+        handle->gram_draw[x][pos] &= ~temp;                          /* set 0 */
     }
+    a_ssd1306_unlock(handle);                                        /* unlock the gram */
   
     return 0;                                                        /* success return 0 */
 }
@@ -652,7 +3956,7 @@ uint8_t ssd1306_gram_read_point(ssd1306_handle_t *handle, uint8_t x, uint8_t y,
     pos = y / 8;                                                     /* get y page */
     bx = y % 8;                                                      /* get y point */
     temp = 1 << bx;                                                  /* set data */
-    if ((handle->gram[x][pos] & temp) != 0)                          /* get data */
+    if ((handle->gram_draw[x][pos] & temp) != 0)                     /* get data */
     {
         *data = 1;                                                   /* set 1 */
     }
@@ -679,6 +3983,7 @@ uint8_t ssd1306_gram_read_point(ssd1306_handle_t *handle, uint8_t x, uint8_t y,
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
  *            - 4 x or y is invalid
+ *            - 5 flush is busy
  * @note      none
  */
 uint8_t ssd1306_gram_write_string(ssd1306_handle_t *handle, uint8_t x, uint8_t y, char *str, uint16_t len, uint8_t color, ssd1306_font_t font)
@@ -697,7 +4002,14 @@ uint8_t ssd1306_gram_write_string(ssd1306_handle_t *handle, uint8_t x, uint8_t y
         
         return 4;                                                            /* return error */
     }
+    if (a_ssd1306_draw_busy(handle) != 0)                                    /* check the job */
+    {
+        handle->debug_print("ssd1306: flush is busy.\n");                    /* flush is busy */
+        
+        return 5;                                                            /* return error */
+    }
     
+    a_ssd1306_lock(handle);                                                  /* lock the gram */
     while ((len != 0) && (*str <= '~') && (*str >= ' '))                     /* write all string */
     {       
         if (x > (127 - (font / 2)))                                          /* check x point */
@@ -711,12 +4023,15 @@ uint8_t ssd1306_gram_write_string(ssd1306_handle_t *handle, uint8_t x, uint8_t y
         }
         if (a_ssd1306_gram_show_char(handle, x, y, *str, font, color) != 0)  /* show a char */
         {
+            a_ssd1306_unlock(handle);                                        /* unlock the gram */
+            
             return 1;                                                        /* return error */
         }
         x += (uint8_t)(font / 2);                                            /* x + font/2 */
         str++;                                                               /* str address++ */
         len--;                                                               /* str length-- */
     }
+    a_ssd1306_unlock(handle);                                                /* unlock the gram */
     
     return 0;                                                                /* success return 0 */
 }
@@ -737,6 +4052,7 @@ uint8_t ssd1306_gram_write_string(ssd1306_handle_t *handle, uint8_t x, uint8_t y
  *            - 4 left or top is invalid
  *            - 5 right or bottom is invalid
  *            - 6 left > right or top > bottom
+ *            - 7 flush is busy
  * @note      none
  */
 uint8_t ssd1306_gram_fill_rect(ssd1306_handle_t *handle, uint8_t left, uint8_t top, uint8_t right, uint8_t bottom, uint8_t color)
@@ -769,17 +4085,27 @@ uint8_t ssd1306_gram_fill_rect(ssd1306_handle_t *handle, uint8_t left, uint8_t t
         
         return 6;                                                               /* return error */
     }
+    if (a_ssd1306_draw_busy(handle) != 0)                                       /* check the job */
+    {
+        handle->debug_print("ssd1306: flush is busy.\n");                       /* flush is busy */
+        
+        return 7;                                                               /* return error */
+    }
     
+    a_ssd1306_lock(handle);                                                     /* lock the gram */
     for (x = left; x <= right; x++)                                             /* write x */
     {
         for (y = top; y <= bottom; y++)                                         /* write y */
         {
             if (a_ssd1306_gram_draw_point(handle, x, y, color) != 0)            /* draw point */
             {
+                a_ssd1306_unlock(handle);                                       /* unlock the gram */
+                
                 return 1;                                                       /* return error */
             }
         }
     }
+    a_ssd1306_unlock(handle);                                                   /* unlock the gram */
     
     return 0;                                                                   /* return error */
 }
@@ -800,6 +4126,7 @@ uint8_t ssd1306_gram_fill_rect(ssd1306_handle_t *handle, uint8_t left, uint8_t t
  *            - 4 left or top is invalid
  *            - 5 right or bottom is invalid
  *            - 6 left > right or top > bottom
+ *            - 7 flush is busy
  * @note      none
  */
 uint8_t ssd1306_gram_draw_picture(ssd1306_handle_t *handle, uint8_t left, uint8_t top, uint8_t right, uint8_t bottom, uint8_t *img)
@@ -832,18 +4159,157 @@ uint8_t ssd1306_gram_draw_picture(ssd1306_handle_t *handle, uint8_t left, uint8_
         
         return 6;                                                               /* return error */
     }
+    if (a_ssd1306_draw_busy(handle) != 0)                                       /* check the job */
+    {
+        handle->debug_print("ssd1306: flush is busy.\n");                       /* flush is busy */
+        
+        return 7;                                                               /* return error */
+    }
     
+    a_ssd1306_lock(handle);                                                     /* lock the gram */
     for (x = left; x <= right; x++)                                             /* write x */
     {
         for (y = top; y <= bottom; y++)                                         /* write y */
         {
             if (a_ssd1306_gram_draw_point(handle, x, y, *img) != 0)             /* draw point */
             {
+                a_ssd1306_unlock(handle);                                       /* unlock the gram */
+                
                 return 1;                                                       /* return error */
             }
             img++;                                                              /* img++ */
         }
     }
+    a_ssd1306_unlock(handle);                                                   /* unlock the gram */
+    
+    return 0;                                                                   /* succeed return 0 */
+}
+
+/**
+ * @brief     write a full page format frame to the gram
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] *frame pointer to a 1024 bytes frame buffer
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 flush is busy
+ * @note      frame[page * 128 + column] holds the 8 vertical pixels of the column in the page,
+ *            only the changed bytes are marked dirty
+ */
+uint8_t ssd1306_gram_write_frame(ssd1306_handle_t *handle, uint8_t *frame)
+{
+    uint8_t x, page;
+    
+    if (handle == NULL)                                                         /* check handle */
+    {
+        return 2;                                                               /* return error */
+    }
+    if (handle->inited != 1)                                                    /* check handle initialization */
+    {
+        return 3;                                                               /* return error */
+    }
+    if (a_ssd1306_draw_busy(handle) != 0)                                       /* check the job */
+    {
+        handle->debug_print("ssd1306: flush is busy.\n");                       /* flush is busy */
+        
+        return 4;                                                               /* return error */
+    }
+    
+    a_ssd1306_lock(handle);                                                     /* lock the gram */
+    for (page = 0; page < 8; page++)                                            /* write all pages */
+    {
+        for (x = 0; x < 128; x++)                                               /* write all columns */
+        {
+            if (handle->gram_draw[x][page] != *frame)                           /* if changed */
+            {
+                handle->gram_draw[x][page] = *frame;                            /* set the byte */
+                a_ssd1306_gram_mark_dirty(handle, x, page);                     /* mark dirty */
+            }
+            frame++;                                                            /* frame++ */
+        }
+    }
+    a_ssd1306_unlock(handle);                                                   /* unlock the gram */
+    
+    return 0;                                                                   /* succeed return 0 */
+}
+
+/**
+ * @brief     draw a packed bitmap in the gram
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] left left coordinate x
+ * @param[in] top top coordinate y
+ * @param[in] right right coordinate x
+ * @param[in] bottom bottom coordinate y
+ * @param[in] *bits pointer to a packed bitmap buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 gram draw bitmap failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 left or top is invalid
+ *            - 5 right or bottom is invalid
+ *            - 6 left > right or top > bottom
+ *            - 7 flush is busy
+ * @note      the bitmap is 1 bit per pixel in rows from top to bottom, msb first,
+ *            and every row is padded to a whole byte
+ */
+uint8_t ssd1306_gram_draw_bitmap(ssd1306_handle_t *handle, uint8_t left, uint8_t top, uint8_t right, uint8_t bottom, uint8_t *bits)
+{
+    uint8_t x, y;
+    uint8_t *row;
+    uint16_t stride;
+    
+    if (handle == NULL)                                                         /* check handle */
+    {
+        return 2;                                                               /* return error */
+    }
+    if (handle->inited != 1)                                                    /* check handle initialization */
+    {
+        return 3;                                                               /* return error */
+    }
+    if ((left > 127) || (top > 63))                                             /* check left top */
+    {
+        handle->debug_print("ssd1306: left or top is invalid.\n");              /* left or top is invalid */
+        
+        return 4;                                                               /* return error */
+    }
+    if ((right > 127) || (bottom > 63))                                         /* check right bottom */
+    {
+        handle->debug_print("ssd1306: right or bottom is invalid.\n");          /* right or bottom is invalid */
+        
+        return 5;                                                               /* return error */
+    }
+    if ((left > right) || (top > bottom))                                       /* check left right top bottom */
+    {
+        handle->debug_print("ssd1306: left > right or top > bottom.\n");        /* left > right or top > bottom */
+        
+        return 6;                                                               /* return error */
+    }
+    if (a_ssd1306_draw_busy(handle) != 0)                                       /* check the job */
+    {
+        handle->debug_print("ssd1306: flush is busy.\n");                       /* flush is busy */
+        
+        return 7;                                                               /* return error */
+    }
+    
+    stride = (uint16_t)((right - left + 8) / 8);                                /* get the row length */
+    a_ssd1306_lock(handle);                                                     /* lock the gram */
+    for (y = top; y <= bottom; y++)                                             /* write y */
+    {
+        row = bits + (uint16_t)(y - top) * stride;                              /* get the row */
+        for (x = left; x <= right; x++)                                         /* write x */
+        {
+            if (a_ssd1306_gram_draw_point(handle, x, y, 
+                                          (uint8_t)(row[(x - left) / 8] & (0x80 >> ((x - left) % 8)))) != 0)  /* draw point */
+            {
+                a_ssd1306_unlock(handle);                                       /* unlock the gram */
+                
+                return 1;                                                       /* return error */
+            }
+        }
+    }
+    a_ssd1306_unlock(handle);                                                   /* unlock the gram */
     
     return 0;                                                                   /* succeed return 0 */
 }
@@ -883,7 +4349,7 @@ uint8_t ssd1306_init(ssd1306_handle_t *handle)
        
         return 3;                                                                   /* return error */
     }
-    if (handle->iic_write == NULL)                                                  /* check iic_write */
+    if ((handle->iic_write == NULL) && (handle->iic_write_ctx == NULL))             /* check iic_write */
     {
         handle->debug_print("ssd1306: iic_write is null.\n");                       /* iic_write is null */
        
@@ -901,7 +4367,7 @@ uint8_t ssd1306_init(ssd1306_handle_t *handle)
        
         return 3;                                                                   /* return error */
     }
-    if (handle->spi_write_cmd == NULL)                                              /* check spi_write_cmd */
+    if ((handle->spi_write_cmd == NULL) && (handle->spi_write_cmd_ctx == NULL))     /* check spi_write_cmd */
     {
         handle->debug_print("ssd1306: spi_write_cmd is null.\n");                   /* spi_write_cmd is null */
        
@@ -925,7 +4391,8 @@ uint8_t ssd1306_init(ssd1306_handle_t *handle)
        
         return 3;                                                                   /* return error */
     }
-    if (handle->spi_cmd_data_gpio_write == NULL)                                    /* check spi_cmd_data_gpio_write */
+    if ((handle->spi_cmd_data_gpio_write == NULL) && 
+        (handle->spi_cmd_data_gpio_write_ctx == NULL))                              /* check spi_cmd_data_gpio_write */
     {
         handle->debug_print("ssd1306: spi_cmd_data_gpio_write is null.\n");         /* spi_cmd_data_gpio_write is null */
         
@@ -943,7 +4410,7 @@ uint8_t ssd1306_init(ssd1306_handle_t *handle)
         
         return 3;                                                                   /* return error */
     }
-    if(handle->reset_gpio_write == NULL)                                            /* check reset_gpio_write */
+    if ((handle->reset_gpio_write == NULL) && (handle->reset_gpio_write_ctx == NULL))  /* check reset_gpio_write */
     {
         handle->debug_print("ssd1306: reset_gpio_write is null.\n");                /* reset_gpio_write is null */ 
         
@@ -963,7 +4430,7 @@ uint8_t ssd1306_init(ssd1306_handle_t *handle)
         
         return 4;                                                                   /* return error */
     }
-    if (handle->reset_gpio_write(0) != 0)                                           /* write 0 */
+    if (a_ssd1306_link_reset_write(handle, 0) != 0)                                 /* write 0 */
     {
         handle->debug_print("ssd1306: reset gpio write failed.\n");                 /* reset gpio write failed */
         (void)handle->spi_cmd_data_gpio_deinit();                                   /* spi_cmd_data_gpio_deinit */
@@ -972,7 +4439,7 @@ uint8_t ssd1306_init(ssd1306_handle_t *handle)
         return 4;                                                                   /* return error */
     }
     handle->delay_ms(100);                                                          /* delay 100 ms */
-    if (handle->reset_gpio_write(1) != 0)                                           /* write 1 */
+    if (a_ssd1306_link_reset_write(handle, 1) != 0)                                 /* write 1 */
     {
         handle->debug_print("ssd1306: reset gpio write failed.\n");                 /* reset gpio write failed */
         (void)handle->spi_cmd_data_gpio_deinit();                                   /* spi_cmd_data_gpio_deinit */
@@ -1010,6 +4477,25 @@ uint8_t ssd1306_init(ssd1306_handle_t *handle)
         
         return 6;                                                                   /* return error */
     }
+    if (handle->gram_flush == NULL)                                                 /* if no buffer is set */
+    {
+        handle->gram_draw = handle->gram;                                           /* draw in the gram */
+        handle->gram_flush = handle->gram;                                          /* flush from the gram */
+    }
+    handle->addressing_mode = SSD1306_MEMORY_ADDRESSING_MODE_PAGE;                  /* page mode after reset */
+    handle->user_addressing_mode = SSD1306_MEMORY_ADDRESSING_MODE_PAGE;             /* the application starts in page mode */
+    handle->cursor_valid = 0;                                                       /* cursor is unknown */
+    handle->cmd_args_left = 0;                                                      /* no command arguments left */
+    handle->window_column_start = 0;                                                /* window column start after reset */
+    handle->window_column_end = 127;                                                /* window column end after reset */
+    handle->window_page_start = 0;                                                  /* window page start after reset */
+    handle->window_page_end = 7;                                                    /* window page end after reset */
+    handle->window_valid = SSD1306_WINDOW_VALID;                                    /* window is known */
+    handle->batch.open = 0;                                                         /* no batch */
+    handle->pending_len = 0;                                                        /* nothing pending */
+    handle->dc_level = 0xFF;                                                        /* data command level is unknown */
+    handle->dc_toggle_count = 0;                                                    /* no toggle */
+    a_ssd1306_panel_invalidate(handle);                                             /* panel ram is unknown */
     handle->inited = 1;                                                             /* flag inited */
     
     return 0;                                                                       /* success return 0 */
@@ -1077,108 +4563,383 @@ uint8_t ssd1306_deinit(ssd1306_handle_t *handle)
             return 1;                                                                /* return error */
         }
     }
-    else if (handle->iic_spi == SSD1306_INTERFACE_SPI)                               /* if spi interface */
+    else if (handle->iic_spi == SSD1306_INTERFACE_SPI)                               /* if spi interface */
+    {
+        if (handle->spi_deinit() != 0)                                               /* spi deinit */
+        {
+            handle->debug_print("ssd1306: spi deinit failed.\n");                    /* spi deinit failed */
+            
+            return 1;                                                                /* return error */
+        }
+    }
+    else
+    {
+        handle->debug_print("ssd1306: interface is invalid.\n");                     /* interface is invalid */
+        
+        return 7;                                                                    /* return error */
+    }
+    handle->inited = 0;                                                              /* flag close */
+    
+    return 0;                                                                        /* success return 0 */
+}
+
+/**
+ * @brief     set the chip interface
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] interface chip interface
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ * @note      none
+ */
+uint8_t ssd1306_set_interface(ssd1306_handle_t *handle, ssd1306_interface_t interface)
+{
+    if (handle == NULL)                          /* check handle */
+    {
+        return 2;                                /* return error */
+    }
+    
+    handle->iic_spi = (uint8_t)interface;        /* set interface */
+    
+    return 0;                                    /* success return 0 */
+}
+
+/**
+ * @brief      get the chip interface
+ * @param[in]  *handle pointer to an ssd1306 handle structure
+ * @param[out] *interface pointer to a chip interface buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ * @note       none
+ */
+uint8_t ssd1306_get_interface(ssd1306_handle_t *handle, ssd1306_interface_t *interface)
+{
+    if (handle == NULL)                                         /* check handle */
+    {
+        return 2;                                               /* return error */
+    }
+    
+    *interface = (ssd1306_interface_t)(handle->iic_spi);        /* get interface */
+    
+    return 0;                                                   /* success return 0 */
+}
+
+/**
+ * @brief     set the chip iic address
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] addr_pin iic address
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ * @note      none
+ */
+uint8_t ssd1306_set_addr_pin(ssd1306_handle_t *handle, ssd1306_address_t addr_pin)
+{
+    if (handle == NULL)                          /* check handle */
+    {
+        return 2;                                /* return error */
+    }
+    
+    handle->iic_addr = (uint8_t)addr_pin;        /* set addr pin */
+    
+    return 0;                                    /* success return 0 */
+}
+
+/**
+ * @brief      get the chip iic address
+ * @param[in]  *handle pointer to an ssd1306 handle structure
+ * @param[out] *addr_pin pointer to an iic address buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ * @note       none
+ */
+uint8_t ssd1306_get_addr_pin(ssd1306_handle_t *handle, ssd1306_address_t *addr_pin)
+{
+    if (handle == NULL)                                       /* check handle */
+    {
+        return 2;                                             /* return error */
+    }
+    
+    *addr_pin = (ssd1306_address_t)(handle->iic_addr);        /* set address */
+    
+    return 0;                                                 /* success return 0 */
+}
+
+/**
+ * @brief     set the max transfer length
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] len max bytes in one bus transfer
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ * @note      0 means no limit
+ */
+uint8_t ssd1306_set_max_transfer_length(ssd1306_handle_t *handle, uint16_t len)
+{
+    if (handle == NULL)                          /* check handle */
+    {
+        return 2;                                /* return error */
+    }
+    
+    handle->max_transfer_len = len;              /* set length */
+    
+    return 0;                                    /* success return 0 */
+}
+
+/**
+ * @brief      get the max transfer length
+ * @param[in]  *handle pointer to an ssd1306 handle structure
+ * @param[out] *len pointer to a length buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ * @note       none
+ */
+uint8_t ssd1306_get_max_transfer_length(ssd1306_handle_t *handle, uint16_t *len)
+{
+    if (handle == NULL)                          /* check handle */
+    {
+        return 2;                                /* return error */
+    }
+    
+    *len = handle->max_transfer_len;             /* get length */
+    
+    return 0;                                    /* success return 0 */
+}
+
+/**
+ * @brief     enable or disable write combine of ssd1306_write_point
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] enable bool value
+ * @return    status code
+ *            - 0 success
+ *            - 1 set write combine failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      combined points are sent when the span moves or ssd1306_flush_pending is called,
+ *            a point joins the span across a gap cheaper than re-addressing in the cost model,
+ *            disabling sends the pending span
+ */
+uint8_t ssd1306_set_write_combine(ssd1306_handle_t *handle, ssd1306_write_combine_t enable)
+{
+    if (handle == NULL)                                                        /* check handle */
+    {
+        return 2;                                                              /* return error */
+    }
+    if (handle->inited != 1)                                                   /* check handle initialization */
     {
-        if (handle->spi_deinit() != 0)                                               /* spi deinit */
-        {
-            handle->debug_print("ssd1306: spi deinit failed.\n");                    /* spi deinit failed */
-            
-            return 1;                                                                /* return error */
-        }
+        return 3;                                                              /* return error */
     }
-    else
+    
+    if ((enable == SSD1306_WRITE_COMBINE_DISABLE) && 
+        (a_ssd1306_pending_flush(handle) != 0))                                /* send the pending span */
     {
-        handle->debug_print("ssd1306: interface is invalid.\n");                     /* interface is invalid */
+        handle->debug_print("ssd1306: flush pending failed.\n");               /* flush pending failed */
         
-        return 7;                                                                    /* return error */
+        return 1;                                                              /* return error */
     }
-    handle->inited = 0;                                                              /* flag close */
+    handle->write_combine = (uint8_t)enable;                                   /* set write combine */
     
-    return 0;                                                                        /* success return 0 */
+    return 0;                                                                  /* success return 0 */
 }
 
 /**
- * @brief     set the chip interface
+ * @brief      get the write combine status
+ * @param[in]  *handle pointer to an ssd1306 handle structure
+ * @param[out] *enable pointer to a bool value buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ * @note       none
+ */
+uint8_t ssd1306_get_write_combine(ssd1306_handle_t *handle, ssd1306_write_combine_t *enable)
+{
+    if (handle == NULL)                                                        /* check handle */
+    {
+        return 2;                                                              /* return error */
+    }
+    
+    *enable = (ssd1306_write_combine_t)(handle->write_combine);                /* get write combine */
+    
+    return 0;                                                                  /* success return 0 */
+}
+
+/**
+ * @brief     send the pending span of combined points
  * @param[in] *handle pointer to an ssd1306 handle structure
- * @param[in] interface chip interface
  * @return    status code
  *            - 0 success
+ *            - 1 flush pending failed
  *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 flush is busy
  * @note      none
  */
-uint8_t ssd1306_set_interface(ssd1306_handle_t *handle, ssd1306_interface_t interface)
+uint8_t ssd1306_flush_pending(ssd1306_handle_t *handle)
 {
-    if (handle == NULL)                          /* check handle */
+    if (handle == NULL)                                                        /* check handle */
     {
-        return 2;                                /* return error */
+        return 2;                                                              /* return error */
+    }
+    if (handle->inited != 1)                                                   /* check handle initialization */
+    {
+        return 3;                                                              /* return error */
+    }
+    if (handle->job.active != 0)                                               /* check the job */
+    {
+        handle->debug_print("ssd1306: flush is busy.\n");                      /* flush is busy */
+        
+        return 4;                                                              /* return error */
     }
     
-    handle->iic_spi = (uint8_t)interface;        /* set interface */
+    if (a_ssd1306_pending_flush(handle) != 0)                                  /* send the pending span */
+    {
+        handle->debug_print("ssd1306: flush pending failed.\n");               /* flush pending failed */
+        
+        return 1;                                                              /* return error */
+    }
     
-    return 0;                                    /* success return 0 */
+    return 0;                                                                  /* success return 0 */
 }
 
 /**
- * @brief      get the chip interface
+ * @brief      get the data command gpio toggle count
  * @param[in]  *handle pointer to an ssd1306 handle structure
- * @param[out] *interface pointer to a chip interface buffer
+ * @param[out] *count pointer to a count buffer
  * @return     status code
  *             - 0 success
  *             - 2 handle is NULL
- * @note       none
+ * @note       only spi interface writes the data command gpio
  */
-uint8_t ssd1306_get_interface(ssd1306_handle_t *handle, ssd1306_interface_t *interface)
+uint8_t ssd1306_get_dc_toggle_count(ssd1306_handle_t *handle, uint32_t *count)
 {
-    if (handle == NULL)                                         /* check handle */
+    if (handle == NULL)                                                        /* check handle */
     {
-        return 2;                                               /* return error */
+        return 2;                                                              /* return error */
     }
     
-    *interface = (ssd1306_interface_t)(handle->iic_spi);        /* get interface */
+    *count = handle->dc_toggle_count;                                          /* get the count */
     
-    return 0;                                                   /* success return 0 */
+    return 0;                                                                  /* success return 0 */
 }
 
 /**
- * @brief     set the chip iic address
+ * @brief     clear the data command gpio toggle count
  * @param[in] *handle pointer to an ssd1306 handle structure
- * @param[in] addr_pin iic address
  * @return    status code
  *            - 0 success
  *            - 2 handle is NULL
- * @note      none
+ * @note      clear the count before a frame to get the toggles per frame
  */
-uint8_t ssd1306_set_addr_pin(ssd1306_handle_t *handle, ssd1306_address_t addr_pin)
+uint8_t ssd1306_clear_dc_toggle_count(ssd1306_handle_t *handle)
+{
+    if (handle == NULL)                                                        /* check handle */
+    {
+        return 2;                                                              /* return error */
+    }
+    
+    handle->dc_toggle_count = 0;                                               /* clear the count */
+    
+    return 0;                                                                  /* success return 0 */
+}
+
+/**
+ * @brief     set the transport cost model
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] *model pointer to a cost model structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ * @note      an all zero model selects the interface default
+ */
+uint8_t ssd1306_set_cost_model(ssd1306_handle_t *handle, const ssd1306_cost_model_t *model)
 {
     if (handle == NULL)                          /* check handle */
     {
         return 2;                                /* return error */
     }
     
-    handle->iic_addr = (uint8_t)addr_pin;        /* set addr pin */
+    handle->cost_model = *model;                 /* set model */
     
     return 0;                                    /* success return 0 */
 }
 
 /**
- * @brief      get the chip iic address
+ * @brief      get the transport cost model
  * @param[in]  *handle pointer to an ssd1306 handle structure
- * @param[out] *addr_pin pointer to an iic address buffer
+ * @param[out] *model pointer to a cost model structure
  * @return     status code
  *             - 0 success
  *             - 2 handle is NULL
  * @note       none
  */
-uint8_t ssd1306_get_addr_pin(ssd1306_handle_t *handle, ssd1306_address_t *addr_pin)
+uint8_t ssd1306_get_cost_model(ssd1306_handle_t *handle, ssd1306_cost_model_t *model)
 {
-    if (handle == NULL)                                       /* check handle */
+    if (handle == NULL)                          /* check handle */
     {
-        return 2;                                             /* return error */
+        return 2;                                /* return error */
     }
     
-    *addr_pin = (ssd1306_address_t)(handle->iic_addr);        /* set address */
+    a_ssd1306_cost_model(handle, model);         /* get model */
     
-    return 0;                                                 /* success return 0 */
+    return 0;                                    /* success return 0 */
+}
+
+/**
+ * @brief     set the back gram buffer
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] *buf pointer to a 128x8 gram buffer
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 4 flush is busy
+ * @note      the gram functions draw in the back buffer and the flush sends the flushing buffer,
+ *            which is handle->gram until ssd1306_gram_swap exchanges them, NULL disables double buffering,
+ *            the back buffer keeps its own dirty marks and they are merged at the swap,
+ *            so a flush between the drawing and the swap doesn't lose them
+ */
+uint8_t ssd1306_set_back_buffer(ssd1306_handle_t *handle, uint8_t (*buf)[8])
+{
+    uint8_t (*draw)[8];
+    
+    if (handle == NULL)                                                       /* check handle */
+    {
+        return 2;                                                             /* return error */
+    }
+    if (handle->job.active != 0)                                              /* check the job */
+    {
+        handle->debug_print("ssd1306: flush is busy.\n");                     /* flush is busy */
+        
+        return 4;                                                             /* return error */
+    }
+    
+    draw = (handle->gram_draw != NULL) ? handle->gram_draw : handle->gram;    /* get the drawing buffer */
+    if ((handle->gram_flush != NULL) && (handle->gram_flush != handle->gram)) /* if the gram is not flushed */
+    {
+        memcpy(handle->gram, handle->gram_flush, sizeof(handle->gram));       /* keep the flushing frame */
+    }
+    if (buf == NULL)                                                          /* if disable */
+    {
+        if (draw != handle->gram)                                             /* if drawn elsewhere */
+        {
+            memcpy(handle->gram, draw, sizeof(handle->gram));                 /* keep the drawing frame */
+        }
+        a_ssd1306_back_dirty_merge(handle);                                   /* the drawn frame is flushed next */
+        handle->gram_draw = handle->gram;                                     /* draw in the gram */
+    }
+    else
+    {
+        if (draw != buf)                                                      /* if a new buffer */
+        {
+            memcpy(buf, draw, sizeof(handle->gram));                          /* keep the drawing frame */
+        }
+        handle->gram_draw = buf;                                              /* draw in the buffer */
+    }
+    handle->gram_flush = handle->gram;                                        /* flush from the gram */
+    
+    return 0;                                                                 /* success return 0 */
 }
 
 /**
@@ -1191,6 +4952,7 @@ uint8_t ssd1306_get_addr_pin(ssd1306_handle_t *handle, ssd1306_address_t *addr_p
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
  *            - 4 addr is invalid
+ *            - 5 flush is busy
  * @note      addr <= 0xF
  */
 uint8_t ssd1306_set_low_column_start_address(ssd1306_handle_t *handle, uint8_t addr)
@@ -1209,6 +4971,16 @@ uint8_t ssd1306_set_low_column_start_address(ssd1306_handle_t *handle, uint8_t a
         
         return 4;                                                                                               /* return error */
     }
+    if (handle->job.active != 0)                                                                                /* check the job */
+    {
+        handle->debug_print("ssd1306: flush is busy.\n");                                                       /* flush is busy */
+        
+        return 5;                                                                                               /* return error */
+    }
+    if (a_ssd1306_mode_restore(handle) != 0)                                                                    /* put back the mode */
+    {
+        return 1;                                                                                               /* return error */
+    }
   
     return a_ssd1306_write_byte(handle, SSD1306_CMD_LOWER_COLUMN_START_ADDRESS|(addr&0x0F), SSD1306_CMD);       /* write command */
 }
@@ -1223,6 +4995,7 @@ uint8_t ssd1306_set_low_column_start_address(ssd1306_handle_t *handle, uint8_t a
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
  *            - 4 addr is invalid
+ *            - 5 flush is busy
  * @note      addr <= 0xF
  */
 uint8_t ssd1306_set_high_column_start_address(ssd1306_handle_t *handle, uint8_t addr)
@@ -1241,6 +5014,16 @@ uint8_t ssd1306_set_high_column_start_address(ssd1306_handle_t *handle, uint8_t
         
         return 4;                                                                                               /* return error */
     }
+    if (handle->job.active != 0)                                                                                /* check the job */
+    {
+        handle->debug_print("ssd1306: flush is busy.\n");                                                       /* flush is busy */
+        
+        return 5;                                                                                               /* return error */
+    }
+    if (a_ssd1306_mode_restore(handle) != 0)                                                                    /* put back the mode */
+    {
+        return 1;                                                                                               /* return error */
+    }
   
     return a_ssd1306_write_byte(handle, SSD1306_CMD_HIGHER_COLUMN_START_ADDRESS|(addr&0x0F), SSD1306_CMD);      /* write command */
 }
@@ -1254,7 +5037,9 @@ uint8_t ssd1306_set_high_column_start_address(ssd1306_handle_t *handle, uint8_t
  *            - 1 set memory addressing mode failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ *            - 4 flush is busy
+ * @note      the gram flushes switch the panel to their own mode,
+ *            the raw address, command and data functions put this mode back first
  */
 uint8_t ssd1306_set_memory_addressing_mode(ssd1306_handle_t *handle, ssd1306_memory_addressing_mode_t mode)
 {
@@ -1268,11 +5053,22 @@ uint8_t ssd1306_set_memory_addressing_mode(ssd1306_handle_t *handle, ssd1306_mem
     {
         return 3;                                                                       /* return error */
     }
+    if (handle->job.active != 0)                                                        /* check the job */
+    {
+        handle->debug_print("ssd1306: flush is busy.\n");                               /* flush is busy */
+        
+        return 4;                                                                       /* return error */
+    }
   
     buf[0] = SSD1306_CMD_MEMORY_ADDRESSING_MODE;                                        /* set command mode */
     buf[1] = mode;                                                                      /* set mode */
-  
-    return a_ssd1306_multiple_write_byte(handle, (uint8_t *)buf, 2, SSD1306_CMD);       /* write command */
+    if (a_ssd1306_multiple_write_byte(handle, (uint8_t *)buf, 2, SSD1306_CMD) != 0)     /* write command */
+    {
+        return 1;                                                                       /* return error */
+    }
+    handle->user_addressing_mode = (uint8_t)(mode & 0x03);                              /* save the application mode */
+    
+    return 0;                                                                           /* success return 0 */
 }
 
 /**
@@ -1287,6 +5083,7 @@ uint8_t ssd1306_set_memory_addressing_mode(ssd1306_handle_t *handle, ssd1306_mem
  *            - 3 handle is not initialized
  *            - 4 start addr is invalid
  *            - 5 end addr is invalid
+ *            - 6 flush is busy
  * @note      start addr and end addr can't be over 0x7F
  */
 uint8_t ssd1306_set_column_address_range(ssd1306_handle_t *handle, uint8_t start_addr, uint8_t end_addr)
@@ -1313,6 +5110,17 @@ uint8_t ssd1306_set_column_address_range(ssd1306_handle_t *handle, uint8_t start
         
         return 5;                                                                       /* return error */
     }
+    if (handle->job.active != 0)                                                        /* check the job */
+    {
+        handle->debug_print("ssd1306: flush is busy.\n");                               /* flush is busy */
+        
+        return 6;                                                                       /* return error */
+    }
+
+    if (a_ssd1306_mode_restore(handle) != 0)                                            /* put back the mode */
+    {
+        return 1;                                                                       /* return error */
+    }
     
     buf[0] = SSD1306_CMD_SET_COLUMN_ADDRESS;                                            /* set command */
     buf[1] = start_addr & 0x7F;                                                         /* set start address */
@@ -1333,6 +5141,7 @@ uint8_t ssd1306_set_column_address_range(ssd1306_handle_t *handle, uint8_t start
  *            - 3 handle is not initialized
  *            - 4 start addr is invalid
  *            - 5 end addr is invalid
+ *            - 6 flush is busy
  * @note      start addr and end addr can't be over 0x07
  */
 uint8_t ssd1306_set_page_address_range(ssd1306_handle_t *handle, uint8_t start_addr, uint8_t end_addr)
@@ -1359,6 +5168,17 @@ uint8_t ssd1306_set_page_address_range(ssd1306_handle_t *handle, uint8_t start_a
         
         return 5;                                                                       /* return error */
     }
+    if (handle->job.active != 0)                                                        /* check the job */
+    {
+        handle->debug_print("ssd1306: flush is busy.\n");                               /* flush is busy */
+        
+        return 6;                                                                       /* return error */
+    }
+
+    if (a_ssd1306_mode_restore(handle) != 0)                                            /* put back the mode */
+    {
+        return 1;                                                                       /* return error */
+    }
     
     buf[0] = SSD1306_CMD_SET_PAGE_ADDRESS;                                              /* set command */
     buf[1] = start_addr & 0x07;                                                         /* set start address */
@@ -1672,7 +5492,13 @@ uint8_t ssd1306_activate_scroll(ssd1306_handle_t *handle)
         return 3;                                                                        /* return error */
     }
     
-    return a_ssd1306_write_byte(handle, SSD1306_CMD_ACTIVATE_SCROLL, SSD1306_CMD);       /* write command */
+    if (a_ssd1306_write_byte(handle, SSD1306_CMD_ACTIVATE_SCROLL, SSD1306_CMD) != 0)     /* write command */
+    {
+        return 1;                                                                        /* return error */
+    }
+    a_ssd1306_panel_invalidate(handle);                                                  /* scroll moves the panel ram */
+    
+    return 0;                                                                            /* success return 0 */
 }
 
 /**
@@ -2002,6 +5828,7 @@ uint8_t ssd1306_set_display(ssd1306_handle_t *handle, ssd1306_display_t on_off)
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
  *            - 4 addr is invalid
+ *            - 5 flush is busy
  * @note      addr <= 0x07
  */
 uint8_t ssd1306_set_page_address(ssd1306_handle_t *handle, uint8_t addr)
@@ -2020,6 +5847,16 @@ uint8_t ssd1306_set_page_address(ssd1306_handle_t *handle, uint8_t addr)
         
         return 4;                                                                              /* return error */
     }
+    if (handle->job.active != 0)                                                               /* check the job */
+    {
+        handle->debug_print("ssd1306: flush is busy.\n");                                      /* flush is busy */
+        
+        return 5;                                                                              /* return error */
+    }
+    if (a_ssd1306_mode_restore(handle) != 0)                                                   /* put back the mode */
+    {
+        return 1;                                                                              /* return error */
+    }
     
     return a_ssd1306_write_byte(handle, SSD1306_CMD_PAGE_ADDR|(addr&0x07), SSD1306_CMD);       /* write command */
 }
@@ -2284,6 +6121,7 @@ uint8_t ssd1306_set_deselect_level(ssd1306_handle_t *handle, ssd1306_deselect_le
  *            - 1 write failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
+ *            - 4 flush is busy
  * @note      none
  */
 uint8_t ssd1306_write_cmd(ssd1306_handle_t *handle, uint8_t *buf, uint8_t len)
@@ -2296,8 +6134,24 @@ uint8_t ssd1306_write_cmd(ssd1306_handle_t *handle, uint8_t *buf, uint8_t len)
     {
         return 3;                                                                         /* return error */
     }
+    if (handle->job.active != 0)                                                          /* check the job */
+    {
+        handle->debug_print("ssd1306: flush is busy.\n");                                 /* flush is busy */
+        
+        return 4;                                                                         /* return error */
+    }
+    
+    if (a_ssd1306_mode_restore(handle) != 0)                                              /* put back the mode */
+    {
+        return 1;                                                                         /* return error */
+    }
+    if (a_ssd1306_multiple_write_byte(handle, (uint8_t *)buf, len, SSD1306_CMD) != 0)     /* write command */
+    {
+        return 1;                                                                         /* return error */
+    }
+    a_ssd1306_mode_save(handle);                                                          /* save the application mode */
     
-    return a_ssd1306_multiple_write_byte(handle, (uint8_t *)buf, len, SSD1306_CMD);       /* write command */
+    return 0;                                                                             /* success return 0 */
 }
 
 /**
@@ -2310,6 +6164,7 @@ uint8_t ssd1306_write_cmd(ssd1306_handle_t *handle, uint8_t *buf, uint8_t len)
  *            - 1 write failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
+ *            - 4 flush is busy
  * @note      none
  */
 uint8_t ssd1306_write_data(ssd1306_handle_t *handle, uint8_t *buf, uint8_t len)
@@ -2322,10 +6177,186 @@ uint8_t ssd1306_write_data(ssd1306_handle_t *handle, uint8_t *buf, uint8_t len)
     {
         return 3;                                                                          /* return error */
     }
+    if (handle->job.active != 0)                                                           /* check the job */
+    {
+        handle->debug_print("ssd1306: flush is busy.\n");                                  /* flush is busy */
+        
+        return 4;                                                                          /* return error */
+    }
+    
+    a_ssd1306_panel_invalidate(handle);                                                    /* panel ram differs from gram */
+    if (a_ssd1306_mode_restore(handle) != 0)                                               /* put back the mode */
+    {
+        return 1;                                                                          /* return error */
+    }
   
     return a_ssd1306_multiple_write_byte(handle, (uint8_t *)buf, len, SSD1306_DATA);       /* write data */
 }
 
+/**
+ * @brief     open a command batch
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 batch is already open
+ *            - 5 flush is busy
+ * @note      all writes are collected until ssd1306_batch_commit,
+ *            commands and one trailing data run go in one iic transaction,
+ *            without SSD1306_BATCH_ENABLE the writes are sent at once between
+ *            transfer_begin and transfer_end
+ */
+uint8_t ssd1306_batch_begin(ssd1306_handle_t *handle)
+{
+    if (handle == NULL)                                                               /* check handle */
+    {
+        return 2;                                                                     /* return error */
+    }
+    if (handle->inited != 1)                                                          /* check handle initialization */
+    {
+        return 3;                                                                     /* return error */
+    }
+    if (handle->batch.open != 0)                                                      /* check the batch */
+    {
+        handle->debug_print("ssd1306: batch is already open.\n");                     /* batch is already open */
+        
+        return 4;                                                                     /* return error */
+    }
+    if (handle->job.active != 0)                                                      /* check the job */
+    {
+        handle->debug_print("ssd1306: flush is busy.\n");                             /* flush is busy */
+        
+        return 5;                                                                     /* return error */
+    }
+    
+    (void)a_ssd1306_batch_enter(handle);                                              /* open */
+    
+    return 0;                                                                         /* success return 0 */
+}
+
+/**
+ * @brief     add commands to the command batch
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] *buf pointer to a command buffer
+ * @param[in] len command length
+ * @return    status code
+ *            - 0 success
+ *            - 1 batch cmd failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 batch is not open
+ * @note      the batch is sent early if it is full or data is already batched
+ */
+uint8_t ssd1306_batch_cmd(ssd1306_handle_t *handle, uint8_t *buf, uint8_t len)
+{
+    if (handle == NULL)                                                               /* check handle */
+    {
+        return 2;                                                                     /* return error */
+    }
+    if (handle->inited != 1)                                                          /* check handle initialization */
+    {
+        return 3;                                                                     /* return error */
+    }
+    if (handle->batch.open == 0)                                                      /* check the batch */
+    {
+        handle->debug_print("ssd1306: batch is not open.\n");                         /* batch is not open */
+        
+        return 4;                                                                     /* return error */
+    }
+    
+    if ((a_ssd1306_mode_restore(handle) != 0) || 
+        (a_ssd1306_multiple_write_byte(handle, buf, len, SSD1306_CMD) != 0))          /* append the commands */
+    {
+        handle->debug_print("ssd1306: batch cmd failed.\n");                          /* batch cmd failed */
+        
+        return 1;                                                                     /* return error */
+    }
+    a_ssd1306_mode_save(handle);                                                      /* save the application mode */
+    
+    return 0;                                                                         /* success return 0 */
+}
+
+/**
+ * @brief     add data to the command batch
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 batch data failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 batch is not open
+ * @note      the batch is sent early if it is full
+ */
+uint8_t ssd1306_batch_data(ssd1306_handle_t *handle, uint8_t *buf, uint16_t len)
+{
+    if (handle == NULL)                                                               /* check handle */
+    {
+        return 2;                                                                     /* return error */
+    }
+    if (handle->inited != 1)                                                          /* check handle initialization */
+    {
+        return 3;                                                                     /* return error */
+    }
+    if (handle->batch.open == 0)                                                      /* check the batch */
+    {
+        handle->debug_print("ssd1306: batch is not open.\n");                         /* batch is not open */
+        
+        return 4;                                                                     /* return error */
+    }
+    
+    a_ssd1306_panel_invalidate(handle);                                               /* panel ram differs from gram */
+    if ((a_ssd1306_mode_restore(handle) != 0) || 
+        (a_ssd1306_multiple_write_byte(handle, buf, len, SSD1306_DATA) != 0))         /* append the data */
+    {
+        handle->debug_print("ssd1306: batch data failed.\n");                         /* batch data failed */
+        
+        return 1;                                                                     /* return error */
+    }
+    
+    return 0;                                                                         /* success return 0 */
+}
+
+/**
+ * @brief     send and close the command batch
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 batch commit failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 batch is not open
+ * @note      none
+ */
+uint8_t ssd1306_batch_commit(ssd1306_handle_t *handle)
+{
+    if (handle == NULL)                                                               /* check handle */
+    {
+        return 2;                                                                     /* return error */
+    }
+    if (handle->inited != 1)                                                          /* check handle initialization */
+    {
+        return 3;                                                                     /* return error */
+    }
+    if (handle->batch.open == 0)                                                      /* check the batch */
+    {
+        handle->debug_print("ssd1306: batch is not open.\n");                         /* batch is not open */
+        
+        return 4;                                                                     /* return error */
+    }
+    
+    if (a_ssd1306_batch_leave(handle, 1, 1) != 0)                                     /* send and close the batch */
+    {
+        handle->debug_print("ssd1306: batch commit failed.\n");                       /* batch commit failed */
+        
+        return 1;                                                                     /* return error */
+    }
+    
+    return 0;                                                                         /* success return 0 */
+}
+
 /**
  * @brief      get chip's information
  * @param[out] *info pointer to an ssd1306 info structure
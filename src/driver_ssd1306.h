@@ -42,6 +42,49 @@
 #include <stdio.h>
 #include <string.h>
 
+/**
+ * @brief atomic support definition
+ * @note  1 means the frame hand-off and the command ring use c11 atomics,
+ *        0 means the hand-off uses the lock hooks and the ring uses the ring lock hooks,
+ *        it defaults to 1 on a c11 compiler with atomics and to 0 in c++ and older c,
+ *        the atomic counters have the size of the plain ones so the layout matches
+ */
+#ifndef SSD1306_ATOMIC
+#if (!defined(__cplusplus) && defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_ATOMICS__))
+#define SSD1306_ATOMIC    1        /**< the frame hand-off and the command ring use c11 atomics */
+#else
+#define SSD1306_ATOMIC    0        /**< the frame hand-off and the command ring use the lock hooks */
+#endif
+#endif
+#if (SSD1306_ATOMIC != 0)
+#if defined(__cplusplus)
+#error "ssd1306: SSD1306_ATOMIC needs c11 atomics, build the c++ units with SSD1306_ATOMIC 0 and the lock hooks."
+#elif (!defined(__STDC_VERSION__) || (__STDC_VERSION__ < 201112L) || defined(__STDC_NO_ATOMICS__))
+#error "ssd1306: SSD1306_ATOMIC needs a c11 compiler with atomics."
+#endif
+#include <stdatomic.h>
+#endif
+
+/**
+ * @brief shadow frame support definition
+ * @note  1 keeps a copy of the panel ram in the handle for ssd1306_gram_update_diff,
+ *        0 saves about 1 KB of the handle and the diff flush returns shadow is disabled,
+ *        set it for the whole build
+ */
+#ifndef SSD1306_SHADOW_ENABLE
+#define SSD1306_SHADOW_ENABLE    1        /**< keep the shadow for the diff flush */
+#endif
+
+/**
+ * @brief command batch support definition
+ * @note  1 keeps a frame buffer in the handle so a batch goes in one iic transaction,
+ *        0 saves about 200 bytes of the handle and the batched writes are sent at once,
+ *        set it for the whole build
+ */
+#ifndef SSD1306_BATCH_ENABLE
+#define SSD1306_BATCH_ENABLE     1        /**< keep the batch buffer */
+#endif
+
 #ifdef __cplusplus
 extern "C"{
 #endif
@@ -211,6 +254,125 @@ typedef enum
     SSD1306_FONT_24 = 0x18,        /**< font 24 */
 } ssd1306_font_t;
 
+/**
+ * @brief ssd1306 flush source enumeration definition
+ */
+typedef enum  
+{
+    SSD1306_FLUSH_SOURCE_ALL   = 0x00,        /**< the whole gram */
+    SSD1306_FLUSH_SOURCE_DIRTY = 0x01,        /**< the dirty spans */
+    SSD1306_FLUSH_SOURCE_DIFF  = 0x02,        /**< the bytes differing from the last sent data */
+} ssd1306_flush_source_t;
+
+/**
+ * @brief ssd1306 flush status enumeration definition
+ */
+typedef enum  
+{
+    SSD1306_FLUSH_STATUS_DONE  = 0x00,        /**< flush done */
+    SSD1306_FLUSH_STATUS_BUSY  = 0x01,        /**< flush in progress */
+    SSD1306_FLUSH_STATUS_ERROR = 0x02,        /**< flush failed */
+} ssd1306_flush_status_t;
+
+/**
+ * @brief ssd1306 write combine enumeration definition
+ */
+typedef enum  
+{
+    SSD1306_WRITE_COMBINE_DISABLE = 0x00,        /**< disable write combine */
+    SSD1306_WRITE_COMBINE_ENABLE  = 0x01,        /**< enable write combine */
+} ssd1306_write_combine_t;
+
+/**
+ * @brief ssd1306 init table command definition
+ * @note  each macro expands to the command bytes written by the matching setter
+ */
+#define SSD1306_INIT_DISPLAY(ON_OFF)                          (0xAE | ((ON_OFF) & 0x01))                                        /**< display on or off */
+#define SSD1306_INIT_COLUMN_ADDRESS_RANGE(START, END)         0x21, ((START) & 0x7F), ((END) & 0x7F)                           /**< column address range */
+#define SSD1306_INIT_PAGE_ADDRESS_RANGE(START, END)           0x22, ((START) & 0x07), ((END) & 0x07)                           /**< page address range */
+#define SSD1306_INIT_LOW_COLUMN_START_ADDRESS(ADDR)           (0x00 | ((ADDR) & 0x0F))                                          /**< low column start address */
+#define SSD1306_INIT_HIGH_COLUMN_START_ADDRESS(ADDR)          (0x10 | ((ADDR) & 0x0F))                                          /**< high column start address */
+#define SSD1306_INIT_MEMORY_ADDRESSING_MODE(MODE)             0x20, (MODE)                                                      /**< memory addressing mode */
+#define SSD1306_INIT_DISPLAY_START_LINE(LINE)                 (0x40 | ((LINE) & 0x3F))                                          /**< display start line */
+#define SSD1306_INIT_FADE_BLINKING_MODE(MODE, FRAMES)         0x23, (((MODE) << 4) | ((FRAMES) & 0x0F))                          /**< fade blinking mode */
+#define SSD1306_INIT_DEACTIVATE_SCROLL()                      0x2E                                                              /**< deactivate scroll */
+#define SSD1306_INIT_ZOOM_IN(ZOOM)                            0xD6, (ZOOM)                                                      /**< zoom in */
+#define SSD1306_INIT_CONTRAST(CONTRAST)                       0x81, (CONTRAST)                                                  /**< contrast */
+#define SSD1306_INIT_CHARGE_PUMP(ENABLE)                      0x8D, (0x10 | ((ENABLE) << 2))                                    /**< charge pump */
+#define SSD1306_INIT_SEGMENT_REMAP(REMAP)                     (0xA0 | ((REMAP) & 0x01))                                         /**< segment remap */
+#define SSD1306_INIT_ENTIRE_DISPLAY(ENABLE)                   (0xA4 | ((ENABLE) & 0x01))                                        /**< entire display */
+#define SSD1306_INIT_DISPLAY_MODE(MODE)                       (0xA6 | ((MODE) & 0x01))                                          /**< display mode */
+#define SSD1306_INIT_MULTIPLEX_RATIO(MULTIPLEX)               0xA8, ((MULTIPLEX) & 0x3F)                                        /**< multiplex ratio */
+#define SSD1306_INIT_SCAN_DIRECTION(DIR)                      (0xC0 | (((DIR) & 0x01) << 3))                                    /**< scan direction */
+#define SSD1306_INIT_DISPLAY_OFFSET(OFFSET)                   0xD3, ((OFFSET) & 0x3F)                                           /**< display offset */
+#define SSD1306_INIT_DISPLAY_CLOCK(FREQUENCY, DIVIDE)         0xD5, ((((FREQUENCY) & 0x0F) << 4) | ((DIVIDE) & 0x0F))          /**< display clock */
+#define SSD1306_INIT_PRECHARGE_PERIOD(PHASE1, PHASE2)         0xD9, ((((PHASE2) & 0x0F) << 4) | ((PHASE1) & 0x0F))             /**< pre charge period */
+#define SSD1306_INIT_COM_PINS_HARDWARE_CONF(CONF, REMAP)      0xDA, (((CONF) << 4) | ((REMAP) << 5) | 0x02)                     /**< com pins hardware conf */
+#define SSD1306_INIT_DESELECT_LEVEL(LEVEL)                    0xDB, ((LEVEL) << 4)                                              /**< deselect level */
+
+/**
+ * @brief ssd1306 transport cost model structure definition
+ */
+typedef struct ssd1306_cost_model_s
+{
+    uint16_t transaction_cost;        /**< fixed cost of one bus transaction */
+    uint16_t byte_cost;               /**< cost of one byte */
+    uint16_t dc_switch_cost;          /**< cost of one command data line switch */
+} ssd1306_cost_model_t;
+
+/**
+ * @brief ssd1306 flush job structure definition
+ */
+typedef struct ssd1306_flush_job_s
+{
+    volatile uint8_t active;     /**< job active flag, written from the irq handler */
+    volatile uint8_t busy;       /**< transfer in flight flag, written from the irq handler */
+    volatile uint8_t error;      /**< job error flag, written from the irq handler */
+    volatile uint8_t lost;       /**< panel ram lost flag, written from the irq handler */
+    uint8_t source;              /**< flush source */
+    uint8_t window;              /**< window plan flag */
+    uint8_t gap;                 /**< max merged gap */
+    uint8_t column_start;        /**< window start column */
+    uint8_t column_end;          /**< window end column */
+    uint8_t page_start;          /**< window start page */
+    uint8_t page_end;            /**< window end page */
+    uint8_t stage;               /**< job stage */
+    uint8_t page;                /**< current page */
+    uint8_t span_start;          /**< current span start column */
+    uint8_t span_len;            /**< current span length */
+    uint8_t dirty_page;          /**< dirty page bit mask taken from the handle */
+    uint8_t dirty_column_min[8]; /**< min dirty column of each page */
+    uint8_t dirty_column_max[8]; /**< max dirty column of each page */
+    uint16_t next;               /**< next column or window byte */
+    uint16_t sent;               /**< sent window bytes */
+    uint8_t async;               /**< asynchronous job flag */
+    uint8_t dc;                  /**< command or data transfer */
+    uint8_t *data;               /**< pending transfer data */
+    uint16_t len;                /**< pending transfer length */
+    uint16_t chunk;              /**< length of the transfer in flight */
+    uint8_t cmd[8];              /**< command buffer */
+    uint8_t buf[128];            /**< gather buffer */
+} ssd1306_flush_job_t;
+
+/**
+ * @brief ssd1306 command batch size definition
+ */
+#define SSD1306_BATCH_MAX_CMD_LEN     32         /**< max batched command bytes */
+#define SSD1306_BATCH_MAX_DATA_LEN    128        /**< max batched data bytes */
+
+/**
+ * @brief ssd1306 command batch structure definition
+ */
+typedef struct ssd1306_batch_s
+{
+    uint8_t open;                                                                         /**< batch open flag */
+#if (SSD1306_BATCH_ENABLE != 0)
+    uint8_t cmd_len;                                                                      /**< batched command bytes */
+    uint16_t data_len;                                                                    /**< batched data bytes */
+    uint8_t buf[2 * SSD1306_BATCH_MAX_CMD_LEN + 1 + SSD1306_BATCH_MAX_DATA_LEN];          /**< iic frame buffer */
+#endif
+} ssd1306_batch_t;
+
 /**
  * @brief ssd1306 handle structure definition
  */
@@ -230,12 +392,174 @@ typedef struct ssd1306_handle_s
     uint8_t (*reset_gpio_write)(uint8_t value);                                         /**< point to a reset_gpio_write function address */
     void (*debug_print)(const char *const fmt, ...);                                    /**< point to a debug_print function address */
     void (*delay_ms)(uint32_t ms);                                                      /**< point to a delay_ms function address */
+    uint8_t (*iic_write_async)(uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len);  /**< point to an optional iic_write_async function address */
+    uint8_t (*spi_write_cmd_async)(uint8_t *buf, uint16_t len);                         /**< point to an optional spi_write_cmd_async function address */
+    uint8_t (*iic_write_cmd)(uint8_t addr, uint8_t *buf, uint16_t len);                 /**< point to an optional iic_write_cmd function address */
+    void (*transfer_begin)(void);                                                       /**< point to an optional transfer_begin function address */
+    uint8_t (*transfer_end)(void);                                                      /**< point to an optional transfer_end function address */
+    void *user_ctx;                                                                     /**< user context passed to the ctx link functions */
+    uint8_t (*iic_write_ctx)(void *ctx, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len);  /**< point to an optional iic_write_ctx function address */
+    uint8_t (*iic_write_cmd_ctx)(void *ctx, uint8_t addr, uint8_t *buf, uint16_t len);  /**< point to an optional iic_write_cmd_ctx function address */
+    uint8_t (*spi_write_cmd_ctx)(void *ctx, uint8_t *buf, uint16_t len);                /**< point to an optional spi_write_cmd_ctx function address */
+    uint8_t (*spi_cmd_data_gpio_write_ctx)(void *ctx, uint8_t value);                   /**< point to an optional spi_cmd_data_gpio_write_ctx function address */
+    uint8_t (*reset_gpio_write_ctx)(void *ctx, uint8_t value);                          /**< point to an optional reset_gpio_write_ctx function address */
+    void (*transfer_begin_ctx)(void *ctx);                                              /**< point to an optional transfer_begin_ctx function address */
+    uint8_t (*transfer_end_ctx)(void *ctx);                                             /**< point to an optional transfer_end_ctx function address */
+    uint8_t (*iic_write_async_ctx)(void *ctx, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len);  /**< point to an optional iic_write_async_ctx function address */
+    uint8_t (*spi_write_cmd_async_ctx)(void *ctx, uint8_t *buf, uint16_t len);          /**< point to an optional spi_write_cmd_async_ctx function address */
+    void (*lock)(void *ctx);                                                            /**< point to an optional lock function address */
+    void (*unlock)(void *ctx);                                                          /**< point to an optional unlock function address */
+    void (*ring_lock)(void *ctx);                                                       /**< point to an optional ring_lock function address */
+    void (*ring_unlock)(void *ctx);                                                     /**< point to an optional ring_unlock function address */
     uint8_t inited;                                                                     /**< inited flag */
     uint8_t iic_addr;                                                                   /**< iic address */
     uint8_t iic_spi;                                                                    /**< iic spi type */
+    uint8_t addressing_mode;                                                            /**< current memory addressing mode */
+    uint8_t user_addressing_mode;                                                       /**< memory addressing mode set by the application */
+    uint8_t cursor_valid;                                                               /**< panel cursor valid bits */
+    uint8_t cursor_page;                                                                /**< panel cursor page */
+    uint8_t cursor_column;                                                              /**< panel cursor column */
+    uint8_t window_valid;                                                               /**< panel window valid bits */
+    uint8_t window_column_start;                                                        /**< panel window column start */
+    uint8_t window_column_end;                                                          /**< panel window column end */
+    uint8_t window_page_start;                                                          /**< panel window page start */
+    uint8_t window_page_end;                                                            /**< panel window page end */
+    uint8_t cmd_args_left;                                                              /**< command arguments left in the stream */
+    uint8_t dc_level;                                                                   /**< cached spi data command level */
+    struct ssd1306_group_s *group;                                                      /**< panel group sharing the data command line */
+    uint32_t dc_toggle_count;                                                           /**< spi data command gpio toggle count */
+    uint32_t tx_bytes;                                                                  /**< bytes sent on the bus */
+    uint32_t tx_count;                                                                  /**< bus transactions */
+    uint16_t max_transfer_len;                                                          /**< max transfer length, 0 is no limit */
+    ssd1306_cost_model_t cost_model;                                                    /**< transport cost model */
+    ssd1306_flush_job_t job;                                                            /**< flush job */
+    ssd1306_batch_t batch;                                                              /**< command batch */
+    uint8_t dirty_page;                                                                 /**< dirty page bit mask */
+    uint8_t dirty_column_min[8];                                                        /**< min dirty column of each page */
+    uint8_t dirty_column_max[8];                                                        /**< max dirty column of each page */
+    uint8_t write_combine;                                                              /**< write combine flag */
+    uint8_t pending_page;                                                               /**< pending span page */
+    uint8_t pending_start;                                                              /**< pending span start column */
+    uint8_t pending_len;                                                                /**< pending span length */
+#if (SSD1306_SHADOW_ENABLE != 0)
+    uint8_t shadow_valid;                                                               /**< valid shadow page bit mask */
+    uint8_t shadow_ctrl;                                                                /**< control byte slot in front of the shadow */
+    uint8_t shadow[128][8];                                                             /**< last data sent to the panel */
+#endif
+    uint8_t gram_ctrl;                                                                  /**< control byte slot in front of the gram */
     uint8_t gram[128][8];                                                               /**< gram buffer */
+    uint8_t (*gram_draw)[8];                                                            /**< drawing gram buffer */
+    uint8_t (*gram_flush)[8];                                                           /**< flushing gram buffer */
+    uint8_t back_dirty_page;                                                            /**< dirty page bit mask of the back buffer */
+    uint8_t back_dirty_column_min[8];                                                   /**< min dirty column of each back buffer page */
+    uint8_t back_dirty_column_max[8];                                                   /**< max dirty column of each back buffer page */
 } ssd1306_handle_t;
 
+/**
+ * @brief ssd1306 bus scheduler size definition
+ */
+#define SSD1306_BUS_MAX_PANEL    4        /**< max panels on one bus */
+
+/**
+ * @brief ssd1306 bus statistics structure definition
+ */
+typedef struct ssd1306_bus_stats_s
+{
+    uint32_t bytes;                                  /**< bytes sent on the bus */
+    uint32_t transactions;                           /**< bus transactions */
+    uint32_t estimated_cost;                         /**< estimated bus time in cost model units */
+    uint32_t turns[SSD1306_BUS_MAX_PANEL];           /**< flush turns of each panel */
+} ssd1306_bus_stats_t;
+
+/**
+ * @brief ssd1306 bus scheduler structure definition
+ */
+typedef struct ssd1306_bus_s
+{
+    ssd1306_handle_t *panel[SSD1306_BUS_MAX_PANEL];  /**< panels on the bus */
+    uint8_t count;                                   /**< panel count */
+    uint8_t next;                                    /**< next panel to serve */
+    uint16_t quantum;                                /**< max bytes of one turn */
+    ssd1306_bus_stats_t stats;                       /**< bus statistics */
+} ssd1306_bus_t;
+
+/**
+ * @brief ssd1306 panel group size definition
+ */
+#define SSD1306_GROUP_MAX_PANEL    4        /**< max panels in one group */
+
+/**
+ * @brief ssd1306 panel group structure definition
+ */
+typedef struct ssd1306_group_s
+{
+    ssd1306_handle_t *panel[SSD1306_GROUP_MAX_PANEL];                       /**< panels in the group */
+    uint8_t count;                                                          /**< panel count */
+    uint8_t dc_level;                                                       /**< cached level of the shared data command line */
+    void *user_ctx;                                                         /**< user context passed to spi_write_cmd_all */
+    uint8_t (*spi_write_cmd_all)(void *ctx, uint8_t *buf, uint16_t len);    /**< point to an optional spi_write_cmd_all function address */
+    uint32_t tx_bytes;                                                      /**< broadcast bytes, also counted by every panel */
+    uint32_t tx_count;                                                      /**< broadcast transactions, also counted by every panel */
+} ssd1306_group_t;
+
+/**
+ * @brief ssd1306 frame hand-off state definition
+ */
+#if (SSD1306_ATOMIC != 0)
+typedef atomic_uint_least8_t ssd1306_handoff_state_t;        /**< published index and fresh flag */
+#else
+typedef volatile uint8_t ssd1306_handoff_state_t;            /**< published index and fresh flag */
+#endif
+
+/**
+ * @brief ssd1306 frame hand-off structure definition
+ */
+typedef struct ssd1306_handoff_s
+{
+    ssd1306_handle_t *handle;                                /**< flushed handle */
+    ssd1306_handoff_state_t state;                           /**< published frame index and fresh flag */
+    uint8_t write;                                           /**< renderer frame index */
+    uint8_t read;                                            /**< flush task frame index */
+    uint8_t frame[3][1024];                                  /**< page format frames */
+} ssd1306_handoff_t;
+
+/**
+ * @brief ssd1306 command ring size definition
+ */
+#define SSD1306_RING_SIZE           16       /**< ring slots, a power of 2 */
+#define SSD1306_RING_MAX_CMD_LEN    8        /**< max command bytes of one slot */
+
+/**
+ * @brief ssd1306 command ring counter definition
+ */
+#if (SSD1306_ATOMIC != 0)
+typedef atomic_uint_least32_t ssd1306_ring_seq_t;            /**< ring position */
+#else
+typedef volatile uint_least32_t ssd1306_ring_seq_t;          /**< ring position */
+#endif
+
+/**
+ * @brief ssd1306 command ring slot structure definition
+ */
+typedef struct ssd1306_ring_slot_s
+{
+    ssd1306_ring_seq_t seq;                                  /**< slot sequence */
+    uint8_t len;                                             /**< command length */
+    uint8_t cmd[SSD1306_RING_MAX_CMD_LEN];                   /**< command bytes */
+} ssd1306_ring_slot_t;
+
+/**
+ * @brief ssd1306 command ring structure definition
+ */
+typedef struct ssd1306_ring_s
+{
+    ssd1306_handle_t *handle;                                /**< drained handle */
+    ssd1306_ring_seq_t head;                                 /**< next push position */
+    ssd1306_ring_seq_t dropped;                              /**< commands dropped on a full ring */
+    uint_least32_t tail;                                     /**< next drain position */
+    ssd1306_ring_slot_t slot[SSD1306_RING_SIZE];             /**< ring slots */
+} ssd1306_ring_t;
+
 /**
  * @brief ssd1306 information structure definition
  */
@@ -383,6 +707,182 @@ typedef struct ssd1306_info_s
  */
 #define DRIVER_SSD1306_LINK_DEBUG_PRINT(HANDLE, FUC)                   (HANDLE)->debug_print = FUC
 
+/**
+ * @brief     link iic_write_async function
+ * @param[in] HANDLE pointer to an ssd1306 handle structure
+ * @param[in] FUC pointer to an iic_write_async function address
+ * @note      optional, the function starts the write and returns at once,
+ *            the platform calls ssd1306_flush_irq_handler when it is done
+ */
+#define DRIVER_SSD1306_LINK_IIC_WRITE_ASYNC(HANDLE, FUC)               (HANDLE)->iic_write_async = FUC
+
+/**
+ * @brief     link spi_write_cmd_async function
+ * @param[in] HANDLE pointer to an ssd1306 handle structure
+ * @param[in] FUC pointer to a spi_write_cmd_async function address
+ * @note      optional, the function starts the write and returns at once,
+ *            the platform calls ssd1306_flush_irq_handler when it is done
+ */
+#define DRIVER_SSD1306_LINK_SPI_WRITE_COMMAND_ASYNC(HANDLE, FUC)       (HANDLE)->spi_write_cmd_async = FUC
+
+/**
+ * @brief     link iic_write_cmd function
+ * @param[in] HANDLE pointer to an ssd1306 handle structure
+ * @param[in] FUC pointer to an iic_write_cmd function address
+ * @note      optional, buf[0] is the control byte already placed in front of the payload,
+ *            so the gram and the batch buffer go to the bus without a copy,
+ *            a buffer set by ssd1306_set_back_buffer still uses iic_write
+ */
+#define DRIVER_SSD1306_LINK_IIC_WRITE_COMMAND(HANDLE, FUC)             (HANDLE)->iic_write_cmd = FUC
+
+/**
+ * @brief     link transfer_begin function
+ * @param[in] HANDLE pointer to an ssd1306 handle structure
+ * @param[in] FUC pointer to a transfer_begin function address
+ * @note      optional, the bus writes until transfer_end may be queued by the platform
+ */
+#define DRIVER_SSD1306_LINK_TRANSFER_BEGIN(HANDLE, FUC)                (HANDLE)->transfer_begin = FUC
+
+/**
+ * @brief     link transfer_end function
+ * @param[in] HANDLE pointer to an ssd1306 handle structure
+ * @param[in] FUC pointer to a transfer_end function address
+ * @note      optional, the platform submits the queued bus writes and returns the result
+ */
+#define DRIVER_SSD1306_LINK_TRANSFER_END(HANDLE, FUC)                  (HANDLE)->transfer_end = FUC
+
+/**
+ * @brief     link the user context
+ * @param[in] HANDLE pointer to an ssd1306 handle structure
+ * @param[in] CTX pointer to a user context
+ * @note      optional, the context is passed to the ctx link functions,
+ *            so panels on different buses can share the same functions
+ */
+#define DRIVER_SSD1306_LINK_USER_CTX(HANDLE, CTX)                      (HANDLE)->user_ctx = CTX
+
+/**
+ * @brief     link iic_write_ctx function
+ * @param[in] HANDLE pointer to an ssd1306 handle structure
+ * @param[in] FUC pointer to an iic_write_ctx function address
+ * @note      optional, used instead of iic_write
+ */
+#define DRIVER_SSD1306_LINK_IIC_WRITE_CTX(HANDLE, FUC)                 (HANDLE)->iic_write_ctx = FUC
+
+/**
+ * @brief     link iic_write_cmd_ctx function
+ * @param[in] HANDLE pointer to an ssd1306 handle structure
+ * @param[in] FUC pointer to an iic_write_cmd_ctx function address
+ * @note      optional, used instead of iic_write_cmd
+ */
+#define DRIVER_SSD1306_LINK_IIC_WRITE_COMMAND_CTX(HANDLE, FUC)         (HANDLE)->iic_write_cmd_ctx = FUC
+
+/**
+ * @brief     link spi_write_cmd_ctx function
+ * @param[in] HANDLE pointer to an ssd1306 handle structure
+ * @param[in] FUC pointer to a spi_write_cmd_ctx function address
+ * @note      optional, used instead of spi_write_cmd
+ */
+#define DRIVER_SSD1306_LINK_SPI_WRITE_COMMAND_CTX(HANDLE, FUC)         (HANDLE)->spi_write_cmd_ctx = FUC
+
+/**
+ * @brief     link spi_cmd_data_gpio_write_ctx function
+ * @param[in] HANDLE pointer to an ssd1306 handle structure
+ * @param[in] FUC pointer to a spi_cmd_data_gpio_write_ctx function address
+ * @note      optional, used instead of spi_cmd_data_gpio_write
+ */
+#define DRIVER_SSD1306_LINK_SPI_COMMAND_DATA_GPIO_WRITE_CTX(HANDLE, FUC)  (HANDLE)->spi_cmd_data_gpio_write_ctx = FUC
+
+/**
+ * @brief     link reset_gpio_write_ctx function
+ * @param[in] HANDLE pointer to an ssd1306 handle structure
+ * @param[in] FUC pointer to a reset_gpio_write_ctx function address
+ * @note      optional, used instead of reset_gpio_write
+ */
+#define DRIVER_SSD1306_LINK_RESET_GPIO_WRITE_CTX(HANDLE, FUC)          (HANDLE)->reset_gpio_write_ctx = FUC
+
+/**
+ * @brief     link transfer_begin_ctx function
+ * @param[in] HANDLE pointer to an ssd1306 handle structure
+ * @param[in] FUC pointer to a transfer_begin_ctx function address
+ * @note      optional, used instead of transfer_begin
+ */
+#define DRIVER_SSD1306_LINK_TRANSFER_BEGIN_CTX(HANDLE, FUC)            (HANDLE)->transfer_begin_ctx = FUC
+
+/**
+ * @brief     link transfer_end_ctx function
+ * @param[in] HANDLE pointer to an ssd1306 handle structure
+ * @param[in] FUC pointer to a transfer_end_ctx function address
+ * @note      optional, used instead of transfer_end
+ */
+#define DRIVER_SSD1306_LINK_TRANSFER_END_CTX(HANDLE, FUC)              (HANDLE)->transfer_end_ctx = FUC
+
+/**
+ * @brief     link iic_write_async_ctx function
+ * @param[in] HANDLE pointer to an ssd1306 handle structure
+ * @param[in] FUC pointer to an iic_write_async_ctx function address
+ * @note      optional, used instead of iic_write_async
+ */
+#define DRIVER_SSD1306_LINK_IIC_WRITE_ASYNC_CTX(HANDLE, FUC)           (HANDLE)->iic_write_async_ctx = FUC
+
+/**
+ * @brief     link spi_write_cmd_async_ctx function
+ * @param[in] HANDLE pointer to an ssd1306 handle structure
+ * @param[in] FUC pointer to a spi_write_cmd_async_ctx function address
+ * @note      optional, used instead of spi_write_cmd_async
+ */
+#define DRIVER_SSD1306_LINK_SPI_WRITE_COMMAND_ASYNC_CTX(HANDLE, FUC)   (HANDLE)->spi_write_cmd_async_ctx = FUC
+
+/**
+ * @brief     link lock function
+ * @param[in] HANDLE pointer to an ssd1306 handle structure
+ * @param[in] FUC pointer to a lock function address
+ * @note      optional, called with user_ctx while the gram or the dirty state changes,
+ *            it is never held during a bus transfer
+ */
+#define DRIVER_SSD1306_LINK_LOCK(HANDLE, FUC)                          (HANDLE)->lock = FUC
+
+/**
+ * @brief     link unlock function
+ * @param[in] HANDLE pointer to an ssd1306 handle structure
+ * @param[in] FUC pointer to an unlock function address
+ * @note      optional, linked together with lock
+ */
+#define DRIVER_SSD1306_LINK_UNLOCK(HANDLE, FUC)                        (HANDLE)->unlock = FUC
+
+/**
+ * @brief     link ring_lock function
+ * @param[in] HANDLE pointer to an ssd1306 handle structure
+ * @param[in] FUC pointer to a ring_lock function address
+ * @note      needed by the command ring without c11 atomics, called with user_ctx,
+ *            it must mask the interrupts that push to the ring
+ */
+#define DRIVER_SSD1306_LINK_RING_LOCK(HANDLE, FUC)                     (HANDLE)->ring_lock = FUC
+
+/**
+ * @brief     link ring_unlock function
+ * @param[in] HANDLE pointer to an ssd1306 handle structure
+ * @param[in] FUC pointer to a ring_unlock function address
+ * @note      linked together with ring_lock
+ */
+#define DRIVER_SSD1306_LINK_RING_UNLOCK(HANDLE, FUC)                   (HANDLE)->ring_unlock = FUC
+
+/**
+ * @brief     link the user context of a panel group
+ * @param[in] GROUP pointer to an ssd1306 group structure
+ * @param[in] CTX pointer to a user context
+ * @note      link it after ssd1306_group_init
+ */
+#define DRIVER_SSD1306_LINK_GROUP_USER_CTX(GROUP, CTX)                 (GROUP)->user_ctx = CTX
+
+/**
+ * @brief     link spi_write_cmd_all function
+ * @param[in] GROUP pointer to an ssd1306 group structure
+ * @param[in] FUC pointer to a spi_write_cmd_all function address
+ * @note      optional, writes with the chip select of every panel in the group asserted,
+ *            link it after ssd1306_group_init
+ */
+#define DRIVER_SSD1306_LINK_GROUP_SPI_WRITE_COMMAND_ALL(GROUP, FUC)    (GROUP)->spi_write_cmd_all = FUC
+
 /**
  * @}
  */
@@ -448,6 +948,125 @@ uint8_t ssd1306_set_addr_pin(ssd1306_handle_t *handle, ssd1306_address_t addr_pi
  */
 uint8_t ssd1306_get_addr_pin(ssd1306_handle_t *handle, ssd1306_address_t *addr_pin);
 
+/**
+ * @brief     set the max transfer length
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] len max bytes in one bus transfer
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ * @note      0 means no limit
+ */
+uint8_t ssd1306_set_max_transfer_length(ssd1306_handle_t *handle, uint16_t len);
+
+/**
+ * @brief      get the max transfer length
+ * @param[in]  *handle pointer to an ssd1306 handle structure
+ * @param[out] *len pointer to a length buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ * @note       none
+ */
+uint8_t ssd1306_get_max_transfer_length(ssd1306_handle_t *handle, uint16_t *len);
+
+/**
+ * @brief     enable or disable write combine of ssd1306_write_point
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] enable bool value
+ * @return    status code
+ *            - 0 success
+ *            - 1 set write combine failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      combined points are sent when the span moves or ssd1306_flush_pending is called,
+ *            a point joins the span across a gap cheaper than re-addressing in the cost model,
+ *            disabling sends the pending span
+ */
+uint8_t ssd1306_set_write_combine(ssd1306_handle_t *handle, ssd1306_write_combine_t enable);
+
+/**
+ * @brief      get the write combine status
+ * @param[in]  *handle pointer to an ssd1306 handle structure
+ * @param[out] *enable pointer to a bool value buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ * @note       none
+ */
+uint8_t ssd1306_get_write_combine(ssd1306_handle_t *handle, ssd1306_write_combine_t *enable);
+
+/**
+ * @brief     send the pending span of combined points
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 flush pending failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 flush is busy
+ * @note      none
+ */
+uint8_t ssd1306_flush_pending(ssd1306_handle_t *handle);
+
+/**
+ * @brief      get the data command gpio toggle count
+ * @param[in]  *handle pointer to an ssd1306 handle structure
+ * @param[out] *count pointer to a count buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ * @note       only spi interface writes the data command gpio
+ */
+uint8_t ssd1306_get_dc_toggle_count(ssd1306_handle_t *handle, uint32_t *count);
+
+/**
+ * @brief     clear the data command gpio toggle count
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ * @note      clear the count before a frame to get the toggles per frame
+ */
+uint8_t ssd1306_clear_dc_toggle_count(ssd1306_handle_t *handle);
+
+/**
+ * @brief     set the transport cost model
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] *model pointer to a cost model structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ * @note      an all zero model selects the interface default
+ */
+uint8_t ssd1306_set_cost_model(ssd1306_handle_t *handle, const ssd1306_cost_model_t *model);
+
+/**
+ * @brief      get the transport cost model
+ * @param[in]  *handle pointer to an ssd1306 handle structure
+ * @param[out] *model pointer to a cost model structure
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ * @note       none
+ */
+uint8_t ssd1306_get_cost_model(ssd1306_handle_t *handle, ssd1306_cost_model_t *model);
+
+/**
+ * @brief     set the back gram buffer
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] *buf pointer to a 128x8 gram buffer
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 4 flush is busy
+ * @note      the gram functions draw in the back buffer and the flush sends the flushing buffer,
+ *            which is handle->gram until ssd1306_gram_swap exchanges them, NULL disables double buffering,
+ *            the back buffer keeps its own dirty marks and they are merged at the swap,
+ *            so a flush between the drawing and the swap doesn't lose them
+ */
+uint8_t ssd1306_set_back_buffer(ssd1306_handle_t *handle, uint8_t (*buf)[8]);
+
 /**
  * @brief     initialize the chip
  * @param[in] *handle pointer to an ssd1306 handle structure
@@ -487,10 +1106,42 @@ uint8_t ssd1306_deinit(ssd1306_handle_t *handle);
  *            - 1 clear failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ *            - 4 flush is busy
+ * @note      the gram is filled in memory and sent as one full frame burst
  */
 uint8_t ssd1306_clear(ssd1306_handle_t *handle);
 
+/**
+ * @brief     fill the screen with a pattern
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] pattern fill byte of every column in a page
+ * @return    status code
+ *            - 0 success
+ *            - 1 fill failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 flush is busy
+ * @note      the gram is filled in memory and sent as one full frame burst
+ */
+uint8_t ssd1306_fill(ssd1306_handle_t *handle, uint8_t pattern);
+
+/**
+ * @brief     load an init table and clear the screen
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] *table pointer to an init table buffer
+ * @param[in] len table length
+ * @return    status code
+ *            - 0 success
+ *            - 1 load init table failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 table is invalid
+ *            - 5 flush is busy
+ * @note      the table is built with the SSD1306_INIT_* macros and sent in one command burst
+ *            after a full frame clear
+ */
+uint8_t ssd1306_load_init_table(ssd1306_handle_t *handle, const uint8_t *table, uint16_t len);
+
 /**
  * @brief     update the gram data
  * @param[in] *handle pointer to an ssd1306 handle structure
@@ -499,10 +1150,405 @@ uint8_t ssd1306_clear(ssd1306_handle_t *handle);
  *            - 1 gram update failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ * @note      the flush plan is chosen by the transport cost model
  */
 uint8_t ssd1306_gram_update(ssd1306_handle_t *handle);
 
+/**
+ * @brief     update the whole gram data in one transfer
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 gram update frame failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      the frame is sent in vertical addressing mode with the full window,
+ *            which matches the gram layout so the frame is sent in one burst, from its
+ *            snapshot in the shadow if SSD1306_SHADOW_ENABLE is set,
+ *            the next raw address or data call puts the application mode back
+ */
+uint8_t ssd1306_gram_update_frame(ssd1306_handle_t *handle);
+
+/**
+ * @brief     update the dirty gram data
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 gram update dirty failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      only the dirty column span of each dirty page is sent,
+ *            the flush plan is chosen by the transport cost model
+ */
+uint8_t ssd1306_gram_update_dirty(ssd1306_handle_t *handle);
+
+/**
+ * @brief     update the changed gram data
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 gram update diff failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 shadow is disabled
+ * @note      the gram is compared with the last data sent to the panel and only
+ *            the changed runs are sent, the flush plan is chosen by the transport
+ *            cost model, it needs SSD1306_SHADOW_ENABLE
+ */
+uint8_t ssd1306_gram_update_diff(ssd1306_handle_t *handle);
+
+/**
+ * @brief     start an asynchronous gram update
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] source flush source
+ * @return    status code
+ *            - 0 success
+ *            - 1 gram update async failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 async write is not linked
+ *            - 5 flush is busy
+ *            - 6 shadow is disabled
+ * @note      the gram and the other driver functions can't be used until
+ *            ssd1306_flush_poll reports the flush is not busy, the gram functions
+ *            return busy unless they draw in a back buffer
+ */
+uint8_t ssd1306_gram_update_async(ssd1306_handle_t *handle, ssd1306_flush_source_t source);
+
+/**
+ * @brief      poll the flush status
+ * @param[in]  *handle pointer to an ssd1306 handle structure
+ * @param[out] *status pointer to a flush status buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       an error status is reported once and then cleared,
+ *             the panel ram lost by the failed job is marked dirty here or at the next update
+ */
+uint8_t ssd1306_flush_poll(ssd1306_handle_t *handle, ssd1306_flush_status_t *status);
+
+/**
+ * @brief     irq handler
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 run failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      call it when an asynchronous write is done, it starts the next write
+ */
+uint8_t ssd1306_flush_irq_handler(ssd1306_handle_t *handle);
+
+/**
+ * @brief     swap the drawing and the flushing gram buffers
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 flush is busy
+ * @note      the new drawing buffer starts as a copy of the swapped frame,
+ *            the dirty marks of the drawn frame are handed to the next flush,
+ *            it does nothing without a back buffer
+ */
+uint8_t ssd1306_gram_swap(ssd1306_handle_t *handle);
+
+/**
+ * @brief      run one bounded step of a gram update
+ * @param[in]  *handle pointer to an ssd1306 handle structure
+ * @param[in]  source flush source
+ * @param[in]  max_len max bytes sent in this call
+ * @param[out] *status pointer to a flush status buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 gram update step failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 flush is busy
+ *             - 5 shadow is disabled
+ * @note       a new update is planned when no update is in progress, 0 max_len means one page,
+ *             at least one write is done in each call and a command is never split,
+ *             the gram functions return busy between the steps unless they draw in a back buffer
+ */
+uint8_t ssd1306_gram_update_step(ssd1306_handle_t *handle, ssd1306_flush_source_t source, 
+                                 uint16_t max_len, ssd1306_flush_status_t *status);
+
+/**
+ * @brief     init a bus scheduler
+ * @param[in] *bus pointer to an ssd1306 bus structure
+ * @param[in] quantum max bytes sent for one panel in one turn
+ * @return    status code
+ *            - 0 success
+ *            - 2 bus is NULL
+ * @note      0 quantum means one page
+ */
+uint8_t ssd1306_bus_init(ssd1306_bus_t *bus, uint16_t quantum);
+
+/**
+ * @brief     add a panel to a bus scheduler
+ * @param[in] *bus pointer to an ssd1306 bus structure
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 bus or handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 bus is full
+ *            - 5 panel is already on the bus
+ * @note      none
+ */
+uint8_t ssd1306_bus_add(ssd1306_bus_t *bus, ssd1306_handle_t *handle);
+
+/**
+ * @brief      run one turn of a bus scheduler
+ * @param[in]  *bus pointer to an ssd1306 bus structure
+ * @param[out] *status pointer to a flush status buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 bus flush step failed
+ *             - 2 bus is NULL
+ * @note       the next panel with dirty data after the last served one gets one bounded update step,
+ *             so every dirty panel is served within one turn per panel on the bus,
+ *             status is busy while any panel still has dirty data
+ */
+uint8_t ssd1306_bus_flush_step(ssd1306_bus_t *bus, ssd1306_flush_status_t *status);
+
+/**
+ * @brief      get the bus scheduler statistics
+ * @param[in]  *bus pointer to an ssd1306 bus structure
+ * @param[out] *stats pointer to a bus statistics structure
+ * @return     status code
+ *             - 0 success
+ *             - 2 bus is NULL
+ * @note       stats.estimated_cost is summed from the cost model of each panel, the driver keeps no clock,
+ *             so a utilization is stats.estimated_cost over an elapsed time the caller measures in the same unit
+ */
+uint8_t ssd1306_bus_get_stats(ssd1306_bus_t *bus, ssd1306_bus_stats_t *stats);
+
+/**
+ * @brief     clear the bus scheduler statistics
+ * @param[in] *bus pointer to an ssd1306 bus structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 bus is NULL
+ * @note      none
+ */
+uint8_t ssd1306_bus_clear_stats(ssd1306_bus_t *bus);
+
+/**
+ * @brief     init a panel group
+ * @param[in] *group pointer to an ssd1306 group structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 group is NULL
+ * @note      none
+ */
+uint8_t ssd1306_group_init(ssd1306_group_t *group);
+
+/**
+ * @brief     add a panel to a group
+ * @param[in] *group pointer to an ssd1306 group structure
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 group or handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 group is full
+ *            - 5 handle is not spi or is in a group
+ * @note      the panels of a group share sclk, mosi and the data command line and differ in chip select
+ */
+uint8_t ssd1306_group_add(ssd1306_group_t *group, ssd1306_handle_t *handle);
+
+/**
+ * @brief     write a command stream to every panel of a group
+ * @param[in] *group pointer to an ssd1306 group structure
+ * @param[in] *buf pointer to a command buffer
+ * @param[in] len buffer length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write command failed
+ *            - 2 group is NULL
+ *            - 3 group is empty or a panel is not initialized
+ *            - 4 command stream is invalid
+ *            - 5 flush is busy
+ * @note      the stream is sent once with spi_write_cmd_all when it is linked, else once per panel
+ */
+uint8_t ssd1306_group_write_command(ssd1306_group_t *group, uint8_t *buf, uint16_t len);
+
+/**
+ * @brief     load an init table to every panel of a group and clear the screens
+ * @param[in] *group pointer to an ssd1306 group structure
+ * @param[in] *table pointer to an init table buffer
+ * @param[in] len table length
+ * @return    status code
+ *            - 0 success
+ *            - 1 load init table failed
+ *            - 2 group is NULL
+ *            - 3 group is empty or a panel is not initialized
+ *            - 4 table is invalid
+ *            - 5 flush is busy
+ * @note      the screens are cleared panel by panel, the table is sent like ssd1306_group_write_command
+ */
+uint8_t ssd1306_group_load_init_table(ssd1306_group_t *group, const uint8_t *table, uint16_t len);
+
+/**
+ * @brief     enable or disable the display of every panel of a group
+ * @param[in] *group pointer to an ssd1306 group structure
+ * @param[in] on_off display on or off
+ * @return    status code
+ *            - 0 success
+ *            - 1 set display failed
+ *            - 2 group is NULL
+ *            - 3 group is empty or a panel is not initialized
+ *            - 5 flush is busy
+ * @note      none
+ */
+uint8_t ssd1306_group_set_display(ssd1306_group_t *group, ssd1306_display_t on_off);
+
+/**
+ * @brief     set the contrast of every panel of a group
+ * @param[in] *group pointer to an ssd1306 group structure
+ * @param[in] contrast display contrast
+ * @return    status code
+ *            - 0 success
+ *            - 1 set contrast failed
+ *            - 2 group is NULL
+ *            - 3 group is empty or a panel is not initialized
+ *            - 5 flush is busy
+ * @note      none
+ */
+uint8_t ssd1306_group_set_contrast(ssd1306_group_t *group, uint8_t contrast);
+
+/**
+ * @brief     init a frame hand-off
+ * @param[in] *handoff pointer to an ssd1306 hand-off structure
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 handoff or handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 no atomics and no lock linked
+ * @note      one renderer publishes frames and one flush task consumes them,
+ *            without c11 atomics the index swap is done under the lock hooks
+ */
+uint8_t ssd1306_handoff_init(ssd1306_handoff_t *handoff, ssd1306_handle_t *handle);
+
+/**
+ * @brief      get the frame the renderer draws in
+ * @param[in]  *handoff pointer to an ssd1306 hand-off structure
+ * @param[out] **frame pointer to a frame pointer buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handoff is NULL
+ * @note       the frame is 1024 bytes in page format and holds an older frame, draw all of it,
+ *             it changes after every ssd1306_handoff_publish
+ */
+uint8_t ssd1306_handoff_get_frame(ssd1306_handoff_t *handoff, uint8_t **frame);
+
+/**
+ * @brief     publish the drawn frame
+ * @param[in] *handoff pointer to an ssd1306 hand-off structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 handoff is NULL
+ * @note      renderer only, never blocks on the flush, a frame not yet consumed is replaced
+ */
+uint8_t ssd1306_handoff_publish(ssd1306_handoff_t *handoff);
+
+/**
+ * @brief      consume the latest published frame
+ * @param[in]  *handoff pointer to an ssd1306 hand-off structure
+ * @param[out] *fresh pointer to a fresh flag buffer, 1 if a new frame is written to the gram
+ * @return     status code
+ *             - 0 success
+ *             - 2 handoff is NULL
+ *             - 3 handle is not initialized
+ * @note       flush task only, the changed bytes of the frame are marked dirty,
+ *             call a gram update afterwards
+ */
+uint8_t ssd1306_handoff_consume(ssd1306_handoff_t *handoff, uint8_t *fresh);
+
+/**
+ * @brief     init a command ring
+ * @param[in] *ring pointer to an ssd1306 ring structure
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 ring or handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 no atomics and no ring lock linked
+ * @note      without c11 atomics the ring is guarded by the ring lock hooks,
+ *            which must mask the interrupts that push, the gram lock is never taken
+ */
+uint8_t ssd1306_ring_init(ssd1306_ring_t *ring, ssd1306_handle_t *handle);
+
+/**
+ * @brief     push a command stream to a ring
+ * @param[in] *ring pointer to an ssd1306 ring structure
+ * @param[in] *cmd pointer to a command buffer
+ * @param[in] len buffer length
+ * @return    status code
+ *            - 0 success
+ *            - 2 ring is NULL
+ *            - 4 command stream is invalid
+ *            - 5 ring is full
+ * @note      interrupt safe, lock free with c11 atomics, else under the ring lock,
+ *            it never blocks on the bus, the stream is made of whole commands and is SSD1306_RING_MAX_CMD_LEN bytes at most
+ */
+uint8_t ssd1306_ring_push(ssd1306_ring_t *ring, uint8_t *cmd, uint8_t len);
+
+/**
+ * @brief     push a contrast change to a ring
+ * @param[in] *ring pointer to an ssd1306 ring structure
+ * @param[in] contrast display contrast
+ * @return    status code
+ *            - 0 success
+ *            - 2 ring is NULL
+ *            - 5 ring is full
+ * @note      interrupt safe
+ */
+uint8_t ssd1306_ring_push_contrast(ssd1306_ring_t *ring, uint8_t contrast);
+
+/**
+ * @brief     push a display mode change to a ring
+ * @param[in] *ring pointer to an ssd1306 ring structure
+ * @param[in] mode display mode
+ * @return    status code
+ *            - 0 success
+ *            - 2 ring is NULL
+ *            - 5 ring is full
+ * @note      interrupt safe
+ */
+uint8_t ssd1306_ring_push_display_mode(ssd1306_ring_t *ring, ssd1306_display_mode_t mode);
+
+/**
+ * @brief     push a display on or off to a ring
+ * @param[in] *ring pointer to an ssd1306 ring structure
+ * @param[in] on_off display on or off
+ * @return    status code
+ *            - 0 success
+ *            - 2 ring is NULL
+ *            - 5 ring is full
+ * @note      interrupt safe
+ */
+uint8_t ssd1306_ring_push_display(ssd1306_ring_t *ring, ssd1306_display_t on_off);
+
+/**
+ * @brief      send the commands queued in a ring
+ * @param[in]  *ring pointer to an ssd1306 ring structure
+ * @param[out] *count pointer to a drained command count buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 drain failed
+ *             - 2 ring is NULL
+ *             - 3 handle is not initialized
+ *             - 4 flush is busy
+ * @note       flush task only, the queued commands go out in one command write,
+ *             back to back contrast, display mode, display or entire display settings
+ *             of the same kind collapse to the last one, queue order is kept otherwise
+ */
+uint8_t ssd1306_ring_drain(ssd1306_ring_t *ring, uint8_t *count);
+
 /**
  * @brief     write a point
  * @param[in] *handle pointer to an ssd1306 handle structure
@@ -515,7 +1561,8 @@ uint8_t ssd1306_gram_update(ssd1306_handle_t *handle);
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
  *            - 4 x or y is invalid
- * @note      none
+ *            - 5 flush is busy
+ * @note      the point is held in a pending span if write combine is enabled
  */
 uint8_t ssd1306_write_point(ssd1306_handle_t *handle, uint8_t x, uint8_t y, uint8_t data);
 
@@ -547,6 +1594,7 @@ uint8_t ssd1306_read_point(ssd1306_handle_t *handle, uint8_t x, uint8_t y, uint8
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
  *            - 4 x or y is invalid
+ *            - 5 flush is busy
  * @note      none
  */
 uint8_t ssd1306_gram_write_point(ssd1306_handle_t *handle, uint8_t x, uint8_t y, uint8_t data);
@@ -582,6 +1630,7 @@ uint8_t ssd1306_gram_read_point(ssd1306_handle_t *handle, uint8_t x, uint8_t y,
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
  *            - 4 x or y is invalid
+ *            - 5 flush is busy
  * @note      none
  */
 uint8_t ssd1306_gram_write_string(ssd1306_handle_t *handle, uint8_t x, uint8_t y, char *str, uint16_t len, uint8_t color, ssd1306_font_t font);
@@ -602,6 +1651,7 @@ uint8_t ssd1306_gram_write_string(ssd1306_handle_t *handle, uint8_t x, uint8_t y
  *            - 4 left or top is invalid
  *            - 5 right or bottom is invalid
  *            - 6 left > right or top > bottom
+ *            - 7 flush is busy
  * @note      none
  */
 uint8_t ssd1306_gram_fill_rect(ssd1306_handle_t *handle, uint8_t left, uint8_t top, uint8_t right, uint8_t bottom, uint8_t color);
@@ -622,10 +1672,47 @@ uint8_t ssd1306_gram_fill_rect(ssd1306_handle_t *handle, uint8_t left, uint8_t t
  *            - 4 left or top is invalid
  *            - 5 right or bottom is invalid
  *            - 6 left > right or top > bottom
+ *            - 7 flush is busy
  * @note      none
  */
 uint8_t ssd1306_gram_draw_picture(ssd1306_handle_t *handle, uint8_t left, uint8_t top, uint8_t right, uint8_t bottom, uint8_t *img);
 
+/**
+ * @brief     write a full page format frame to the gram
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] *frame pointer to a 1024 bytes frame buffer
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 flush is busy
+ * @note      frame[page * 128 + column] holds the 8 vertical pixels of the column in the page,
+ *            only the changed bytes are marked dirty
+ */
+uint8_t ssd1306_gram_write_frame(ssd1306_handle_t *handle, uint8_t *frame);
+
+/**
+ * @brief     draw a packed bitmap in the gram
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] left left coordinate x
+ * @param[in] top top coordinate y
+ * @param[in] right right coordinate x
+ * @param[in] bottom bottom coordinate y
+ * @param[in] *bits pointer to a packed bitmap buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 gram draw bitmap failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 left or top is invalid
+ *            - 5 right or bottom is invalid
+ *            - 6 left > right or top > bottom
+ *            - 7 flush is busy
+ * @note      the bitmap is 1 bit per pixel in rows from top to bottom, msb first,
+ *            and every row is padded to a whole byte
+ */
+uint8_t ssd1306_gram_draw_bitmap(ssd1306_handle_t *handle, uint8_t left, uint8_t top, uint8_t right, uint8_t bottom, uint8_t *bits);
+
 /**
  * @brief     set the low column start address
  * @param[in] *handle pointer to an ssd1306 handle structure
@@ -636,6 +1723,7 @@ uint8_t ssd1306_gram_draw_picture(ssd1306_handle_t *handle, uint8_t left, uint8_
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
  *            - 4 addr is invalid
+ *            - 5 flush is busy
  * @note      addr <= 0xF
  */
 uint8_t ssd1306_set_low_column_start_address(ssd1306_handle_t *handle, uint8_t addr);
@@ -650,6 +1738,7 @@ uint8_t ssd1306_set_low_column_start_address(ssd1306_handle_t *handle, uint8_t a
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
  *            - 4 addr is invalid
+ *            - 5 flush is busy
  * @note      addr <= 0xF
  */
 uint8_t ssd1306_set_high_column_start_address(ssd1306_handle_t *handle, uint8_t addr);
@@ -663,7 +1752,9 @@ uint8_t ssd1306_set_high_column_start_address(ssd1306_handle_t *handle, uint8_t
  *            - 1 set memory addressing mode failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ *            - 4 flush is busy
+ * @note      the gram flushes switch the panel to their own mode,
+ *            the raw address, command and data functions put this mode back first
  */
 uint8_t ssd1306_set_memory_addressing_mode(ssd1306_handle_t *handle, ssd1306_memory_addressing_mode_t mode);
 
@@ -679,6 +1770,7 @@ uint8_t ssd1306_set_memory_addressing_mode(ssd1306_handle_t *handle, ssd1306_mem
  *            - 3 handle is not initialized
  *            - 4 start addr is invalid
  *            - 5 end addr is invalid
+ *            - 6 flush is busy
  * @note      start addr and end addr can't be over 0x7F
  */
 uint8_t ssd1306_set_column_address_range(ssd1306_handle_t *handle, uint8_t start_addr, uint8_t end_addr);
@@ -695,6 +1787,7 @@ uint8_t ssd1306_set_column_address_range(ssd1306_handle_t *handle, uint8_t start
  *            - 3 handle is not initialized
  *            - 4 start addr is invalid
  *            - 5 end addr is invalid
+ *            - 6 flush is busy
  * @note      start addr and end addr can't be over 0x07
  */
 uint8_t ssd1306_set_page_address_range(ssd1306_handle_t *handle, uint8_t start_addr, uint8_t end_addr);
@@ -948,6 +2041,7 @@ uint8_t ssd1306_set_display(ssd1306_handle_t *handle, ssd1306_display_t on_off);
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
  *            - 4 addr is invalid
+ *            - 5 flush is busy
  * @note      addr <= 0x07
  */
 uint8_t ssd1306_set_page_address(ssd1306_handle_t *handle, uint8_t addr);
@@ -1072,6 +2166,7 @@ uint8_t ssd1306_set_deselect_level(ssd1306_handle_t *handle, ssd1306_deselect_le
  *            - 1 write failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
+ *            - 4 flush is busy
  * @note      none
  */
 uint8_t ssd1306_write_cmd(ssd1306_handle_t *handle, uint8_t *buf, uint8_t len);
@@ -1086,10 +2181,70 @@ uint8_t ssd1306_write_cmd(ssd1306_handle_t *handle, uint8_t *buf, uint8_t len);
  *            - 1 write failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
+ *            - 4 flush is busy
  * @note      none
  */
 uint8_t ssd1306_write_data(ssd1306_handle_t *handle, uint8_t *buf, uint8_t len);
 
+/**
+ * @brief     open a command batch
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 batch is already open
+ *            - 5 flush is busy
+ * @note      all writes are collected until ssd1306_batch_commit,
+ *            commands and one trailing data run go in one iic transaction,
+ *            without SSD1306_BATCH_ENABLE the writes are sent at once between
+ *            transfer_begin and transfer_end
+ */
+uint8_t ssd1306_batch_begin(ssd1306_handle_t *handle);
+
+/**
+ * @brief     add commands to the command batch
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] *buf pointer to a command buffer
+ * @param[in] len command length
+ * @return    status code
+ *            - 0 success
+ *            - 1 batch cmd failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 batch is not open
+ * @note      the batch is sent early if it is full or data is already batched
+ */
+uint8_t ssd1306_batch_cmd(ssd1306_handle_t *handle, uint8_t *buf, uint8_t len);
+
+/**
+ * @brief     add data to the command batch
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 batch data failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 batch is not open
+ * @note      the batch is sent early if it is full
+ */
+uint8_t ssd1306_batch_data(ssd1306_handle_t *handle, uint8_t *buf, uint16_t len);
+
+/**
+ * @brief     send and close the command batch
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 batch commit failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 batch is not open
+ * @note      none
+ */
+uint8_t ssd1306_batch_commit(ssd1306_handle_t *handle);
+
 /**
  * @}
  */
@@ -0,0 +1,341 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_ssd1306_async_test.c
+ * @brief     driver ssd1306 async test source file
+ * @version   2.0.0
+ * @author    Shifeng Li
+ * @date      2021-03-30
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2021/03/30  <td>2.0      <td>Shifeng Li  <td>format the code
+ * <tr><td>2020/12/10  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_ssd1306_async_test.h"
+
+static ssd1306_handle_t gs_handle;          /**< ssd1306 handle */
+static ssd1306_emulator_t gs_emulator;      /**< ssd1306 emulator */
+static uint8_t gs_back[128][8];             /**< back gram buffer */
+
+/**
+ * @brief     run an asynchronous update until it is done
+ * @param[in] source flush source
+ * @return    status code
+ *            - 0 success
+ *            - 1 run failed
+ * @note      the emulator completes one write at a time like a dma done interrupt
+ */
+static uint8_t a_async_test_run(ssd1306_flush_source_t source)
+{
+    uint8_t res;
+    uint16_t writes;
+    ssd1306_flush_status_t status;
+    
+    res = ssd1306_gram_update_async(&gs_handle, source);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: gram update async failed.\n");
+        
+        return 1;
+    }
+    
+    /* the gram can't be flushed again while the job runs */
+    res = ssd1306_gram_update(&gs_handle);
+    if (res == 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: gram update is not busy.\n");
+        
+        return 1;
+    }
+    
+    writes = 0;
+    while (ssd1306_emulator_test_complete(&gs_handle) != 0)
+    {
+        writes++;
+        if (writes > 1024)
+        {
+            ssd1306_interface_debug_print("ssd1306: async update never ends.\n");
+            
+            return 1;
+        }
+    }
+    res = ssd1306_flush_poll(&gs_handle, &status);
+    if ((res != 0) || (status != SSD1306_FLUSH_STATUS_DONE))
+    {
+        ssd1306_interface_debug_print("ssd1306: async update is not done.\n");
+        
+        return 1;
+    }
+    ssd1306_interface_debug_print("ssd1306: async update completed %d writes.\n", writes);
+    if (ssd1306_emulator_test_compare(&gs_emulator, gs_handle.gram) != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: async update is not on the panel.\n");
+        
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     async test
+ * @param[in] interface interface type
+ * @return    status code
+ *            - 0 success
+ *            - 1 test failed
+ * @note      the panel and the write completions are emulated, no hardware is needed
+ */
+uint8_t ssd1306_async_test(ssd1306_interface_t interface)
+{
+    uint8_t res;
+    uint8_t i;
+    uint8_t j;
+    ssd1306_flush_status_t status;
+    
+    /* link the emulator */
+    ssd1306_emulator_test_link(&gs_handle, &gs_emulator);
+    ssd1306_emulator_test_link_async(&gs_handle);
+    
+    /* start async test */
+    ssd1306_interface_debug_print("ssd1306: start async test.\n");
+    
+    /* set interface */
+    res = ssd1306_set_interface(&gs_handle, interface);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: set interface failed.\n");
+        
+        return 1;
+    }
+    
+    /* set addr pin */
+    res = ssd1306_set_addr_pin(&gs_handle, SSD1306_ADDR_SA0_0);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: set addr failed.\n");
+        
+        return 1;
+    }
+    
+    /* ssd1306 init */
+    res = ssd1306_init(&gs_handle);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: init failed.\n");
+        
+        return 1;
+    }
+    
+    /* the whole gram */
+    for (i = 0; i < 128; i++)
+    {
+        for (j = 0; j < 8; j++)
+        {
+            gs_handle.gram[i][j] = (uint8_t)(0xA5 ^ i ^ j);
+        }
+    }
+    if (a_async_test_run(SSD1306_FLUSH_SOURCE_ALL) != 0)
+    {
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* the dirty spans */
+    res = ssd1306_gram_fill_rect(&gs_handle, 20, 10, 40, 30, 1);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: gram fill rect failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    if (a_async_test_run(SSD1306_FLUSH_SOURCE_DIRTY) != 0)
+    {
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* drawing in the flushing buffer is refused while the job runs */
+    res = ssd1306_gram_update_async(&gs_handle, SSD1306_FLUSH_SOURCE_ALL);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: gram update async failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    (void)ssd1306_emulator_test_complete(&gs_handle);
+    if ((ssd1306_gram_fill_rect(&gs_handle, 0, 0, 127, 63, 0) != 7) ||
+        (ssd1306_gram_write_point(&gs_handle, 5, 5, 0) != 5) ||
+        (ssd1306_gram_write_string(&gs_handle, 0, 0, "ab", 2, 1, SSD1306_FONT_12) != 5))
+    {
+        ssd1306_interface_debug_print("ssd1306: gram drawing is not busy.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    while (ssd1306_emulator_test_complete(&gs_handle) != 0)
+    {
+    }
+    res = ssd1306_flush_poll(&gs_handle, &status);
+    if ((res != 0) || (status != SSD1306_FLUSH_STATUS_DONE) ||
+        (ssd1306_emulator_test_compare(&gs_emulator, gs_handle.gram) != 0))
+    {
+        ssd1306_interface_debug_print("ssd1306: busy drawing changed the panel.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* a back buffer can be drawn while the job runs */
+    res = ssd1306_set_back_buffer(&gs_handle, gs_back);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: set back buffer failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    res = ssd1306_gram_update_async(&gs_handle, SSD1306_FLUSH_SOURCE_ALL);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: gram update async failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    (void)ssd1306_emulator_test_complete(&gs_handle);
+    res = ssd1306_gram_fill_rect(&gs_handle, 0, 0, 63, 31, 0);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: gram fill rect failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    while (ssd1306_emulator_test_complete(&gs_handle) != 0)
+    {
+    }
+    res = ssd1306_flush_poll(&gs_handle, &status);
+    if ((res != 0) || (status != SSD1306_FLUSH_STATUS_DONE) ||
+        (ssd1306_emulator_test_compare(&gs_emulator, gs_handle.gram) != 0))
+    {
+        ssd1306_interface_debug_print("ssd1306: back buffer drawing changed the panel.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    res = ssd1306_gram_swap(&gs_handle);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: gram swap failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    if (a_async_test_run(SSD1306_FLUSH_SOURCE_DIRTY) != 0)
+    {
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    res = ssd1306_set_back_buffer(&gs_handle, NULL);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: set back buffer failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* a failed write is reported once */
+    res = ssd1306_gram_fill_rect(&gs_handle, 0, 0, 127, 63, 0);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: gram fill rect failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    res = ssd1306_gram_update_async(&gs_handle, SSD1306_FLUSH_SOURCE_ALL);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: gram update async failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    gs_emulator.fail = 1;
+    while (ssd1306_emulator_test_complete(&gs_handle) != 0)
+    {
+    }
+    gs_emulator.fail = 0;
+    if ((gs_handle.job.lost == 0) || (gs_handle.dirty_page != 0))
+    {
+        ssd1306_interface_debug_print("ssd1306: irq handler touched the dirty state.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    res = ssd1306_flush_poll(&gs_handle, &status);
+    if ((res != 0) || (status != SSD1306_FLUSH_STATUS_ERROR))
+    {
+        ssd1306_interface_debug_print("ssd1306: async error is not reported.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    res = ssd1306_flush_poll(&gs_handle, &status);
+    if ((res != 0) || (status != SSD1306_FLUSH_STATUS_DONE))
+    {
+        ssd1306_interface_debug_print("ssd1306: async error is not cleared.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    if (gs_handle.dirty_page != 0xFF)
+    {
+        ssd1306_interface_debug_print("ssd1306: lost panel ram is not dirty.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    if (a_async_test_run(SSD1306_FLUSH_SOURCE_DIRTY) != 0)
+    {
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* finish async test */
+    ssd1306_interface_debug_print("ssd1306: finish async test.\n");
+    (void)ssd1306_deinit(&gs_handle);
+    
+    return 0;
+}
@@ -0,0 +1,72 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_ssd1306_async_test.h
+ * @brief     driver ssd1306 async test header file
+ * @version   2.0.0
+ * @author    Shifeng Li
+ * @date      2021-03-30
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2021/03/30  <td>2.0      <td>Shifeng Li  <td>format the code
+ * <tr><td>2020/12/10  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef DRIVER_SSD1306_ASYNC_TEST_H
+#define DRIVER_SSD1306_ASYNC_TEST_H
+
+#include "driver_ssd1306_emulator_test.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup ssd1306_test_driver ssd1306 test driver function
+ * @brief    ssd1306 test driver modules
+ * @ingroup  ssd1306_driver
+ * @{
+ */
+
+/**
+ * @brief     async test
+ * @param[in] interface interface type
+ * @return    status code
+ *            - 0 success
+ *            - 1 test failed
+ * @note      the panel and the write completions are emulated, no hardware is needed
+ */
+uint8_t ssd1306_async_test(ssd1306_interface_t interface);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,248 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_ssd1306_batch_test.c
+ * @brief     driver ssd1306 batch test source file
+ * @version   2.0.0
+ * @author    Shifeng Li
+ * @date      2021-03-30
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2021/03/30  <td>2.0      <td>Shifeng Li  <td>format the code
+ * <tr><td>2020/12/10  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_ssd1306_batch_test.h"
+
+static ssd1306_handle_t gs_handle;          /**< ssd1306 handle */
+static ssd1306_emulator_t gs_emulator;      /**< ssd1306 emulator */
+
+/**
+ * @brief     write a page mode run of data
+ * @param[in] *data pointer to a 16 bytes data buffer
+ * @param[in] batch 1 to send the writes in a batch
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the run goes to page 2 from column 0
+ */
+static uint8_t a_batch_test_write(uint8_t *data, uint8_t batch)
+{
+    uint8_t cmd[3];
+    uint8_t contrast[2];
+    
+    contrast[0] = 0x81;
+    contrast[1] = 0x7F;
+    cmd[0] = 0xB2;
+    cmd[1] = 0x00;
+    cmd[2] = 0x10;
+    if (batch != 0)
+    {
+        if ((ssd1306_batch_begin(&gs_handle) != 0) ||
+            (ssd1306_batch_cmd(&gs_handle, contrast, 2) != 0) ||
+            (ssd1306_batch_cmd(&gs_handle, cmd, 3) != 0) ||
+            (ssd1306_batch_data(&gs_handle, data, 16) != 0) ||
+            (ssd1306_batch_commit(&gs_handle) != 0))
+        {
+            ssd1306_interface_debug_print("ssd1306: batch write failed.\n");
+            
+            return 1;
+        }
+    }
+    else
+    {
+        if ((ssd1306_write_cmd(&gs_handle, contrast, 2) != 0) ||
+            (ssd1306_write_cmd(&gs_handle, cmd, 3) != 0) ||
+            (ssd1306_write_data(&gs_handle, data, 16) != 0))
+        {
+            ssd1306_interface_debug_print("ssd1306: write failed.\n");
+            
+            return 1;
+        }
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief  command batch test
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ *         - 2 test not run
+ * @note   the panel is emulated, no hardware is needed, it needs SSD1306_BATCH_ENABLE
+ */
+uint8_t ssd1306_batch_test(void)
+{
+    uint8_t res;
+    uint8_t i;
+    uint8_t data[16];
+    uint32_t batch_transactions;
+    uint32_t plain_transactions;
+    
+    /* link the emulator */
+    ssd1306_emulator_test_link(&gs_handle, &gs_emulator);
+    
+    /* start batch test */
+    ssd1306_interface_debug_print("ssd1306: start batch test.\n");
+    
+#if (SSD1306_BATCH_ENABLE == 0)
+    /* the batch needs its buffer */
+    (void)res;
+    (void)i;
+    (void)data;
+    (void)batch_transactions;
+    (void)plain_transactions;
+    (void)a_batch_test_write;
+    ssd1306_interface_debug_print("ssd1306: batch is disabled, batch test not run.\n");
+    
+    return 2;
+#else
+    /* set interface */
+    res = ssd1306_set_interface(&gs_handle, SSD1306_INTERFACE_IIC);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: set interface failed.\n");
+        
+        return 1;
+    }
+    
+    /* set addr pin */
+    res = ssd1306_set_addr_pin(&gs_handle, SSD1306_ADDR_SA0_0);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: set addr failed.\n");
+        
+        return 1;
+    }
+    
+    /* ssd1306 init */
+    res = ssd1306_init(&gs_handle);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: init failed.\n");
+        
+        return 1;
+    }
+    
+    /* the writes one by one */
+    for (i = 0; i < 16; i++)
+    {
+        data[i] = (uint8_t)(0x40 | i);
+    }
+    ssd1306_emulator_test_clear(&gs_emulator);
+    if (a_batch_test_write(data, 0) != 0)
+    {
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    plain_transactions = gs_emulator.transactions;
+    
+    /* the same writes in a batch */
+    for (i = 0; i < 16; i++)
+    {
+        data[i] = (uint8_t)(0x80 | i);
+    }
+    ssd1306_emulator_test_clear(&gs_emulator);
+    if (a_batch_test_write(data, 1) != 0)
+    {
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    batch_transactions = gs_emulator.transactions;
+    ssd1306_interface_debug_print("ssd1306: plain writes sent %d transactions, batch sent %d transactions.\n",
+                                  plain_transactions, batch_transactions);
+    if ((plain_transactions != 3) || (batch_transactions != 1))
+    {
+        ssd1306_interface_debug_print("ssd1306: batch transaction count is wrong.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    for (i = 0; i < 16; i++)
+    {
+        if (gs_emulator.ram[2][i] != data[i])
+        {
+            ssd1306_interface_debug_print("ssd1306: batch data missed page 2 column %d.\n", i);
+            (void)ssd1306_deinit(&gs_handle);
+            
+            return 1;
+        }
+    }
+    if ((gs_emulator.log_len < 2) || (gs_emulator.log[0] != 0x81) || (gs_emulator.log[1] != 0x7F))
+    {
+        ssd1306_interface_debug_print("ssd1306: batch commands are wrong.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* the setters in a batch */
+    ssd1306_emulator_test_clear(&gs_emulator);
+    res = ssd1306_batch_begin(&gs_handle);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: batch begin failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    if ((ssd1306_set_contrast(&gs_handle, 0x20) != 0) ||
+        (ssd1306_set_display_start_line(&gs_handle, 0) != 0) ||
+        (ssd1306_set_display(&gs_handle, SSD1306_DISPLAY_ON) != 0))
+    {
+        ssd1306_interface_debug_print("ssd1306: batch setters failed.\n");
+        (void)ssd1306_batch_commit(&gs_handle);
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    res = ssd1306_batch_commit(&gs_handle);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: batch commit failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    ssd1306_interface_debug_print("ssd1306: batch setters sent %d transactions.\n", gs_emulator.transactions);
+    if (gs_emulator.transactions != 1)
+    {
+        ssd1306_interface_debug_print("ssd1306: batch setters sent more than 1 transaction.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* finish batch test */
+    ssd1306_interface_debug_print("ssd1306: finish batch test.\n");
+    (void)ssd1306_deinit(&gs_handle);
+    
+    return 0;
+#endif
+}
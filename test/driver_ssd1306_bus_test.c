@@ -0,0 +1,256 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_ssd1306_bus_test.c
+ * @brief     driver ssd1306 bus scheduler test source file
+ * @version   2.0.0
+ * @author    Shifeng Li
+ * @date      2021-03-30
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2021/03/30  <td>2.0      <td>Shifeng Li  <td>format the code
+ * <tr><td>2020/12/10  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_ssd1306_bus_test.h"
+
+static ssd1306_handle_t gs_handle[2];       /**< ssd1306 handles */
+static ssd1306_emulator_t gs_emulator[2];   /**< ssd1306 emulators */
+static ssd1306_bus_t gs_bus;                /**< ssd1306 bus scheduler */
+
+/**
+ * @brief     init an emulated panel
+ * @param[in] i panel index
+ * @return    status code
+ *            - 0 success
+ *            - 1 init failed
+ * @note      none
+ */
+static uint8_t a_bus_test_init(uint8_t i)
+{
+    ssd1306_emulator_test_link(&gs_handle[i], &gs_emulator[i]);
+    if (ssd1306_set_interface(&gs_handle[i], SSD1306_INTERFACE_SPI) != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: set interface failed.\n");
+        
+        return 1;
+    }
+    if (ssd1306_init(&gs_handle[i]) != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: init failed.\n");
+        
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief  bus scheduler test
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   the panels are emulated, no hardware is needed
+ */
+uint8_t ssd1306_bus_test(void)
+{
+    uint8_t res;
+    uint8_t i;
+    uint16_t turns;
+    uint32_t bytes;
+    uint32_t transactions;
+    uint32_t cost;
+    ssd1306_bus_stats_t stats;
+    ssd1306_flush_status_t status;
+    
+    /* start bus test */
+    ssd1306_interface_debug_print("ssd1306: start bus test.\n");
+    
+    /* two panels on one bus */
+    if ((a_bus_test_init(0) != 0) || (a_bus_test_init(1) != 0))
+    {
+        (void)ssd1306_deinit(&gs_handle[0]);
+        
+        return 1;
+    }
+    res = ssd1306_bus_init(&gs_bus, 0);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: bus init failed.\n");
+        (void)ssd1306_deinit(&gs_handle[0]);
+        (void)ssd1306_deinit(&gs_handle[1]);
+        
+        return 1;
+    }
+    if ((ssd1306_bus_add(&gs_bus, &gs_handle[0]) != 0) || (ssd1306_bus_add(&gs_bus, &gs_handle[1]) != 0))
+    {
+        ssd1306_interface_debug_print("ssd1306: bus add failed.\n");
+        (void)ssd1306_deinit(&gs_handle[0]);
+        (void)ssd1306_deinit(&gs_handle[1]);
+        
+        return 1;
+    }
+    
+    /* a panel is added once */
+    res = ssd1306_bus_add(&gs_bus, &gs_handle[1]);
+    if (res != 5)
+    {
+        ssd1306_interface_debug_print("ssd1306: duplicate bus add returned %d.\n", res);
+        (void)ssd1306_deinit(&gs_handle[0]);
+        (void)ssd1306_deinit(&gs_handle[1]);
+        
+        return 1;
+    }
+    
+    /* a redrawing peer doesn't starve a full frame */
+    ssd1306_emulator_test_clear(&gs_emulator[0]);
+    ssd1306_emulator_test_clear(&gs_emulator[1]);
+    (void)ssd1306_bus_clear_stats(&gs_bus);
+    res = ssd1306_gram_fill_rect(&gs_handle[1], 0, 0, 127, 63, 1);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: gram fill rect failed.\n");
+        (void)ssd1306_deinit(&gs_handle[0]);
+        (void)ssd1306_deinit(&gs_handle[1]);
+        
+        return 1;
+    }
+    for (turns = 0; turns < 64; turns++)
+    {
+        if (gs_handle[0].job.active == 0)
+        {
+            /* redraw between the peer's jobs */
+            res = ssd1306_gram_fill_rect(&gs_handle[0], 10, 10, 40, 20, (uint8_t)(turns % 2));
+        }
+        else
+        {
+            res = 0;
+        }
+        if (res != 0)
+        {
+            ssd1306_interface_debug_print("ssd1306: gram fill rect failed.\n");
+            (void)ssd1306_deinit(&gs_handle[0]);
+            (void)ssd1306_deinit(&gs_handle[1]);
+            
+            return 1;
+        }
+        res = ssd1306_bus_flush_step(&gs_bus, &status);
+        if (res != 0)
+        {
+            ssd1306_interface_debug_print("ssd1306: bus flush step failed.\n");
+            (void)ssd1306_deinit(&gs_handle[0]);
+            (void)ssd1306_deinit(&gs_handle[1]);
+            
+            return 1;
+        }
+        if ((gs_handle[1].dirty_page == 0) && (gs_handle[1].job.active == 0))
+        {
+            break;
+        }
+    }
+    (void)ssd1306_bus_get_stats(&gs_bus, &stats);
+    ssd1306_interface_debug_print("ssd1306: full frame converged in %d turns, %d and %d turns served.\n",
+                                  turns + 1, stats.turns[0], stats.turns[1]);
+    if ((turns == 64) || (ssd1306_emulator_test_compare(&gs_emulator[1], gs_handle[1].gram) != 0))
+    {
+        ssd1306_interface_debug_print("ssd1306: full frame starved.\n");
+        (void)ssd1306_deinit(&gs_handle[0]);
+        (void)ssd1306_deinit(&gs_handle[1]);
+        
+        return 1;
+    }
+    if ((stats.turns[0] + 1 < stats.turns[1]) || (stats.turns[1] + 1 < stats.turns[0]))
+    {
+        ssd1306_interface_debug_print("ssd1306: turns are not shared.\n");
+        (void)ssd1306_deinit(&gs_handle[0]);
+        (void)ssd1306_deinit(&gs_handle[1]);
+        
+        return 1;
+    }
+    
+    /* both panels converge once the drawing stops */
+    for (turns = 0; turns < 64; turns++)
+    {
+        res = ssd1306_bus_flush_step(&gs_bus, &status);
+        if (res != 0)
+        {
+            ssd1306_interface_debug_print("ssd1306: bus flush step failed.\n");
+            (void)ssd1306_deinit(&gs_handle[0]);
+            (void)ssd1306_deinit(&gs_handle[1]);
+            
+            return 1;
+        }
+        if (status == SSD1306_FLUSH_STATUS_DONE)
+        {
+            break;
+        }
+    }
+    for (i = 0; i < 2; i++)
+    {
+        if ((status != SSD1306_FLUSH_STATUS_DONE) ||
+            (ssd1306_emulator_test_compare(&gs_emulator[i], gs_handle[i].gram) != 0))
+        {
+            ssd1306_interface_debug_print("ssd1306: panel %d didn't converge.\n", i);
+            (void)ssd1306_deinit(&gs_handle[0]);
+            (void)ssd1306_deinit(&gs_handle[1]);
+            
+            return 1;
+        }
+    }
+    
+    /* the stats match the bus */
+    (void)ssd1306_bus_get_stats(&gs_bus, &stats);
+    bytes = gs_emulator[0].bytes + gs_emulator[1].bytes;
+    transactions = gs_emulator[0].transactions + gs_emulator[1].transactions;
+    cost = 8 * (transactions + bytes + gs_emulator[0].dc_toggles + gs_emulator[1].dc_toggles);
+    ssd1306_interface_debug_print("ssd1306: bus sent %d bytes in %d transactions, estimated cost %d.\n",
+                                  stats.bytes, stats.transactions, stats.estimated_cost);
+    if ((stats.bytes != bytes) || (stats.transactions != transactions) || (stats.estimated_cost != cost))
+    {
+        ssd1306_interface_debug_print("ssd1306: bus stats don't match the bus.\n");
+        (void)ssd1306_deinit(&gs_handle[0]);
+        (void)ssd1306_deinit(&gs_handle[1]);
+        
+        return 1;
+    }
+    res = ssd1306_bus_clear_stats(&gs_bus);
+    (void)ssd1306_bus_get_stats(&gs_bus, &stats);
+    if ((res != 0) || (stats.bytes != 0) || (stats.transactions != 0) || (stats.estimated_cost != 0))
+    {
+        ssd1306_interface_debug_print("ssd1306: bus stats are not cleared.\n");
+        (void)ssd1306_deinit(&gs_handle[0]);
+        (void)ssd1306_deinit(&gs_handle[1]);
+        
+        return 1;
+    }
+    
+    /* finish bus test */
+    ssd1306_interface_debug_print("ssd1306: finish bus test.\n");
+    (void)ssd1306_deinit(&gs_handle[0]);
+    (void)ssd1306_deinit(&gs_handle[1]);
+    
+    return 0;
+}
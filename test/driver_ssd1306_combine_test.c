@@ -0,0 +1,270 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_ssd1306_combine_test.c
+ * @brief     driver ssd1306 write combine test source file
+ * @version   2.0.0
+ * @author    Shifeng Li
+ * @date      2021-03-30
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2021/03/30  <td>2.0      <td>Shifeng Li  <td>format the code
+ * <tr><td>2020/12/10  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_ssd1306_combine_test.h"
+#include <stdlib.h>
+
+static ssd1306_handle_t gs_handle;          /**< ssd1306 handle */
+static ssd1306_emulator_t gs_emulator;      /**< ssd1306 emulator */
+
+/**
+ * @brief     plot a horizontal line point by point
+ * @param[in] y coordinate y
+ * @param[in] color line color
+ * @return    status code
+ *            - 0 success
+ *            - 1 plot failed
+ * @note      the pending span is sent at the end
+ */
+static uint8_t a_combine_test_line(uint8_t y, uint8_t color)
+{
+    uint8_t x;
+    
+    for (x = 0; x < 128; x++)
+    {
+        if (ssd1306_write_point(&gs_handle, x, y, color) != 0)
+        {
+            ssd1306_interface_debug_print("ssd1306: write point failed.\n");
+            
+            return 1;
+        }
+    }
+    if (ssd1306_flush_pending(&gs_handle) != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: flush pending failed.\n");
+        
+        return 1;
+    }
+    if (ssd1306_emulator_test_compare(&gs_emulator, gs_handle.gram) != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: line is not on the panel.\n");
+        
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     write combine test
+ * @param[in] interface interface type
+ * @return    status code
+ *            - 0 success
+ *            - 1 test failed
+ * @note      the panel is emulated, no hardware is needed
+ */
+uint8_t ssd1306_combine_test(ssd1306_interface_t interface)
+{
+    uint8_t res;
+    uint16_t i;
+    uint32_t plain_transactions;
+    uint32_t combine_transactions;
+    
+    /* link the emulator */
+    ssd1306_emulator_test_link(&gs_handle, &gs_emulator);
+    
+    /* start combine test */
+    ssd1306_interface_debug_print("ssd1306: start combine test.\n");
+    
+    /* set interface */
+    res = ssd1306_set_interface(&gs_handle, interface);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: set interface failed.\n");
+        
+        return 1;
+    }
+    
+    /* set addr pin */
+    res = ssd1306_set_addr_pin(&gs_handle, SSD1306_ADDR_SA0_0);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: set addr failed.\n");
+        
+        return 1;
+    }
+    
+    /* ssd1306 init */
+    res = ssd1306_init(&gs_handle);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: init failed.\n");
+        
+        return 1;
+    }
+    
+    /* a line without write combine */
+    ssd1306_emulator_test_clear(&gs_emulator);
+    if (a_combine_test_line(20, 1) != 0)
+    {
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    plain_transactions = gs_emulator.transactions;
+    
+    /* the same line with write combine */
+    res = ssd1306_set_write_combine(&gs_handle, SSD1306_WRITE_COMBINE_ENABLE);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: set write combine failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    ssd1306_emulator_test_clear(&gs_emulator);
+    if (a_combine_test_line(28, 1) != 0)
+    {
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    combine_transactions = gs_emulator.transactions;
+    ssd1306_interface_debug_print("ssd1306: a 128 point line sent %d transactions plain, %d combined.\n",
+                                  plain_transactions, combine_transactions);
+    if ((plain_transactions < 128) || (combine_transactions > 2))
+    {
+        ssd1306_interface_debug_print("ssd1306: write combine didn't cut the transactions.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* a point across a cheap gap joins the span */
+    ssd1306_emulator_test_clear(&gs_emulator);
+    if ((ssd1306_write_point(&gs_handle, 20, 40, 1) != 0) ||
+        (ssd1306_write_point(&gs_handle, 24, 41, 1) != 0) ||
+        (ssd1306_write_point(&gs_handle, 18, 42, 1) != 0))
+    {
+        ssd1306_interface_debug_print("ssd1306: write point failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    if ((gs_emulator.transactions != 0) || (gs_handle.pending_start != 18) || (gs_handle.pending_len != 7))
+    {
+        ssd1306_interface_debug_print("ssd1306: gap points are not merged.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* a far point sends the span */
+    if (ssd1306_write_point(&gs_handle, 100, 43, 1) != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: write point failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    if ((gs_emulator.transactions == 0) || (gs_emulator.ram[5][24] != gs_handle.gram[24][5]) ||
+        (gs_handle.pending_start != 100) || (gs_handle.pending_len != 1))
+    {
+        ssd1306_interface_debug_print("ssd1306: far point didn't send the span.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* a point on another page sends the span */
+    ssd1306_emulator_test_clear(&gs_emulator);
+    if (ssd1306_write_point(&gs_handle, 100, 60, 1) != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: write point failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    if ((gs_emulator.transactions == 0) || (gs_emulator.ram[5][100] != gs_handle.gram[100][5]) ||
+        (gs_handle.pending_page != 7))
+    {
+        ssd1306_interface_debug_print("ssd1306: page change didn't send the span.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    if ((ssd1306_flush_pending(&gs_handle) != 0) ||
+        (ssd1306_emulator_test_compare(&gs_emulator, gs_handle.gram) != 0))
+    {
+        ssd1306_interface_debug_print("ssd1306: combined points are not on the panel.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* random points */
+    srand(7);
+    for (i = 0; i < 2000; i++)
+    {
+        res = ssd1306_write_point(&gs_handle, (uint8_t)(rand() % 128), (uint8_t)(rand() % 64), (uint8_t)(rand() % 2));
+        if (res != 0)
+        {
+            ssd1306_interface_debug_print("ssd1306: write point failed.\n");
+            (void)ssd1306_deinit(&gs_handle);
+            
+            return 1;
+        }
+        if (((i % 100) == 99) && (ssd1306_flush_pending(&gs_handle) != 0))
+        {
+            ssd1306_interface_debug_print("ssd1306: flush pending failed.\n");
+            (void)ssd1306_deinit(&gs_handle);
+            
+            return 1;
+        }
+    }
+    res = ssd1306_set_write_combine(&gs_handle, SSD1306_WRITE_COMBINE_DISABLE);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: set write combine failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    if (ssd1306_emulator_test_compare(&gs_emulator, gs_handle.gram) != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: random points are not on the panel.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* finish combine test */
+    ssd1306_interface_debug_print("ssd1306: finish combine test.\n");
+    (void)ssd1306_deinit(&gs_handle);
+    
+    return 0;
+}
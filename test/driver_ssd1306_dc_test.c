@@ -0,0 +1,199 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_ssd1306_dc_test.c
+ * @brief     driver ssd1306 dc test source file
+ * @version   2.0.0
+ * @author    Shifeng Li
+ * @date      2021-03-30
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2021/03/30  <td>2.0      <td>Shifeng Li  <td>format the code
+ * <tr><td>2020/12/10  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_ssd1306_dc_test.h"
+
+static ssd1306_handle_t gs_handle;          /**< ssd1306 handle */
+static ssd1306_emulator_t gs_emulator;      /**< ssd1306 emulator */
+
+/**
+ * @brief     check the data command line toggles
+ * @param[in] *name pointer to the update name
+ * @param[in] max_toggles max allowed toggles
+ * @return    status code
+ *            - 0 success
+ *            - 1 check failed
+ * @note      the driver count must match the toggles seen on the line
+ */
+static uint8_t a_dc_test_check(const char *name, uint32_t max_toggles)
+{
+    uint8_t res;
+    uint32_t count;
+    
+    res = ssd1306_get_dc_toggle_count(&gs_handle, &count);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: get dc toggle count failed.\n");
+        
+        return 1;
+    }
+    ssd1306_interface_debug_print("ssd1306: %s toggled the data command line %d times.\n", name, gs_emulator.dc_toggles);
+    if (count != gs_emulator.dc_toggles)
+    {
+        ssd1306_interface_debug_print("ssd1306: %s counted %d toggles.\n", name, count);
+        
+        return 1;
+    }
+    if (gs_emulator.dc_toggles > max_toggles)
+    {
+        ssd1306_interface_debug_print("ssd1306: %s toggled more than %d times.\n", name, max_toggles);
+        
+        return 1;
+    }
+    if (ssd1306_emulator_test_compare(&gs_emulator, gs_handle.gram) != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: %s is not on the panel.\n", name);
+        
+        return 1;
+    }
+    (void)ssd1306_clear_dc_toggle_count(&gs_handle);
+    ssd1306_emulator_test_clear(&gs_emulator);
+    
+    return 0;
+}
+
+/**
+ * @brief  spi data command line test
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   the panel is emulated, no hardware is needed
+ */
+uint8_t ssd1306_dc_test(void)
+{
+    uint8_t res;
+    uint8_t i;
+    
+    /* link the emulator */
+    ssd1306_emulator_test_link(&gs_handle, &gs_emulator);
+    
+    /* start dc test */
+    ssd1306_interface_debug_print("ssd1306: start dc test.\n");
+    
+    /* set interface */
+    res = ssd1306_set_interface(&gs_handle, SSD1306_INTERFACE_SPI);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: set interface failed.\n");
+        
+        return 1;
+    }
+    
+    /* ssd1306 init */
+    res = ssd1306_init(&gs_handle);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: init failed.\n");
+        
+        return 1;
+    }
+    (void)ssd1306_clear_dc_toggle_count(&gs_handle);
+    ssd1306_emulator_test_clear(&gs_emulator);
+    
+    /* repeated commands keep the line low */
+    for (i = 0; i < 8; i++)
+    {
+        res = ssd1306_set_contrast(&gs_handle, (uint8_t)(i * 16));
+        if (res != 0)
+        {
+            ssd1306_interface_debug_print("ssd1306: set contrast failed.\n");
+            (void)ssd1306_deinit(&gs_handle);
+            
+            return 1;
+        }
+    }
+    if (a_dc_test_check("set contrast", 1) != 0)
+    {
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* one command phase and one data phase for each page at most */
+    res = ssd1306_gram_fill_rect(&gs_handle, 0, 0, 127, 63, 1);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: gram fill rect failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    res = ssd1306_gram_update(&gs_handle);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: gram update failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    if (a_dc_test_check("gram update", 16) != 0)
+    {
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* the frame burst switches to data once */
+    res = ssd1306_gram_fill_rect(&gs_handle, 10, 10, 60, 50, 0);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: gram fill rect failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    res = ssd1306_gram_update_frame(&gs_handle);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: gram update frame failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    if (a_dc_test_check("gram update frame", 2) != 0)
+    {
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* finish dc test */
+    ssd1306_interface_debug_print("ssd1306: finish dc test.\n");
+    (void)ssd1306_deinit(&gs_handle);
+    
+    return 0;
+}
@@ -0,0 +1,296 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_ssd1306_diff_test.c
+ * @brief     driver ssd1306 diff test source file
+ * @version   2.0.0
+ * @author    Shifeng Li
+ * @date      2021-03-30
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2021/03/30  <td>2.0      <td>Shifeng Li  <td>format the code
+ * <tr><td>2020/12/10  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_ssd1306_diff_test.h"
+
+static ssd1306_handle_t gs_handle;          /**< ssd1306 handle */
+static ssd1306_emulator_t gs_emulator;      /**< ssd1306 emulator */
+
+/**
+ * @brief     diff test
+ * @param[in] interface interface type
+ * @return    status code
+ *            - 0 success
+ *            - 1 test failed
+ *            - 2 test not run
+ * @note      the panel is emulated, no hardware is needed, it needs SSD1306_SHADOW_ENABLE
+ */
+uint8_t ssd1306_diff_test(ssd1306_interface_t interface)
+{
+    uint8_t res;
+    uint8_t i;
+    uint8_t j;
+    uint8_t x;
+    uint32_t full_bytes;
+    uint32_t diff_bytes;
+    char test_str[] = "libdriver";
+    
+    /* link the emulator */
+    ssd1306_emulator_test_link(&gs_handle, &gs_emulator);
+    
+    /* start diff test */
+    ssd1306_interface_debug_print("ssd1306: start diff test.\n");
+    
+#if (SSD1306_SHADOW_ENABLE == 0)
+    /* the diff needs the shadow */
+    (void)res;
+    (void)i;
+    (void)j;
+    (void)x;
+    (void)full_bytes;
+    (void)diff_bytes;
+    (void)test_str;
+    (void)interface;
+    ssd1306_interface_debug_print("ssd1306: shadow is disabled, diff test not run.\n");
+    
+    return 2;
+#else
+    /* set interface */
+    res = ssd1306_set_interface(&gs_handle, interface);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: set interface failed.\n");
+        
+        return 1;
+    }
+    
+    /* set addr pin */
+    res = ssd1306_set_addr_pin(&gs_handle, SSD1306_ADDR_SA0_0);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: set addr failed.\n");
+        
+        return 1;
+    }
+    
+    /* ssd1306 init */
+    res = ssd1306_init(&gs_handle);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: init failed.\n");
+        
+        return 1;
+    }
+    
+    /* the first diff sends the whole frame */
+    for (i = 0; i < 128; i++)
+    {
+        for (j = 0; j < 8; j++)
+        {
+            gs_handle.gram[i][j] = (uint8_t)(i ^ (j << 4));
+        }
+    }
+    res = ssd1306_gram_update_diff(&gs_handle);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: gram update diff failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    if (ssd1306_emulator_test_compare(&gs_emulator, gs_handle.gram) != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: first diff is not on the panel.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* a full update of a frame with a few changed bytes */
+    gs_handle.gram[3][0] ^= 0xFF;
+    gs_handle.gram[64][4] ^= 0xFF;
+    gs_handle.gram[65][4] ^= 0xFF;
+    gs_handle.gram[127][7] ^= 0xFF;
+    ssd1306_emulator_test_clear(&gs_emulator);
+    res = ssd1306_gram_update(&gs_handle);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: gram update failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    full_bytes = gs_emulator.bytes;
+    
+    /* the same change sent as a diff */
+    gs_handle.gram[3][0] ^= 0xFF;
+    gs_handle.gram[64][4] ^= 0xFF;
+    gs_handle.gram[65][4] ^= 0xFF;
+    gs_handle.gram[127][7] ^= 0xFF;
+    ssd1306_emulator_test_clear(&gs_emulator);
+    res = ssd1306_gram_update_diff(&gs_handle);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: gram update diff failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    diff_bytes = gs_emulator.bytes;
+    ssd1306_interface_debug_print("ssd1306: full update sent %d bytes, diff update sent %d bytes.\n",
+                                  full_bytes, diff_bytes);
+    if (ssd1306_emulator_test_compare(&gs_emulator, gs_handle.gram) != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: diff is not on the panel.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    if ((diff_bytes * 8) > full_bytes)
+    {
+        ssd1306_interface_debug_print("ssd1306: diff update sent too many bytes.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* an unchanged frame sends nothing */
+    ssd1306_emulator_test_clear(&gs_emulator);
+    res = ssd1306_gram_update_diff(&gs_handle);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: gram update diff failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    if (gs_emulator.bytes != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: unchanged frame sent %d bytes.\n", gs_emulator.bytes);
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* repainting the same text sends nothing */
+    res = ssd1306_gram_write_string(&gs_handle, 0, 0, test_str, 9, 1, SSD1306_FONT_16);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: gram write string failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    res = ssd1306_gram_update_diff(&gs_handle);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: gram update diff failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    for (i = 0; i < 4; i++)
+    {
+        res = ssd1306_gram_write_string(&gs_handle, 0, 0, test_str, 9, 1, SSD1306_FONT_16);
+        if (res != 0)
+        {
+            ssd1306_interface_debug_print("ssd1306: gram write string failed.\n");
+            (void)ssd1306_deinit(&gs_handle);
+            
+            return 1;
+        }
+        ssd1306_emulator_test_clear(&gs_emulator);
+        res = ssd1306_gram_update_diff(&gs_handle);
+        if (res != 0)
+        {
+            ssd1306_interface_debug_print("ssd1306: gram update diff failed.\n");
+            (void)ssd1306_deinit(&gs_handle);
+            
+            return 1;
+        }
+        if (gs_emulator.bytes != 0)
+        {
+            ssd1306_interface_debug_print("ssd1306: repainted text sent %d bytes.\n", gs_emulator.bytes);
+            (void)ssd1306_deinit(&gs_handle);
+            
+            return 1;
+        }
+    }
+    ssd1306_interface_debug_print("ssd1306: repainted text sent 0 bytes.\n");
+    
+    /* a moving cursor sends only the columns it leaves and enters */
+    for (x = 0; x < 120; x = (uint8_t)(x + 6))
+    {
+        res = ssd1306_gram_fill_rect(&gs_handle, x, 40, (uint8_t)(x + 5), 51, 0);
+        if (res != 0)
+        {
+            ssd1306_interface_debug_print("ssd1306: gram fill rect failed.\n");
+            (void)ssd1306_deinit(&gs_handle);
+            
+            return 1;
+        }
+        res = ssd1306_gram_fill_rect(&gs_handle, (uint8_t)(x + 6), 40, (uint8_t)(x + 11), 51, 1);
+        if (res != 0)
+        {
+            ssd1306_interface_debug_print("ssd1306: gram fill rect failed.\n");
+            (void)ssd1306_deinit(&gs_handle);
+            
+            return 1;
+        }
+        ssd1306_emulator_test_clear(&gs_emulator);
+        res = ssd1306_gram_update_diff(&gs_handle);
+        if (res != 0)
+        {
+            ssd1306_interface_debug_print("ssd1306: gram update diff failed.\n");
+            (void)ssd1306_deinit(&gs_handle);
+            
+            return 1;
+        }
+        if (ssd1306_emulator_test_compare(&gs_emulator, gs_handle.gram) != 0)
+        {
+            ssd1306_interface_debug_print("ssd1306: moved cursor is not on the panel.\n");
+            (void)ssd1306_deinit(&gs_handle);
+            
+            return 1;
+        }
+        if (gs_emulator.bytes > 48)
+        {
+            ssd1306_interface_debug_print("ssd1306: moved cursor sent %d bytes.\n", gs_emulator.bytes);
+            (void)ssd1306_deinit(&gs_handle);
+            
+            return 1;
+        }
+    }
+    ssd1306_interface_debug_print("ssd1306: moved cursor sent %d bytes a step.\n", gs_emulator.bytes);
+    
+    /* finish diff test */
+    ssd1306_interface_debug_print("ssd1306: finish diff test.\n");
+    (void)ssd1306_deinit(&gs_handle);
+    
+    return 0;
+#endif
+}
@@ -579,6 +579,9 @@ uint8_t ssd1306_display_test(ssd1306_interface_t interface, ssd1306_address_t ad
     DRIVER_SSD1306_LINK_IIC_INIT(&gs_handle, ssd1306_interface_iic_init);
     DRIVER_SSD1306_LINK_IIC_DEINIT(&gs_handle, ssd1306_interface_iic_deinit);
     DRIVER_SSD1306_LINK_IIC_WRITE(&gs_handle, ssd1306_interface_iic_write);
+    DRIVER_SSD1306_LINK_IIC_WRITE_COMMAND(&gs_handle, ssd1306_interface_iic_write_cmd);
+    DRIVER_SSD1306_LINK_TRANSFER_BEGIN(&gs_handle, ssd1306_interface_transfer_begin);
+    DRIVER_SSD1306_LINK_TRANSFER_END(&gs_handle, ssd1306_interface_transfer_end);
     DRIVER_SSD1306_LINK_SPI_INIT(&gs_handle, ssd1306_interface_spi_init);
     DRIVER_SSD1306_LINK_SPI_DEINIT(&gs_handle, ssd1306_interface_spi_deinit);
     DRIVER_SSD1306_LINK_SPI_WRITE_COMMAND(&gs_handle, ssd1306_interface_spi_write_cmd);
@@ -0,0 +1,571 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_ssd1306_emulator_test.c
+ * @brief     driver ssd1306 emulator test source file
+ * @version   2.0.0
+ * @author    Shifeng Li
+ * @date      2021-03-30
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2021/03/30  <td>2.0      <td>Shifeng Li  <td>format the code
+ * <tr><td>2020/12/10  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_ssd1306_emulator_test.h"
+
+/**
+ * @brief     get the argument count of a command
+ * @param[in] cmd command
+ * @return    argument count
+ * @note      none
+ */
+static uint8_t a_emulator_args(uint8_t cmd)
+{
+    if ((cmd == 0x26) || (cmd == 0x27))                                          /* horizontal scroll */
+    {
+        return 6;                                                                /* return 6 */
+    }
+    else if ((cmd == 0x29) || (cmd == 0x2A))                                     /* vertical and horizontal scroll */
+    {
+        return 5;                                                                /* return 5 */
+    }
+    else if ((cmd == 0x21) || (cmd == 0x22) || (cmd == 0xA3))                    /* address range and scroll area */
+    {
+        return 2;                                                                /* return 2 */
+    }
+    else if ((cmd == 0x20) || (cmd == 0x23) || (cmd == 0x81) || (cmd == 0x8D) ||
+             (cmd == 0xA8) || (cmd == 0xD3) || (cmd == 0xD5) || (cmd == 0xD6) ||
+             (cmd == 0xD9) || (cmd == 0xDA) || (cmd == 0xDB))                    /* one argument commands */
+    {
+        return 1;                                                                /* return 1 */
+    }
+    else
+    {
+        return 0;                                                                /* return 0 */
+    }
+}
+
+/**
+ * @brief     run a command with its arguments
+ * @param[in] *emulator pointer to an ssd1306 emulator structure
+ * @param[in] cmd command
+ * @param[in] *args pointer to the arguments
+ * @note      only the addressing commands change the emulator state
+ */
+static void a_emulator_run(ssd1306_emulator_t *emulator, uint8_t cmd, uint8_t *args)
+{
+    if (cmd <= 0x0F)                                                             /* low column start address */
+    {
+        emulator->column = (uint8_t)((emulator->column & 0xF0) | cmd);           /* set the low nibble */
+    }
+    else if (cmd <= 0x1F)                                                        /* high column start address */
+    {
+        emulator->column = (uint8_t)((emulator->column & 0x0F) |
+                                     ((cmd & 0x07) << 4));                       /* set the high nibble */
+    }
+    else if (cmd == 0x20)                                                        /* memory addressing mode */
+    {
+        emulator->mode = args[0] & 0x03;                                         /* set the mode */
+    }
+    else if (cmd == 0x21)                                                        /* column address range */
+    {
+        emulator->column_start = args[0] & 0x7F;                                 /* set the start */
+        emulator->column_end = args[1] & 0x7F;                                   /* set the end */
+        emulator->column = emulator->column_start;                               /* reset the column */
+    }
+    else if (cmd == 0x22)                                                        /* page address range */
+    {
+        emulator->page_start = args[0] & 0x07;                                   /* set the start */
+        emulator->page_end = args[1] & 0x07;                                     /* set the end */
+        emulator->page = emulator->page_start;                                   /* reset the page */
+    }
+    else if ((cmd >= 0xB0) && (cmd <= 0xB7))                                     /* page start address */
+    {
+        emulator->page = cmd & 0x07;                                             /* set the page */
+    }
+    else
+    {
+        /* the other commands don't move the ram pointer */
+    }
+}
+
+/**
+ * @brief     feed a command byte
+ * @param[in] *emulator pointer to an ssd1306 emulator structure
+ * @param[in] data command byte
+ * @note      none
+ */
+static void a_emulator_cmd(ssd1306_emulator_t *emulator, uint8_t data)
+{
+    if (emulator->log_len < SSD1306_EMULATOR_LOG_LEN)                            /* check the log */
+    {
+        emulator->log[emulator->log_len] = data;                                 /* log the byte */
+        emulator->log_len++;                                                     /* log_len++ */
+    }
+    if (emulator->args_need == 0)                                                /* a new command */
+    {
+        emulator->args_need = a_emulator_args(data);                             /* get the argument count */
+        if (emulator->args_need == 0)                                            /* no argument */
+        {
+            a_emulator_run(emulator, data, emulator->args);                      /* run it */
+        }
+        else
+        {
+            emulator->cmd = data;                                                /* save the command */
+            emulator->args_len = 0;                                              /* no argument yet */
+        }
+    }
+    else
+    {
+        emulator->args[emulator->args_len] = data;                               /* save the argument */
+        emulator->args_len++;                                                    /* args_len++ */
+        if (emulator->args_len == emulator->args_need)                           /* if complete */
+        {
+            emulator->args_need = 0;                                             /* clear the need */
+            a_emulator_run(emulator, emulator->cmd, emulator->args);             /* run it */
+        }
+    }
+}
+
+/**
+ * @brief     feed a data byte
+ * @param[in] *emulator pointer to an ssd1306 emulator structure
+ * @param[in] data data byte
+ * @note      the pointer moves as the panel ram pointer does in each addressing mode
+ */
+static void a_emulator_data(ssd1306_emulator_t *emulator, uint8_t data)
+{
+    emulator->ram[emulator->page][emulator->column] = data;                      /* write the ram */
+    if (emulator->mode == 0)                                                     /* horizontal mode */
+    {
+        if (emulator->column >= emulator->column_end)                            /* end of the row */
+        {
+            emulator->column = emulator->column_start;                           /* wrap the column */
+            emulator->page = (emulator->page >= emulator->page_end) ?
+                              emulator->page_start : (uint8_t)(emulator->page + 1);  /* next page */
+        }
+        else
+        {
+            emulator->column++;                                                  /* next column */
+        }
+    }
+    else if (emulator->mode == 1)                                                /* vertical mode */
+    {
+        if (emulator->page >= emulator->page_end)                                /* end of the column */
+        {
+            emulator->page = emulator->page_start;                               /* wrap the page */
+            emulator->column = (emulator->column >= emulator->column_end) ?
+                                emulator->column_start : (uint8_t)(emulator->column + 1);  /* next column */
+        }
+        else
+        {
+            emulator->page++;                                                    /* next page */
+        }
+    }
+    else                                                                         /* page mode */
+    {
+        emulator->column = (uint8_t)((emulator->column + 1) & 0x7F);             /* next column */
+    }
+}
+
+/**
+ * @brief     feed an iic frame
+ * @param[in] *emulator pointer to an ssd1306 emulator structure
+ * @param[in] ctrl first control byte
+ * @param[in] *buf pointer to the bytes after the control byte
+ * @param[in] len buf length
+ * @note      a control byte with the continuation bit carries one byte and
+ *            is followed by another control byte
+ */
+static void a_emulator_iic(ssd1306_emulator_t *emulator, uint8_t ctrl, uint8_t *buf, uint16_t len)
+{
+    uint16_t i;
+
+    emulator->transactions++;                                                    /* add one transaction */
+    emulator->bytes += (uint32_t)len + 2;                                        /* address, control and payload */
+    i = 0;                                                                       /* init i */
+    while (i < len)                                                              /* feed all bytes */
+    {
+        if ((ctrl & 0x40) != 0)                                                  /* data */
+        {
+            a_emulator_data(emulator, buf[i]);                                   /* feed data */
+        }
+        else
+        {
+            a_emulator_cmd(emulator, buf[i]);                                    /* feed command */
+        }
+        i++;                                                                     /* i++ */
+        if (((ctrl & 0x80) != 0) && (i < len))                                   /* if continued */
+        {
+            ctrl = buf[i];                                                       /* next control byte */
+            i++;                                                                 /* i++ */
+        }
+    }
+}
+
+/**
+ * @brief  emulator bus init
+ * @return status code
+ *         - 0 success
+ * @note   none
+ */
+static uint8_t a_emulator_init(void)
+{
+    return 0;
+}
+
+/**
+ * @brief  emulator bus deinit
+ * @return status code
+ *         - 0 success
+ * @note   none
+ */
+static uint8_t a_emulator_deinit(void)
+{
+    return 0;
+}
+
+/**
+ * @brief     emulator delay
+ * @param[in] ms time
+ * @note      none
+ */
+static void a_emulator_delay_ms(uint32_t ms)
+{
+    (void)ms;
+}
+
+/**
+ * @brief     emulator iic bus write
+ * @param[in] *ctx pointer to the emulator
+ * @param[in] addr iic device write address
+ * @param[in] reg control byte
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+static uint8_t a_emulator_iic_write(void *ctx, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    ssd1306_emulator_t *emulator = (ssd1306_emulator_t *)ctx;
+
+    (void)addr;
+    if (emulator->fail != 0)                                                     /* check the fail flag */
+    {
+        return 1;                                                                /* return error */
+    }
+    a_emulator_iic(emulator, reg, buf, len);                                     /* feed the frame */
+
+    return 0;                                                                    /* success return 0 */
+}
+
+/**
+ * @brief     emulator iic bus write with the control byte in the buffer
+ * @param[in] *ctx pointer to the emulator
+ * @param[in] addr iic device write address
+ * @param[in] *buf pointer to a frame buffer
+ * @param[in] len length of the frame buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+static uint8_t a_emulator_iic_write_cmd(void *ctx, uint8_t addr, uint8_t *buf, uint16_t len)
+{
+    ssd1306_emulator_t *emulator = (ssd1306_emulator_t *)ctx;
+
+    (void)addr;
+    if ((emulator->fail != 0) || (len == 0))                                     /* check the fail flag */
+    {
+        return 1;                                                                /* return error */
+    }
+    a_emulator_iic(emulator, buf[0], buf + 1, (uint16_t)(len - 1));              /* feed the frame */
+
+    return 0;                                                                    /* success return 0 */
+}
+
+/**
+ * @brief     emulator spi bus write
+ * @param[in] *ctx pointer to the emulator
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the bytes are commands or data by the data command line level
+ */
+static uint8_t a_emulator_spi_write_cmd(void *ctx, uint8_t *buf, uint16_t len)
+{
+    uint16_t i;
+    ssd1306_emulator_t *emulator = (ssd1306_emulator_t *)ctx;
+
+    if (emulator->fail != 0)                                                     /* check the fail flag */
+    {
+        return 1;                                                                /* return error */
+    }
+    emulator->transactions++;                                                    /* add one transaction */
+    emulator->bytes += len;                                                      /* add the bytes */
+    for (i = 0; i < len; i++)                                                    /* feed all bytes */
+    {
+        if (emulator->dc != 0)                                                   /* data */
+        {
+            a_emulator_data(emulator, buf[i]);                                   /* feed data */
+        }
+        else
+        {
+            a_emulator_cmd(emulator, buf[i]);                                    /* feed command */
+        }
+    }
+
+    return 0;                                                                    /* success return 0 */
+}
+
+/**
+ * @brief     emulator data command gpio write
+ * @param[in] *ctx pointer to the emulator
+ * @param[in] value written value
+ * @return    status code
+ *            - 0 success
+ * @note      none
+ */
+static uint8_t a_emulator_dc_write(void *ctx, uint8_t value)
+{
+    ssd1306_emulator_t *emulator = (ssd1306_emulator_t *)ctx;
+
+    if (emulator->dc != value)                                                   /* if the level changes */
+    {
+        emulator->dc_toggles++;                                                  /* add one toggle */
+    }
+    emulator->dc = value;                                                        /* set the level */
+
+    return 0;                                                                    /* success return 0 */
+}
+
+/**
+ * @brief     emulator reset gpio write
+ * @param[in] *ctx pointer to the emulator
+ * @param[in] value written value
+ * @return    status code
+ *            - 0 success
+ * @note      a low level resets the addressing state
+ */
+static uint8_t a_emulator_reset_write(void *ctx, uint8_t value)
+{
+    ssd1306_emulator_t *emulator = (ssd1306_emulator_t *)ctx;
+
+    if (value == 0)                                                              /* if reset */
+    {
+        emulator->mode = 2;                                                      /* page mode */
+        emulator->page = 0;                                                      /* page 0 */
+        emulator->column = 0;                                                    /* column 0 */
+        emulator->column_start = 0;                                              /* column start 0 */
+        emulator->column_end = 127;                                              /* column end 127 */
+        emulator->page_start = 0;                                                /* page start 0 */
+        emulator->page_end = 7;                                                  /* page end 7 */
+        emulator->args_need = 0;                                                 /* no pending command */
+    }
+
+    return 0;                                                                    /* success return 0 */
+}
+
+/**
+ * @brief     emulator asynchronous iic bus write
+ * @param[in] *ctx pointer to the emulator
+ * @param[in] addr iic device write address
+ * @param[in] reg control byte
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the frame is copied and held until it is completed
+ */
+static uint8_t a_emulator_iic_write_async(void *ctx, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    ssd1306_emulator_t *emulator = (ssd1306_emulator_t *)ctx;
+
+    (void)addr;
+    if ((emulator->fail != 0) || (emulator->async_pending != 0) ||
+        (len > SSD1306_EMULATOR_ASYNC_LEN))                                      /* check the write in flight */
+    {
+        return 1;                                                                /* return error */
+    }
+    memcpy(emulator->async_buf, buf, len);                                       /* copy the frame */
+    emulator->async_len = len;                                                   /* set the length */
+    emulator->async_reg = reg;                                                   /* set the control byte */
+    emulator->async_iic = 1;                                                     /* iic write */
+    emulator->async_pending = 1;                                                 /* set in flight */
+    emulator->async_starts++;                                                    /* add one start */
+
+    return 0;                                                                    /* success return 0 */
+}
+
+/**
+ * @brief     emulator asynchronous spi bus write
+ * @param[in] *ctx pointer to the emulator
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the bytes are copied and held until they are completed
+ */
+static uint8_t a_emulator_spi_write_cmd_async(void *ctx, uint8_t *buf, uint16_t len)
+{
+    ssd1306_emulator_t *emulator = (ssd1306_emulator_t *)ctx;
+
+    if ((emulator->fail != 0) || (emulator->async_pending != 0) ||
+        (len > SSD1306_EMULATOR_ASYNC_LEN))                                      /* check the write in flight */
+    {
+        return 1;                                                                /* return error */
+    }
+    memcpy(emulator->async_buf, buf, len);                                       /* copy the bytes */
+    emulator->async_len = len;                                                   /* set the length */
+    emulator->async_iic = 0;                                                     /* spi write */
+    emulator->async_pending = 1;                                                 /* set in flight */
+    emulator->async_starts++;                                                    /* add one start */
+
+    return 0;                                                                    /* success return 0 */
+}
+
+/**
+ * @brief     link the emulator to a handle
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] *emulator pointer to an ssd1306 emulator structure
+ * @note      the handle is cleared and linked to the emulator, the panel ram is cleared
+ */
+void ssd1306_emulator_test_link(ssd1306_handle_t *handle, ssd1306_emulator_t *emulator)
+{
+    memset(emulator, 0, sizeof(ssd1306_emulator_t));                             /* clear the emulator */
+    (void)a_emulator_reset_write(emulator, 0);                                   /* reset the addressing state */
+    emulator->dc = 0xFF;                                                         /* unknown line level */
+
+    DRIVER_SSD1306_LINK_INIT(handle, ssd1306_handle_t);
+    DRIVER_SSD1306_LINK_USER_CTX(handle, emulator);
+    DRIVER_SSD1306_LINK_IIC_INIT(handle, a_emulator_init);
+    DRIVER_SSD1306_LINK_IIC_DEINIT(handle, a_emulator_deinit);
+    DRIVER_SSD1306_LINK_IIC_WRITE_CTX(handle, a_emulator_iic_write);
+    DRIVER_SSD1306_LINK_IIC_WRITE_COMMAND_CTX(handle, a_emulator_iic_write_cmd);
+    DRIVER_SSD1306_LINK_SPI_INIT(handle, a_emulator_init);
+    DRIVER_SSD1306_LINK_SPI_DEINIT(handle, a_emulator_deinit);
+    DRIVER_SSD1306_LINK_SPI_WRITE_COMMAND_CTX(handle, a_emulator_spi_write_cmd);
+    DRIVER_SSD1306_LINK_SPI_COMMAND_DATA_GPIO_INIT(handle, a_emulator_init);
+    DRIVER_SSD1306_LINK_SPI_COMMAND_DATA_GPIO_DEINIT(handle, a_emulator_deinit);
+    DRIVER_SSD1306_LINK_SPI_COMMAND_DATA_GPIO_WRITE_CTX(handle, a_emulator_dc_write);
+    DRIVER_SSD1306_LINK_RESET_GPIO_INIT(handle, a_emulator_init);
+    DRIVER_SSD1306_LINK_RESET_GPIO_DEINIT(handle, a_emulator_deinit);
+    DRIVER_SSD1306_LINK_RESET_GPIO_WRITE_CTX(handle, a_emulator_reset_write);
+    DRIVER_SSD1306_LINK_DELAY_MS(handle, a_emulator_delay_ms);
+    DRIVER_SSD1306_LINK_DEBUG_PRINT(handle, ssd1306_interface_debug_print);
+}
+
+/**
+ * @brief     link the asynchronous writes of the emulator to a handle
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @note      the writes are held until ssd1306_emulator_test_complete is called
+ */
+void ssd1306_emulator_test_link_async(ssd1306_handle_t *handle)
+{
+    DRIVER_SSD1306_LINK_IIC_WRITE_ASYNC_CTX(handle, a_emulator_iic_write_async);
+    DRIVER_SSD1306_LINK_SPI_WRITE_COMMAND_ASYNC_CTX(handle, a_emulator_spi_write_cmd_async);
+}
+
+/**
+ * @brief     clear the emulator counters and the command log
+ * @param[in] *emulator pointer to an ssd1306 emulator structure
+ * @note      none
+ */
+void ssd1306_emulator_test_clear(ssd1306_emulator_t *emulator)
+{
+    emulator->transactions = 0;                                                  /* clear the transactions */
+    emulator->bytes = 0;                                                         /* clear the bytes */
+    emulator->dc_toggles = 0;                                                    /* clear the toggles */
+    emulator->async_starts = 0;                                                  /* clear the starts */
+    emulator->log_len = 0;                                                       /* clear the log */
+}
+
+/**
+ * @brief     complete the asynchronous write in flight
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @return    status code
+ *            - 0 nothing was in flight
+ *            - 1 a write was completed
+ * @note      the held write reaches the panel and the irq handler is called
+ */
+uint8_t ssd1306_emulator_test_complete(ssd1306_handle_t *handle)
+{
+    ssd1306_emulator_t *emulator = (ssd1306_emulator_t *)handle->user_ctx;
+
+    if (emulator->async_pending == 0)                                            /* check the write in flight */
+    {
+        return 0;                                                                /* nothing to do */
+    }
+    emulator->async_pending = 0;                                                 /* clear in flight */
+    if (emulator->async_iic != 0)                                                /* iic */
+    {
+        a_emulator_iic(emulator, emulator->async_reg,
+                       emulator->async_buf, emulator->async_len);                /* feed the frame */
+    }
+    else
+    {
+        (void)a_emulator_spi_write_cmd(emulator, emulator->async_buf,
+                                       emulator->async_len);                     /* feed the bytes */
+    }
+    (void)ssd1306_flush_irq_handler(handle);                                     /* run the irq handler */
+
+    return 1;                                                                    /* a write was completed */
+}
+
+/**
+ * @brief     compare the panel ram with a gram buffer
+ * @param[in] *emulator pointer to an ssd1306 emulator structure
+ * @param[in] **gram pointer to a gram buffer
+ * @return    different bytes
+ * @note      none
+ */
+uint16_t ssd1306_emulator_test_compare(ssd1306_emulator_t *emulator, uint8_t (*gram)[8])
+{
+    uint8_t i;
+    uint8_t j;
+    uint16_t diff;
+
+    diff = 0;                                                                    /* init diff */
+    for (i = 0; i < 128; i++)                                                    /* all columns */
+    {
+        for (j = 0; j < 8; j++)                                                  /* all pages */
+        {
+            if (emulator->ram[j][i] != gram[i][j])                               /* if different */
+            {
+                diff++;                                                          /* diff++ */
+            }
+        }
+    }
+
+    return diff;                                                                 /* return the diff */
+}
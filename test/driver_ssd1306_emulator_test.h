@@ -0,0 +1,141 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_ssd1306_emulator_test.h
+ * @brief     driver ssd1306 emulator test header file
+ * @version   2.0.0
+ * @author    Shifeng Li
+ * @date      2021-03-30
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2021/03/30  <td>2.0      <td>Shifeng Li  <td>format the code
+ * <tr><td>2020/12/10  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef DRIVER_SSD1306_EMULATOR_TEST_H
+#define DRIVER_SSD1306_EMULATOR_TEST_H
+
+#include "driver_ssd1306_interface.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup ssd1306_test_driver ssd1306 test driver function
+ * @brief    ssd1306 test driver modules
+ * @ingroup  ssd1306_driver
+ * @{
+ */
+
+/**
+ * @brief ssd1306 emulator buffer size definition
+ */
+#define SSD1306_EMULATOR_LOG_LEN      256         /**< max logged command bytes */
+#define SSD1306_EMULATOR_ASYNC_LEN    1040        /**< max asynchronous write length */
+
+/**
+ * @brief ssd1306 emulator structure definition
+ */
+typedef struct ssd1306_emulator_s
+{
+    uint8_t ram[8][128];                          /**< panel ram */
+    uint8_t mode;                                 /**< memory addressing mode */
+    uint8_t page;                                 /**< page pointer */
+    uint8_t column;                               /**< column pointer */
+    uint8_t column_start;                         /**< window start column */
+    uint8_t column_end;                           /**< window end column */
+    uint8_t page_start;                           /**< window start page */
+    uint8_t page_end;                             /**< window end page */
+    uint8_t cmd;                                  /**< command waiting for arguments */
+    uint8_t args[8];                              /**< command arguments */
+    uint8_t args_len;                             /**< received arguments */
+    uint8_t args_need;                            /**< needed arguments */
+    uint8_t dc;                                   /**< data command line level */
+    uint8_t fail;                                 /**< fail the next writes flag */
+    uint32_t transactions;                        /**< bus transactions */
+    uint32_t bytes;                               /**< bytes on the bus */
+    uint32_t dc_toggles;                          /**< data command line level changes */
+    uint16_t log_len;                             /**< logged command bytes */
+    uint8_t log[SSD1306_EMULATOR_LOG_LEN];        /**< command log */
+    uint8_t async_pending;                        /**< asynchronous write in flight flag */
+    uint8_t async_iic;                            /**< asynchronous iic write flag */
+    uint8_t async_reg;                            /**< asynchronous iic control byte */
+    uint16_t async_len;                           /**< asynchronous write length */
+    uint32_t async_starts;                        /**< started asynchronous writes */
+    uint8_t async_buf[SSD1306_EMULATOR_ASYNC_LEN];/**< asynchronous write copy */
+} ssd1306_emulator_t;
+
+/**
+ * @brief     link the emulator to a handle
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @param[in] *emulator pointer to an ssd1306 emulator structure
+ * @note      the handle is cleared and linked to the emulator, the panel ram is cleared
+ */
+void ssd1306_emulator_test_link(ssd1306_handle_t *handle, ssd1306_emulator_t *emulator);
+
+/**
+ * @brief     link the asynchronous writes of the emulator to a handle
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @note      the writes are held until ssd1306_emulator_test_complete is called
+ */
+void ssd1306_emulator_test_link_async(ssd1306_handle_t *handle);
+
+/**
+ * @brief     clear the emulator counters and the command log
+ * @param[in] *emulator pointer to an ssd1306 emulator structure
+ * @note      none
+ */
+void ssd1306_emulator_test_clear(ssd1306_emulator_t *emulator);
+
+/**
+ * @brief     complete the asynchronous write in flight
+ * @param[in] *handle pointer to an ssd1306 handle structure
+ * @return    status code
+ *            - 0 nothing was in flight
+ *            - 1 a write was completed
+ * @note      the held write reaches the panel and the irq handler is called
+ */
+uint8_t ssd1306_emulator_test_complete(ssd1306_handle_t *handle);
+
+/**
+ * @brief     compare the panel ram with a gram buffer
+ * @param[in] *emulator pointer to an ssd1306 emulator structure
+ * @param[in] **gram pointer to a gram buffer
+ * @return    different bytes
+ * @note      none
+ */
+uint16_t ssd1306_emulator_test_compare(ssd1306_emulator_t *emulator, uint8_t (*gram)[8]);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,205 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_ssd1306_fill_test.c
+ * @brief     driver ssd1306 fill and clear test source file
+ * @version   2.0.0
+ * @author    Shifeng Li
+ * @date      2021-03-30
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2021/03/30  <td>2.0      <td>Shifeng Li  <td>format the code
+ * <tr><td>2020/12/10  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_ssd1306_fill_test.h"
+
+static ssd1306_handle_t gs_handle;          /**< ssd1306 handle */
+static ssd1306_emulator_t gs_emulator;      /**< ssd1306 emulator */
+static uint8_t gs_back[128][8];             /**< back gram buffer */
+
+/**
+ * @brief     check the panel and the gram hold a pattern
+ * @param[in] pattern fill byte
+ * @return    status code
+ *            - 0 success
+ *            - 1 check failed
+ * @note      none
+ */
+static uint8_t a_fill_test_check(uint8_t pattern)
+{
+    uint8_t i;
+    uint8_t j;
+    
+    for (i = 0; i < 128; i++)
+    {
+        for (j = 0; j < 8; j++)
+        {
+            if ((gs_handle.gram[i][j] != pattern) || (gs_emulator.ram[j][i] != pattern))
+            {
+                ssd1306_interface_debug_print("ssd1306: column %d page %d is not filled.\n", i, j);
+                
+                return 1;
+            }
+        }
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     fill and clear test
+ * @param[in] interface interface type
+ * @return    status code
+ *            - 0 success
+ *            - 1 test failed
+ * @note      the panel is emulated, no hardware is needed
+ */
+uint8_t ssd1306_fill_test(ssd1306_interface_t interface)
+{
+    uint8_t res;
+    uint32_t frame;
+    
+    /* start fill test */
+    ssd1306_interface_debug_print("ssd1306: start fill test.\n");
+    
+    /* init */
+    ssd1306_emulator_test_link(&gs_handle, &gs_emulator);
+    res = ssd1306_set_interface(&gs_handle, interface);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: set interface failed.\n");
+        
+        return 1;
+    }
+    res = ssd1306_init(&gs_handle);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: init failed.\n");
+        
+        return 1;
+    }
+    
+    /* a full frame in the frame window sets the reference transaction count */
+    res = ssd1306_gram_update_frame(&gs_handle);
+    ssd1306_emulator_test_clear(&gs_emulator);
+    res |= ssd1306_gram_update_frame(&gs_handle);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: gram update frame failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    frame = gs_emulator.transactions;
+    ssd1306_interface_debug_print("ssd1306: full frame takes %d transactions.\n", frame);
+    
+    /* fill is one full frame burst */
+    ssd1306_interface_debug_print("ssd1306: fill the screen.\n");
+    ssd1306_emulator_test_clear(&gs_emulator);
+    res = ssd1306_fill(&gs_handle, 0xA5);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: fill failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    if ((a_fill_test_check(0xA5) != 0) || (gs_emulator.transactions != frame) || (gs_handle.dirty_page != 0))
+    {
+        ssd1306_interface_debug_print("ssd1306: fill sent %d transactions.\n", gs_emulator.transactions);
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* clear drops the marks of a drawn back buffer */
+    ssd1306_interface_debug_print("ssd1306: clear with a drawn back buffer.\n");
+    res = ssd1306_set_back_buffer(&gs_handle, gs_back);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: set back buffer failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    res = ssd1306_gram_fill_rect(&gs_handle, 20, 8, 60, 40, 1);
+    if ((res != 0) || (gs_handle.back_dirty_page == 0))
+    {
+        ssd1306_interface_debug_print("ssd1306: gram fill rect failed.\n");
+        (void)ssd1306_set_back_buffer(&gs_handle, NULL);
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    ssd1306_emulator_test_clear(&gs_emulator);
+    res = ssd1306_clear(&gs_handle);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: clear failed.\n");
+        (void)ssd1306_set_back_buffer(&gs_handle, NULL);
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    if ((a_fill_test_check(0x00) != 0) || (gs_back[40][3] != 0) || (gs_emulator.transactions != frame) ||
+        (gs_handle.back_dirty_page != 0))
+    {
+        ssd1306_interface_debug_print("ssd1306: clear left the back buffer marks.\n");
+        (void)ssd1306_set_back_buffer(&gs_handle, NULL);
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* the swapped frame has nothing left to send */
+    res = ssd1306_gram_swap(&gs_handle);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: gram swap failed.\n");
+        (void)ssd1306_set_back_buffer(&gs_handle, NULL);
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    ssd1306_emulator_test_clear(&gs_emulator);
+    res = ssd1306_gram_update_dirty(&gs_handle);
+    if ((res != 0) || (gs_emulator.transactions != 0))
+    {
+        ssd1306_interface_debug_print("ssd1306: cleared frame sent %d transactions.\n", gs_emulator.transactions);
+        (void)ssd1306_set_back_buffer(&gs_handle, NULL);
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    (void)ssd1306_set_back_buffer(&gs_handle, NULL);
+    
+    /* finish fill test */
+    ssd1306_interface_debug_print("ssd1306: finish fill test.\n");
+    (void)ssd1306_deinit(&gs_handle);
+    
+    return 0;
+}
@@ -0,0 +1,350 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_ssd1306_flush_test.c
+ * @brief     driver ssd1306 flush test source file
+ * @version   2.0.0
+ * @author    Shifeng Li
+ * @date      2021-03-30
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2021/03/30  <td>2.0      <td>Shifeng Li  <td>format the code
+ * <tr><td>2020/12/10  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_ssd1306_flush_test.h"
+
+static ssd1306_handle_t gs_handle;          /**< ssd1306 handle */
+static ssd1306_emulator_t gs_emulator;      /**< ssd1306 emulator */
+static uint8_t gs_back[128][8];             /**< back gram buffer */
+
+/**
+ * @brief     check the emulated panel and the bus transactions
+ * @param[in] *name pointer to the update name
+ * @param[in] max_transactions max allowed bus transactions
+ * @return    status code
+ *            - 0 success
+ *            - 1 check failed
+ * @note      none
+ */
+static uint8_t a_flush_test_check(const char *name, uint32_t max_transactions)
+{
+    uint16_t diff;
+    
+    diff = ssd1306_emulator_test_compare(&gs_emulator, gs_handle.gram_flush);
+    ssd1306_interface_debug_print("ssd1306: %s sent %d transactions %d bytes.\n", name,
+                                  gs_emulator.transactions, gs_emulator.bytes);
+    if (diff != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: %s left %d different bytes.\n", name, diff);
+        
+        return 1;
+    }
+    if (gs_emulator.transactions > max_transactions)
+    {
+        ssd1306_interface_debug_print("ssd1306: %s sent more than %d transactions.\n", name, max_transactions);
+        
+        return 1;
+    }
+    ssd1306_emulator_test_clear(&gs_emulator);
+    
+    return 0;
+}
+
+/**
+ * @brief     flush test
+ * @param[in] interface interface type
+ * @return    status code
+ *            - 0 success
+ *            - 1 test failed
+ * @note      the panel is emulated, no hardware is needed
+ */
+uint8_t ssd1306_flush_test(ssd1306_interface_t interface)
+{
+    uint8_t res;
+    uint8_t i;
+    uint8_t j;
+    uint16_t steps;
+    ssd1306_flush_status_t status;
+    uint8_t raw[16];
+    char test_str[] = "libdriver";
+    
+    /* link the emulator */
+    ssd1306_emulator_test_link(&gs_handle, &gs_emulator);
+    
+    /* start flush test */
+    ssd1306_interface_debug_print("ssd1306: start flush test.\n");
+    
+    /* set interface */
+    res = ssd1306_set_interface(&gs_handle, interface);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: set interface failed.\n");
+        
+        return 1;
+    }
+    
+    /* set addr pin */
+    res = ssd1306_set_addr_pin(&gs_handle, SSD1306_ADDR_SA0_0);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: set addr failed.\n");
+        
+        return 1;
+    }
+    
+    /* ssd1306 init */
+    res = ssd1306_init(&gs_handle);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: init failed.\n");
+        
+        return 1;
+    }
+    ssd1306_emulator_test_clear(&gs_emulator);
+    
+    /* draw a pattern */
+    for (i = 0; i < 128; i++)
+    {
+        for (j = 0; j < 8; j++)
+        {
+            gs_handle.gram[i][j] = (uint8_t)(i * 8 + j + 1);
+        }
+    }
+    
+    /* page bursts, two transactions for each page at most */
+    res = ssd1306_gram_update(&gs_handle);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: gram update failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    if (a_flush_test_check("gram update", 16) != 0)
+    {
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* one frame burst */
+    res = ssd1306_gram_fill_rect(&gs_handle, 8, 8, 100, 40, 1);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: gram fill rect failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    res = ssd1306_gram_update_frame(&gs_handle);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: gram update frame failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    if (a_flush_test_check("gram update frame", 2) != 0)
+    {
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* only the dirty pages */
+    res = ssd1306_gram_write_string(&gs_handle, 0, 48, test_str, (uint16_t)strlen(test_str), 1, SSD1306_FONT_12);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: gram write string failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    res = ssd1306_gram_update_dirty(&gs_handle);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: gram update dirty failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    if (a_flush_test_check("gram update dirty", 4) != 0)
+    {
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* bounded steps refuse the addressing commands in between */
+    res = ssd1306_gram_fill_rect(&gs_handle, 30, 0, 90, 63, 0);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: gram fill rect failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    steps = 0;
+    do
+    {
+        res = ssd1306_gram_update_step(&gs_handle, SSD1306_FLUSH_SOURCE_DIRTY, 32, &status);
+        if ((res != 0) || (status == SSD1306_FLUSH_STATUS_ERROR))
+        {
+            ssd1306_interface_debug_print("ssd1306: gram update step failed.\n");
+            (void)ssd1306_deinit(&gs_handle);
+            
+            return 1;
+        }
+        if ((status == SSD1306_FLUSH_STATUS_BUSY) && 
+            ((ssd1306_set_memory_addressing_mode(&gs_handle, SSD1306_MEMORY_ADDRESSING_MODE_HORIZONTAL) != 4) || 
+             (ssd1306_write_data(&gs_handle, (uint8_t *)test_str, 1) != 4)))
+        {
+            ssd1306_interface_debug_print("ssd1306: addressing is not refused between steps.\n");
+            (void)ssd1306_deinit(&gs_handle);
+            
+            return 1;
+        }
+        steps++;
+    } while ((status == SSD1306_FLUSH_STATUS_BUSY) && (steps < 1024));
+    ssd1306_interface_debug_print("ssd1306: gram update step took %d steps.\n", steps);
+    if (a_flush_test_check("gram update step", 64) != 0)
+    {
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* a flush before the swap keeps the dirty marks of the back buffer */
+    res = ssd1306_set_back_buffer(&gs_handle, gs_back);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: set back buffer failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    res = ssd1306_gram_fill_rect(&gs_handle, 10, 8, 40, 30, 1);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: gram fill rect failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    res = ssd1306_gram_update_dirty(&gs_handle);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: gram update dirty failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    if (a_flush_test_check("gram update before swap", 0) != 0)
+    {
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    res = ssd1306_gram_swap(&gs_handle);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: gram swap failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    res = ssd1306_gram_update_dirty(&gs_handle);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: gram update dirty failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    if (a_flush_test_check("gram update after swap", 8) != 0)
+    {
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    res = ssd1306_set_back_buffer(&gs_handle, NULL);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: set back buffer failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* the raw page mode access works after a window flush */
+    res = ssd1306_set_memory_addressing_mode(&gs_handle, SSD1306_MEMORY_ADDRESSING_MODE_PAGE);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: set memory addressing mode failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    res = ssd1306_clear(&gs_handle);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: clear failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    for (i = 0; i < 16; i++)
+    {
+        raw[i] = (uint8_t)(0x80 | i);
+    }
+    if ((ssd1306_set_page_address(&gs_handle, 2) != 0) ||
+        (ssd1306_set_low_column_start_address(&gs_handle, 0) != 0) ||
+        (ssd1306_set_high_column_start_address(&gs_handle, 0) != 0) ||
+        (ssd1306_write_data(&gs_handle, raw, 16) != 0))
+    {
+        ssd1306_interface_debug_print("ssd1306: raw write failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    for (i = 0; i < 16; i++)
+    {
+        if ((gs_emulator.ram[2][i] != raw[i]) || (gs_emulator.ram[3][i] != 0))
+        {
+            ssd1306_interface_debug_print("ssd1306: raw write missed page 2 column %d.\n", i);
+            (void)ssd1306_deinit(&gs_handle);
+            
+            return 1;
+        }
+    }
+    
+    /* finish flush test */
+    ssd1306_interface_debug_print("ssd1306: finish flush test.\n");
+    (void)ssd1306_deinit(&gs_handle);
+    
+    return 0;
+}
@@ -0,0 +1,266 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_ssd1306_group_test.c
+ * @brief     driver ssd1306 panel group test source file
+ * @version   2.0.0
+ * @author    Shifeng Li
+ * @date      2021-03-30
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2021/03/30  <td>2.0      <td>Shifeng Li  <td>format the code
+ * <tr><td>2020/12/10  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_ssd1306_group_test.h"
+#include <string.h>
+
+static ssd1306_handle_t gs_handle[2];                                    /**< ssd1306 handles */
+static ssd1306_emulator_t gs_emulator[2];                                /**< ssd1306 emulators */
+static ssd1306_group_t gs_group;                                         /**< ssd1306 panel group */
+static uint8_t (*gs_spi_write)(void *ctx, uint8_t *buf, uint16_t len);   /**< emulator spi write */
+static uint8_t (*gs_dc_write)(void *ctx, uint8_t value);                 /**< emulator data command write */
+
+/**
+ * @brief     write the shared data command line
+ * @param[in] *ctx pointer to the emulator of the panel
+ * @param[in] value written value
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the line reaches both panels
+ */
+static uint8_t a_group_test_dc_write(void *ctx, uint8_t value)
+{
+    (void)ctx;
+    
+    return (uint8_t)(gs_dc_write(&gs_emulator[0], value) | gs_dc_write(&gs_emulator[1], value));
+}
+
+/**
+ * @brief     write with the chip select of both panels asserted
+ * @param[in] *ctx pointer to the user context
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+static uint8_t a_group_test_write_all(void *ctx, uint8_t *buf, uint16_t len)
+{
+    (void)ctx;
+    
+    return (uint8_t)(gs_spi_write(&gs_emulator[0], buf, len) | gs_spi_write(&gs_emulator[1], buf, len));
+}
+
+/**
+ * @brief  deinit both panels
+ * @return 1
+ * @note   none
+ */
+static uint8_t a_group_test_deinit(void)
+{
+    (void)ssd1306_deinit(&gs_handle[0]);
+    (void)ssd1306_deinit(&gs_handle[1]);
+    
+    return 1;
+}
+
+/**
+ * @brief     check both panels received a command stream
+ * @param[in] *buf pointer to a command buffer
+ * @param[in] len buffer length
+ * @return    status code
+ *            - 0 success
+ *            - 1 check failed
+ * @note      none
+ */
+static uint8_t a_group_test_log(uint8_t *buf, uint16_t len)
+{
+    uint8_t i;
+    
+    for (i = 0; i < 2; i++)
+    {
+        if ((gs_emulator[i].log_len != len) || (memcmp(gs_emulator[i].log, buf, len) != 0))
+        {
+            ssd1306_interface_debug_print("ssd1306: panel %d missed the stream.\n", i);
+            
+            return 1;
+        }
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief  panel group test
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   the panels are emulated, no hardware is needed
+ */
+uint8_t ssd1306_group_test(void)
+{
+    uint8_t res;
+    uint8_t i;
+    uint8_t stream[4] = {0x81, 0x40, 0xA6, 0xAF};
+    uint8_t split[1] = {0x81};
+    uint8_t contrast[2] = {0x81, 0x7F};
+    uint32_t tx_bytes[2];
+    uint32_t tx_count[2];
+    
+    /* start group test */
+    ssd1306_interface_debug_print("ssd1306: start group test.\n");
+    
+    /* two spi panels share the data command line */
+    for (i = 0; i < 2; i++)
+    {
+        ssd1306_emulator_test_link(&gs_handle[i], &gs_emulator[i]);
+        gs_spi_write = gs_handle[i].spi_write_cmd_ctx;
+        gs_dc_write = gs_handle[i].spi_cmd_data_gpio_write_ctx;
+        DRIVER_SSD1306_LINK_SPI_COMMAND_DATA_GPIO_WRITE_CTX(&gs_handle[i], a_group_test_dc_write);
+        if ((ssd1306_set_interface(&gs_handle[i], SSD1306_INTERFACE_SPI) != 0) || (ssd1306_init(&gs_handle[i]) != 0))
+        {
+            ssd1306_interface_debug_print("ssd1306: init failed.\n");
+            (void)ssd1306_deinit(&gs_handle[0]);
+            
+            return 1;
+        }
+    }
+    if ((ssd1306_group_init(&gs_group) != 0) || (ssd1306_group_add(&gs_group, &gs_handle[0]) != 0) ||
+        (ssd1306_group_add(&gs_group, &gs_handle[1]) != 0))
+    {
+        ssd1306_interface_debug_print("ssd1306: group add failed.\n");
+        
+        return a_group_test_deinit();
+    }
+    res = ssd1306_group_add(&gs_group, &gs_handle[1]);
+    if (res != 5)
+    {
+        ssd1306_interface_debug_print("ssd1306: duplicate group add returned %d.\n", res);
+        
+        return a_group_test_deinit();
+    }
+    
+    /* a split stream is refused */
+    res = ssd1306_group_write_command(&gs_group, split, 1);
+    if (res != 4)
+    {
+        ssd1306_interface_debug_print("ssd1306: split stream returned %d.\n", res);
+        
+        return a_group_test_deinit();
+    }
+    
+    /* without the broadcast hook the stream is sent once per panel */
+    ssd1306_interface_debug_print("ssd1306: group write command per panel.\n");
+    ssd1306_emulator_test_clear(&gs_emulator[0]);
+    ssd1306_emulator_test_clear(&gs_emulator[1]);
+    res = ssd1306_group_write_command(&gs_group, stream, 4);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: group write command failed.\n");
+        
+        return a_group_test_deinit();
+    }
+    if ((a_group_test_log(stream, 4) != 0) || (gs_emulator[0].transactions != 1) || (gs_emulator[1].transactions != 1) ||
+        (gs_group.tx_count != 0))
+    {
+        return a_group_test_deinit();
+    }
+    
+    /* with the broadcast hook the stream is sent once and counted by every panel */
+    ssd1306_interface_debug_print("ssd1306: group write command broadcast.\n");
+    DRIVER_SSD1306_LINK_GROUP_SPI_WRITE_COMMAND_ALL(&gs_group, a_group_test_write_all);
+    ssd1306_emulator_test_clear(&gs_emulator[0]);
+    ssd1306_emulator_test_clear(&gs_emulator[1]);
+    for (i = 0; i < 2; i++)
+    {
+        tx_bytes[i] = gs_handle[i].tx_bytes;
+        tx_count[i] = gs_handle[i].tx_count;
+    }
+    res = ssd1306_group_set_contrast(&gs_group, 0x7F);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: group set contrast failed.\n");
+        
+        return a_group_test_deinit();
+    }
+    if ((a_group_test_log(contrast, 2) != 0) || (gs_group.tx_count != 1) || (gs_group.tx_bytes != 2))
+    {
+        return a_group_test_deinit();
+    }
+    for (i = 0; i < 2; i++)
+    {
+        if ((gs_handle[i].tx_count - tx_count[i] != 1) || (gs_handle[i].tx_bytes - tx_bytes[i] != 2))
+        {
+            ssd1306_interface_debug_print("ssd1306: panel %d didn't count the broadcast.\n", i);
+            
+            return a_group_test_deinit();
+        }
+    }
+    
+    /* the table is broadcast and the screens are cleared */
+    ssd1306_interface_debug_print("ssd1306: group load init table.\n");
+    for (i = 0; i < 2; i++)
+    {
+        (void)ssd1306_gram_fill_rect(&gs_handle[i], 0, 0, 127, 63, 1);
+        (void)ssd1306_gram_update(&gs_handle[i]);
+    }
+    ssd1306_emulator_test_clear(&gs_emulator[0]);
+    ssd1306_emulator_test_clear(&gs_emulator[1]);
+    res = ssd1306_group_load_init_table(&gs_group, stream, 4);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: group load init table failed.\n");
+        
+        return a_group_test_deinit();
+    }
+    if ((gs_emulator[0].log_len < 4) || (gs_emulator[1].log_len < 4) ||
+        (memcmp(&gs_emulator[0].log[gs_emulator[0].log_len - 4], stream, 4) != 0) ||
+        (memcmp(&gs_emulator[1].log[gs_emulator[1].log_len - 4], stream, 4) != 0) || (gs_group.tx_count != 2))
+    {
+        ssd1306_interface_debug_print("ssd1306: table was not broadcast.\n");
+        
+        return a_group_test_deinit();
+    }
+    for (i = 0; i < 2; i++)
+    {
+        if ((gs_handle[i].gram[64][3] != 0) || (gs_emulator[i].ram[3][64] != 0) ||
+            (ssd1306_emulator_test_compare(&gs_emulator[i], gs_handle[i].gram) != 0))
+        {
+            ssd1306_interface_debug_print("ssd1306: panel %d was not cleared.\n", i);
+            
+            return a_group_test_deinit();
+        }
+    }
+    
+    /* finish group test */
+    ssd1306_interface_debug_print("ssd1306: finish group test.\n");
+    (void)a_group_test_deinit();
+    
+    return 0;
+}
@@ -0,0 +1,244 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_ssd1306_handoff_test.c
+ * @brief     driver ssd1306 handoff test source file
+ * @version   2.0.0
+ * @author    Shifeng Li
+ * @date      2021-03-30
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2021/03/30  <td>2.0      <td>Shifeng Li  <td>format the code
+ * <tr><td>2020/12/10  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_ssd1306_handoff_test.h"
+#include <pthread.h>
+#include <sched.h>
+
+/**
+ * @brief handoff test frame count definition
+ */
+#define HANDOFF_TEST_FRAMES    2000        /**< frames published by the renderer */
+
+static ssd1306_handle_t gs_handle;                                      /**< ssd1306 handle */
+static ssd1306_emulator_t gs_emulator;                                  /**< ssd1306 emulator */
+static ssd1306_handoff_t gs_handoff;                                    /**< ssd1306 hand-off */
+static pthread_mutex_t gs_mutex = PTHREAD_MUTEX_INITIALIZER;            /**< hand-off mutex */
+static volatile uint8_t gs_render_done;                                 /**< renderer done flag */
+
+/**
+ * @brief     lock the hand-off
+ * @param[in] *ctx pointer to the user context
+ * @note      none
+ */
+static void a_handoff_test_lock(void *ctx)
+{
+    (void)ctx;
+    (void)pthread_mutex_lock(&gs_mutex);
+}
+
+/**
+ * @brief     unlock the hand-off
+ * @param[in] *ctx pointer to the user context
+ * @note      none
+ */
+static void a_handoff_test_unlock(void *ctx)
+{
+    (void)ctx;
+    (void)pthread_mutex_unlock(&gs_mutex);
+}
+
+/**
+ * @brief     renderer thread
+ * @param[in] *arg pointer to the thread argument
+ * @return    NULL
+ * @note      every frame is filled with its own number so a torn frame can be seen
+ */
+static void *a_handoff_test_render(void *arg)
+{
+    uint32_t i;
+    uint8_t *frame;
+    
+    (void)arg;
+    for (i = 1; i <= HANDOFF_TEST_FRAMES; i++)
+    {
+        (void)ssd1306_handoff_get_frame(&gs_handoff, &frame);
+        memset(frame, (int)(i & 0xFF), 1024);
+        (void)ssd1306_handoff_publish(&gs_handoff);
+        (void)sched_yield();
+    }
+    (void)pthread_mutex_lock(&gs_mutex);
+    gs_render_done = 1;
+    (void)pthread_mutex_unlock(&gs_mutex);
+    
+    return NULL;
+}
+
+/**
+ * @brief  consume and flush one frame
+ * @param[out] *fresh pointer to a fresh flag buffer
+ * @return status code
+ *         - 0 success
+ *         - 1 flush failed
+ * @note   none
+ */
+static uint8_t a_handoff_test_flush(uint8_t *fresh)
+{
+    uint8_t res;
+    uint8_t i;
+    uint8_t j;
+    
+    res = ssd1306_handoff_consume(&gs_handoff, fresh);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: handoff consume failed.\n");
+        
+        return 1;
+    }
+    if (*fresh == 0)
+    {
+        return 0;
+    }
+    for (i = 0; i < 128; i++)
+    {
+        for (j = 0; j < 8; j++)
+        {
+            if (gs_handle.gram[i][j] != gs_handle.gram[0][0])
+            {
+                ssd1306_interface_debug_print("ssd1306: handoff frame is torn.\n");
+                
+                return 1;
+            }
+        }
+    }
+    res = ssd1306_gram_update_dirty(&gs_handle);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: gram update dirty failed.\n");
+        
+        return 1;
+    }
+    if (ssd1306_emulator_test_compare(&gs_emulator, gs_handle.gram) != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: handoff frame is not on the panel.\n");
+        
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief  frame hand-off stress test
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   the panel is emulated, a renderer thread and a flush thread run at the same time
+ */
+uint8_t ssd1306_handoff_test(void)
+{
+    uint8_t res;
+    uint8_t fresh;
+    uint8_t done;
+    uint32_t frames;
+    pthread_t render;
+    
+    /* link the emulator */
+    ssd1306_emulator_test_link(&gs_handle, &gs_emulator);
+    DRIVER_SSD1306_LINK_LOCK(&gs_handle, a_handoff_test_lock);
+    DRIVER_SSD1306_LINK_UNLOCK(&gs_handle, a_handoff_test_unlock);
+    
+    /* start handoff test */
+    ssd1306_interface_debug_print("ssd1306: start handoff test.\n");
+    
+    /* ssd1306 init */
+    res = ssd1306_init(&gs_handle);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: init failed.\n");
+        
+        return 1;
+    }
+    
+    /* handoff init */
+    res = ssd1306_handoff_init(&gs_handoff, &gs_handle);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: handoff init failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* run the renderer */
+    gs_render_done = 0;
+    if (pthread_create(&render, NULL, a_handoff_test_render, NULL) != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: create renderer failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* flush until the renderer is done and the last frame is consumed */
+    frames = 0;
+    res = 0;
+    do
+    {
+        (void)pthread_mutex_lock(&gs_mutex);
+        done = gs_render_done;
+        (void)pthread_mutex_unlock(&gs_mutex);
+        if (a_handoff_test_flush(&fresh) != 0)
+        {
+            res = 1;
+            
+            break;
+        }
+        frames += fresh;
+    } while ((done == 0) || (fresh != 0));
+    (void)pthread_join(render, NULL);
+    if (res != 0)
+    {
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    ssd1306_interface_debug_print("ssd1306: flushed %d of %d frames.\n", frames, HANDOFF_TEST_FRAMES);
+    if (gs_handle.gram[0][0] != (HANDOFF_TEST_FRAMES & 0xFF))
+    {
+        ssd1306_interface_debug_print("ssd1306: the last frame is lost.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* finish handoff test */
+    ssd1306_interface_debug_print("ssd1306: finish handoff test.\n");
+    (void)ssd1306_deinit(&gs_handle);
+    
+    return 0;
+}
@@ -0,0 +1,213 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_ssd1306_ring_test.c
+ * @brief     driver ssd1306 ring test source file
+ * @version   2.0.0
+ * @author    Shifeng Li
+ * @date      2021-03-30
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2021/03/30  <td>2.0      <td>Shifeng Li  <td>format the code
+ * <tr><td>2020/12/10  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_ssd1306_ring_test.h"
+
+static ssd1306_handle_t gs_handle;          /**< ssd1306 handle */
+static ssd1306_emulator_t gs_emulator;      /**< ssd1306 emulator */
+static ssd1306_ring_t gs_ring;              /**< ssd1306 command ring */
+static uint8_t gs_irq_masked;               /**< emulated interrupt mask */
+
+/**
+ * @brief     mask the emulated interrupts
+ * @param[in] *ctx pointer to the user context
+ * @note      none
+ */
+static void a_ring_test_lock(void *ctx)
+{
+    (void)ctx;
+    gs_irq_masked++;
+}
+
+/**
+ * @brief     unmask the emulated interrupts
+ * @param[in] *ctx pointer to the user context
+ * @note      none
+ */
+static void a_ring_test_unlock(void *ctx)
+{
+    (void)ctx;
+    gs_irq_masked--;
+}
+
+/**
+ * @brief     push a queue, drain it and check the commands on the bus
+ * @param[in] *name pointer to the case name
+ * @param[in] *queue pointer to the queued commands, each one is led by its length
+ * @param[in] queue_len queue length
+ * @param[in] *expect pointer to the expected command bytes
+ * @param[in] expect_len expected command bytes
+ * @return    status code
+ *            - 0 success
+ *            - 1 check failed
+ * @note      none
+ */
+static uint8_t a_ring_test_check(const char *name, uint8_t *queue, uint8_t queue_len,
+                                 uint8_t *expect, uint8_t expect_len)
+{
+    uint8_t res;
+    uint8_t i;
+    uint8_t count;
+    
+    ssd1306_emulator_test_clear(&gs_emulator);
+    for (i = 0; i < queue_len; i = (uint8_t)(i + queue[i] + 1))
+    {
+        res = ssd1306_ring_push(&gs_ring, &queue[i + 1], queue[i]);
+        if (res != 0)
+        {
+            ssd1306_interface_debug_print("ssd1306: %s ring push failed.\n", name);
+            
+            return 1;
+        }
+    }
+    res = ssd1306_ring_drain(&gs_ring, &count);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: %s ring drain failed.\n", name);
+        
+        return 1;
+    }
+    if ((gs_emulator.log_len != expect_len) || (memcmp(gs_emulator.log, expect, expect_len) != 0))
+    {
+        ssd1306_interface_debug_print("ssd1306: %s drained a wrong command stream.\n", name);
+        for (i = 0; i < gs_emulator.log_len; i++)
+        {
+            ssd1306_interface_debug_print("ssd1306: 0x%02X.\n", gs_emulator.log[i]);
+        }
+        
+        return 1;
+    }
+    if (gs_irq_masked != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: %s left the interrupts masked.\n", name);
+        
+        return 1;
+    }
+    ssd1306_interface_debug_print("ssd1306: %s drained %d commands in %d transactions.\n", name, count, gs_emulator.transactions);
+    
+    return 0;
+}
+
+/**
+ * @brief  command ring test
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   the panel is emulated, no hardware is needed
+ */
+uint8_t ssd1306_ring_test(void)
+{
+    uint8_t res;
+    uint8_t count;
+    uint8_t interleaved[] = {1, 0xAE, 2, 0x8D, 0x14, 1, 0xAF};
+    uint8_t interleaved_expect[] = {0xAE, 0x8D, 0x14, 0xAF};
+    uint8_t contrast[] = {2, 0x81, 0x10, 2, 0x81, 0x20, 2, 0x81, 0x30};
+    uint8_t contrast_expect[] = {0x81, 0x30};
+    uint8_t split[] = {2, 0x81, 0x10, 1, 0xA6, 2, 0x81, 0x20, 1, 0xAF, 1, 0xAE};
+    uint8_t split_expect[] = {0x81, 0x10, 0xA6, 0x81, 0x20, 0xAE};
+    
+    /* link the emulator */
+    ssd1306_emulator_test_link(&gs_handle, &gs_emulator);
+    DRIVER_SSD1306_LINK_RING_LOCK(&gs_handle, a_ring_test_lock);
+    DRIVER_SSD1306_LINK_RING_UNLOCK(&gs_handle, a_ring_test_unlock);
+    
+    /* start ring test */
+    ssd1306_interface_debug_print("ssd1306: start ring test.\n");
+    
+    /* ssd1306 init */
+    res = ssd1306_init(&gs_handle);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: init failed.\n");
+        
+        return 1;
+    }
+    
+    /* ring init */
+    res = ssd1306_ring_init(&gs_ring, &gs_handle);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: ring init failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* an empty ring sends nothing */
+    ssd1306_emulator_test_clear(&gs_emulator);
+    res = ssd1306_ring_drain(&gs_ring, &count);
+    if ((res != 0) || (count != 0) || (gs_emulator.transactions != 0))
+    {
+        ssd1306_interface_debug_print("ssd1306: empty ring drain failed.\n");
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* a setting is never moved across another command */
+    if (a_ring_test_check("interleaved", interleaved, sizeof(interleaved),
+                          interleaved_expect, sizeof(interleaved_expect)) != 0)
+    {
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* back to back settings collapse to the last one */
+    if (a_ring_test_check("contrast", contrast, sizeof(contrast),
+                          contrast_expect, sizeof(contrast_expect)) != 0)
+    {
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* settings split by other commands are all kept */
+    if (a_ring_test_check("split", split, sizeof(split),
+                          split_expect, sizeof(split_expect)) != 0)
+    {
+        (void)ssd1306_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* finish ring test */
+    ssd1306_interface_debug_print("ssd1306: finish ring test.\n");
+    (void)ssd1306_deinit(&gs_handle);
+    
+    return 0;
+}
@@ -0,0 +1,193 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_ssd1306_table_test.c
+ * @brief     driver ssd1306 init table test source file
+ * @version   2.0.0
+ * @author    Shifeng Li
+ * @date      2021-03-30
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2021/03/30  <td>2.0      <td>Shifeng Li  <td>format the code
+ * <tr><td>2020/12/10  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_ssd1306_table_test.h"
+#include "driver_ssd1306_basic.h"
+#include <string.h>
+
+static ssd1306_handle_t gs_handle[2];       /**< ssd1306 handles */
+static ssd1306_emulator_t gs_emulator[2];   /**< ssd1306 emulators */
+
+/**
+ * @brief  configure a panel with the setters of the default table
+ * @return status code
+ *         - 0 success
+ *         - 1 a setter failed
+ * @note   the order follows the default init table
+ */
+static uint8_t a_table_test_setters(void)
+{
+    uint8_t res;
+    ssd1306_handle_t *handle = &gs_handle[1];
+    
+    res = ssd1306_set_display(handle, SSD1306_DISPLAY_OFF);
+    res |= ssd1306_set_column_address_range(handle, SSD1306_BASIC_DEFAULT_COLUMN_ADDRESS_RANGE_START, SSD1306_BASIC_DEFAULT_COLUMN_ADDRESS_RANGE_END);
+    res |= ssd1306_set_page_address_range(handle, SSD1306_BASIC_DEFAULT_PAGE_ADDRESS_RANGE_START, SSD1306_BASIC_DEFAULT_PAGE_ADDRESS_RANGE_END);
+    res |= ssd1306_set_low_column_start_address(handle, SSD1306_BASIC_DEFAULT_LOW_COLUMN_START_ADDRESS);
+    res |= ssd1306_set_high_column_start_address(handle, SSD1306_BASIC_DEFAULT_HIGH_COLUMN_START_ADDRESS);
+    res |= ssd1306_set_display_start_line(handle, SSD1306_BASIC_DEFAULT_DISPLAY_START_LINE);
+    res |= ssd1306_set_fade_blinking_mode(handle, SSD1306_BASIC_DEFAULT_FADE_BLINKING_MODE, SSD1306_BASIC_DEFAULT_FADE_FRAMES);
+    res |= ssd1306_deactivate_scroll(handle);
+    res |= ssd1306_set_zoom_in(handle, SSD1306_BASIC_DEFAULT_ZOOM_IN);
+    res |= ssd1306_set_contrast(handle, SSD1306_BASIC_DEFAULT_CONTRAST);
+    res |= ssd1306_set_segment_remap(handle, SSD1306_BASIC_DEFAULT_SEGMENT);
+    res |= ssd1306_set_scan_direction(handle, SSD1306_BASIC_DEFAULT_SCAN_DIRECTION);
+    res |= ssd1306_set_display_mode(handle, SSD1306_BASIC_DEFAULT_DISPLAY_MODE);
+    res |= ssd1306_set_multiplex_ratio(handle, SSD1306_BASIC_DEFAULT_MULTIPLEX_RATIO);
+    res |= ssd1306_set_display_offset(handle, SSD1306_BASIC_DEFAULT_DISPLAY_OFFSET);
+    res |= ssd1306_set_display_clock(handle, SSD1306_BASIC_DEFAULT_OSCILLATOR_FREQUENCY, SSD1306_BASIC_DEFAULT_CLOCK_DIVIDE);
+    res |= ssd1306_set_precharge_period(handle, SSD1306_BASIC_DEFAULT_PHASE1_PERIOD, SSD1306_BASIC_DEFAULT_PHASE2_PERIOD);
+    res |= ssd1306_set_com_pins_hardware_conf(handle, SSD1306_BASIC_DEFAULT_PIN_CONF, SSD1306_BASIC_DEFAULT_LEFT_RIGHT_REMAP);
+    res |= ssd1306_set_deselect_level(handle, SSD1306_BASIC_DEFAULT_DESELECT_LEVEL);
+    res |= ssd1306_set_memory_addressing_mode(handle, SSD1306_MEMORY_ADDRESSING_MODE_PAGE);
+    res |= ssd1306_set_charge_pump(handle, SSD1306_CHARGE_PUMP_ENABLE);
+    res |= ssd1306_set_entire_display(handle, SSD1306_ENTIRE_DISPLAY_OFF);
+    res |= ssd1306_set_display(handle, SSD1306_DISPLAY_ON);
+    
+    return (res != 0) ? 1 : 0;
+}
+
+/**
+ * @brief  deinit both panels
+ * @return 1
+ * @note   none
+ */
+static uint8_t a_table_test_deinit(void)
+{
+    (void)ssd1306_deinit(&gs_handle[0]);
+    (void)ssd1306_deinit(&gs_handle[1]);
+    
+    return 1;
+}
+
+/**
+ * @brief     init table test
+ * @param[in] interface interface type
+ * @return    status code
+ *            - 0 success
+ *            - 1 test failed
+ * @note      the panels are emulated, no hardware is needed
+ */
+uint8_t ssd1306_table_test(ssd1306_interface_t interface)
+{
+    uint8_t res;
+    uint8_t i;
+    uint16_t len;
+    uint16_t log_len;
+    const uint8_t *table;
+    
+    /* start init table test */
+    ssd1306_interface_debug_print("ssd1306: start init table test.\n");
+    
+    /* init both panels */
+    for (i = 0; i < 2; i++)
+    {
+        ssd1306_emulator_test_link(&gs_handle[i], &gs_emulator[i]);
+        if ((ssd1306_set_interface(&gs_handle[i], interface) != 0) || (ssd1306_init(&gs_handle[i]) != 0))
+        {
+            ssd1306_interface_debug_print("ssd1306: init failed.\n");
+            (void)ssd1306_deinit(&gs_handle[0]);
+            
+            return 1;
+        }
+    }
+    (void)ssd1306_basic_get_init_table(&table, &len);
+    
+    /* the table leaves a lit panel cleared */
+    ssd1306_interface_debug_print("ssd1306: load the default init table.\n");
+    res = ssd1306_gram_fill_rect(&gs_handle[0], 0, 0, 127, 63, 1);
+    if ((res != 0) || (ssd1306_gram_update(&gs_handle[0]) != 0))
+    {
+        ssd1306_interface_debug_print("ssd1306: gram update failed.\n");
+        
+        return a_table_test_deinit();
+    }
+    ssd1306_emulator_test_clear(&gs_emulator[0]);
+    res = ssd1306_load_init_table(&gs_handle[0], table, len);
+    if (res != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: load init table failed.\n");
+        
+        return a_table_test_deinit();
+    }
+    log_len = gs_emulator[0].log_len;
+    if ((log_len < len) || (memcmp(&gs_emulator[0].log[log_len - len], table, len) != 0))
+    {
+        ssd1306_interface_debug_print("ssd1306: table was not sent.\n");
+        
+        return a_table_test_deinit();
+    }
+    if ((gs_handle[0].gram[0][0] != 0) || (gs_emulator[0].ram[7][127] != 0) ||
+        (ssd1306_emulator_test_compare(&gs_emulator[0], gs_handle[0].gram) != 0))
+    {
+        ssd1306_interface_debug_print("ssd1306: panel was not cleared.\n");
+        
+        return a_table_test_deinit();
+    }
+    ssd1306_interface_debug_print("ssd1306: table sent %d command bytes in %d transactions.\n", len, gs_emulator[0].transactions);
+    
+    /* the setters send the same commands */
+    ssd1306_interface_debug_print("ssd1306: run the matching setters.\n");
+    ssd1306_emulator_test_clear(&gs_emulator[1]);
+    if (a_table_test_setters() != 0)
+    {
+        ssd1306_interface_debug_print("ssd1306: setter failed.\n");
+        
+        return a_table_test_deinit();
+    }
+    if ((gs_emulator[1].log_len != len) || (memcmp(gs_emulator[1].log, table, len) != 0))
+    {
+        ssd1306_interface_debug_print("ssd1306: table and setters differ.\n");
+        
+        return a_table_test_deinit();
+    }
+    if ((gs_emulator[0].mode != gs_emulator[1].mode) ||
+        (gs_emulator[0].column_start != gs_emulator[1].column_start) || (gs_emulator[0].column_end != gs_emulator[1].column_end) ||
+        (gs_emulator[0].page_start != gs_emulator[1].page_start) || (gs_emulator[0].page_end != gs_emulator[1].page_end))
+    {
+        ssd1306_interface_debug_print("ssd1306: table and setters leave a different state.\n");
+        
+        return a_table_test_deinit();
+    }
+    ssd1306_interface_debug_print("ssd1306: setters sent %d command bytes in %d transactions.\n", len, gs_emulator[1].transactions);
+    
+    /* finish init table test */
+    ssd1306_interface_debug_print("ssd1306: finish init table test.\n");
+    (void)a_table_test_deinit();
+    
+    return 0;
+}